@@ -6,9 +6,14 @@
 
 #include "BitMatrixIO.h"
 
+#include <algorithm>
 #include <array>
+#include <charconv>
 #include <fstream>
-#include <sstream>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace ZXing {
 
@@ -51,24 +56,87 @@ std::string ToString(const BitMatrix& matrix, bool inverted)
 std::string ToSVG(const BitMatrix& matrix)
 {
 	// see https://stackoverflow.com/questions/10789059/create-qr-code-in-vector-image/60638350#60638350
+	// but instead of one square per module, each maximal horizontal run of set modules is merged with identical runs
+	// in the rows below into one rectangle. The rectangles are written with relative moveto commands.
+
+	constexpr std::string_view header = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+										"<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\" viewBox=\"0 0 ";
+	constexpr std::string_view footer = "\"/>\n</svg>";
+	constexpr int maxRectLength = 6 + 5 * 11; // "mx,yhwvhh-wz" with 6 literal characters and 5 numbers of at most 11 characters each
 
 	const int width = matrix.width();
 	const int height = matrix.height();
-	std::ostringstream out;
-
-	out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
-		<< "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\" viewBox=\"0 0 " << width << " " << height
-		<< "\" stroke=\"none\">\n"
-		<< "<path d=\"";
-
-	for (int y = 0; y < height; ++y)
-		for (int x = 0; x < width; ++x)
-			if (matrix.get(x, y))
-				out << "M" << x << "," << y << "h1v1h-1z";
+	std::vector<bool> covered(width * height); // start of runs that are part of a rectangle already written
+
+	// write into a preallocated buffer that is only grown (and checked) once per rectangle
+	std::string out(header.size() + 100 + 4 * width * height / 3, '\0');
+	char* p = out.data();
+	auto reserve = [&](int n) {
+		if (out.data() + out.size() - p < n) {
+			auto pos = p - out.data();
+			out.resize(2 * out.size() + n);
+			p = out.data() + pos;
+		}
+	};
+	auto append = [&p](auto val) {
+		if constexpr (std::is_same_v<decltype(val), char>)
+			*p++ = val;
+		else if constexpr (std::is_same_v<decltype(val), std::string_view>)
+			p = std::copy(val.begin(), val.end(), p);
+		else
+			p = std::to_chars(p, p + 11, val).ptr;
+	};
+	auto isRun = [&](int y, int x0, int x1) {
+		auto row = matrix.row(y).begin();
+		return !(x0 > 0 && row[x0 - 1]) && !(x1 < width && row[x1]) && std::all_of(row + x0, row + x1, [](auto v) { return v; });
+	};
+
+	append(header);
+	append(width);
+	append(' ');
+	append(height);
+	append(std::string_view("\" stroke=\"none\">\n<path d=\""));
+
+	char moveTo = 'M'; // first one is absolute, the others relative to the previous one
+	int px = 0, py = 0;
+	for (int y = 0; y < height; ++y) {
+		auto row = matrix.row(y).begin();
+		for (int x0 = 0; x0 < width;) {
+			if (!row[x0]) {
+				++x0;
+				continue;
+			}
+			int x1 = x0 + 1;
+			while (x1 < width && row[x1])
+				++x1;
+			if (!covered[y * width + x0]) {
+				int y1 = y + 1;
+				while (y1 < height && isRun(y1, x0, x1))
+					covered[y1++ * width + x0] = true;
+
+				reserve(maxRectLength);
+				append(std::exchange(moveTo, 'm'));
+				append(x0 - px);
+				append(',');
+				append(y - py);
+				append('h');
+				append(x1 - x0);
+				append('v');
+				append(y1 - y);
+				append('h');
+				append(x0 - x1);
+				append('z');
+				px = x0, py = y;
+			}
+			x0 = x1;
+		}
+	}
 
-	out << "\"/>\n</svg>";
+	reserve(Size(footer));
+	append(footer);
+	out.resize(p - out.data());
 
-	return out.str();
+	return out;
 }
 
 BitMatrix ParseBitMatrix(const std::string& str, char one, bool expectSpace)
@@ -9,6 +9,7 @@
 #include "ByteArray.h"
 #include "ZXAlgorithms.h"
 
+#include <algorithm>
 #include <stdexcept>
 
 namespace ZXing {
@@ -74,4 +75,22 @@ int BitSource::peakBits(int numBits) const
 	return ReadBitsImpl(numBits, _bytes, available(), byteOffset, bitOffset);
 }
 
+void BitSource::readBytes(int count, ByteArray& res)
+{
+	int n = std::clamp(count, 0, available() / 8);
+	size_t pos = res.size();
+	res.resize(pos + n);
+	if (_bitOffset == 0) {
+		std::copy_n(_bytes.begin() + _byteOffset, n, res.begin() + pos);
+	} else {
+		// n < available() / 8 + 1 guarantees that _bytes[_byteOffset + n] is a valid index
+		for (int i = 0; i < n; ++i)
+			res[pos + i] = narrow_cast<uint8_t>((_bytes[_byteOffset + i] << _bitOffset | _bytes[_byteOffset + i + 1] >> (8 - _bitOffset)) & 0xFF);
+	}
+	_byteOffset += n;
+
+	if (n < count)
+		throw std::out_of_range("BitSource::readBytes: out of range");
+}
+
 } // ZXing
@@ -63,6 +63,12 @@ public:
 	*/
 	int peakBits(int numBits) const;
 
+	/**
+	* Append count whole bytes to res, i.e. the same as count calls to readBits(8) but without the per bit overhead.
+	* If less than count bytes are available, the available ones are appended before std::out_of_range is thrown.
+	*/
+	void readBytes(int count, ByteArray& res);
+
 	/**
 	* @return number of bits that can be read successfully
 	*/
@@ -133,12 +133,12 @@ std::string Content::render(bool withECI) const
 					res += c;
 			}
 		} else {
-			res += BytesToUtf8(bytes.asView(begin, end - begin), inEci);
+			AppendUtf8(res, bytes.asView(begin, end - begin), inEci);
 		}
 	});
 
 	return res;
-#elif defined(ZXING_EXPERIMENTAL_API) && defined(ZXING_USE_ZINT)
+#elif defined(ZXING_EXPERIMENTAL_API) && (defined(ZXING_USE_ZINT) || defined(ZXING_USE_BUILTIN_WRITERS))
 	assert(!utf8Cache.empty());
 	if (!withECI)
 		return std::accumulate(utf8Cache.begin(), utf8Cache.end(), std::string());
@@ -184,7 +184,7 @@ std::string Content::text(TextMode mode) const
 	case TextMode::ECI: return render(true);
 	case TextMode::HRI:
 		switch (type()) {
-#if defined(ZXING_READERS) || (defined(ZXING_EXPERIMENTAL_API) && defined(ZXING_USE_ZINT))
+#if defined(ZXING_READERS) || (defined(ZXING_EXPERIMENTAL_API) && (defined(ZXING_USE_ZINT) || defined(ZXING_USE_BUILTIN_WRITERS)))
 		case ContentType::GS1: {
 			auto plain = render(false);
 			auto hri = HRIFromGS1(plain);
@@ -236,7 +236,7 @@ ByteArray Content::bytesECI() const
 	return res;
 }
 
-#if defined(ZXING_READERS) || (defined(ZXING_EXPERIMENTAL_API) && defined(ZXING_USE_ZINT))
+#if defined(ZXING_READERS) || (defined(ZXING_EXPERIMENTAL_API) && (defined(ZXING_USE_ZINT) || defined(ZXING_USE_BUILTIN_WRITERS)))
 /**
 * @param bytes bytes encoding a string, whose encoding should be guessed
 * @return name of guessed encoding; at the moment will only guess one of:
@@ -269,11 +269,31 @@ CharacterSet GuessTextEncoding(ByteView bytes, CharacterSet fallback = Character
 
 	bool utf8bom = bytes.size() > 3 && bytes[0] == 0xEF && bytes[1] == 0xBB && bytes[2] == 0xBF;
 
-	for (int value : bytes)
+	for (int i = 0; i < Size(bytes); ++i)
 	{
 		if(!(canBeISO88591 || canBeShiftJIS || canBeUTF8))
 			break;
 
+		// Outside of multi-byte sequences, ASCII characters only matter for the Shift_JIS plausibility, so process
+		// runs of them in bulk.
+		if (bytes[i] < 0x80 && utf8BytesLeft == 0 && sjisBytesLeft == 0) {
+			if (int n = AsciiPrefixLength(bytes.subview(i))) {
+				if (canBeShiftJIS) {
+					// use non-printable ASCII as indication for binary content (see below)
+					int nonPrintable = 0;
+					for (int j = i; j < i + n; ++j)
+						nonPrintable |= bytes[j] < 0x20 && bytes[j] != 0xa && bytes[j] != 0xd;
+					canBeShiftJIS = !nonPrintable;
+				}
+				sjisCurKatakanaWordLength = 0;
+				sjisCurDoubleBytesWordLength = 0;
+				i += n - 1;
+				continue;
+			}
+		}
+
+		int value = bytes[i];
+
 		// UTF-8 stuff
 		if (canBeUTF8) {
 			if (utf8BytesLeft > 0) {
@@ -415,7 +435,7 @@ CharacterSet GuessTextEncoding(ByteView bytes, CharacterSet fallback = Character
 
 CharacterSet Content::guessEncoding() const
 {
-#if defined(ZXING_READERS) || (defined(ZXING_EXPERIMENTAL_API) && defined(ZXING_USE_ZINT))
+#if defined(ZXING_READERS) || (defined(ZXING_EXPERIMENTAL_API) && (defined(ZXING_USE_ZINT) || defined(ZXING_USE_BUILTIN_WRITERS)))
 	// assemble all blocks with unknown encoding
 	ByteArray input;
 	ForEachECIBlock([&](ECI eci, int begin, int end) {
@@ -8,6 +8,7 @@
 #include "ByteArray.h"
 #include "CharacterSet.h"
 #include "ReaderOptions.h"
+#include "Version.h" // the members depend on ZXING_READERS
 #include "ZXAlgorithms.h"
 
 #include <string>
@@ -52,7 +53,7 @@ public:
 
 	ByteArray bytes;
 	std::vector<Encoding> encodings;
-#if !defined(ZXING_READERS) && defined(ZXING_EXPERIMENTAL_API) && defined(ZXING_USE_ZINT)
+#if !defined(ZXING_READERS) && defined(ZXING_EXPERIMENTAL_API) && (defined(ZXING_USE_ZINT) || defined(ZXING_USE_BUILTIN_WRITERS))
 	std::vector<std::string> utf8Cache;
 #endif
 	SymbologyIdentifier symbology;
@@ -65,7 +66,12 @@ public:
 	void switchEncoding(ECI eci) { switchEncoding(eci, true); }
 	void switchEncoding(CharacterSet cs);
 
-	void reserve(int count) { bytes.reserve(bytes.size() + count); }
+	// make room for count more bytes, grows geometrically so that reserving once per segment does not reallocate each time
+	void reserve(int count)
+	{
+		if (bytes.size() + count > bytes.capacity())
+			bytes.reserve(std::max(bytes.size() + count, 2 * bytes.capacity()));
+	}
 
 	void push_back(uint8_t val) { bytes.push_back(val); }
 	void push_back(int val) { bytes.push_back(narrow_cast<uint8_t>(val)); }
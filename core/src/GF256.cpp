@@ -0,0 +1,214 @@
+/*
+* Copyright 2026 ZXing authors
+*/
+// SPDX-License-Identifier: Apache-2.0
+
+#include "GF256.h"
+
+#include "GenericGF.h"
+
+#if defined(__SSSE3__) || defined(__AVX__)
+#include <tmmintrin.h>
+#define ZX_GF256_SSSE3
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define ZX_GF256_NEON
+#endif
+
+namespace ZXing {
+
+namespace {
+
+// minimal abstraction of a vector of 16 GF(256) elements
+#if defined(ZX_GF256_SSSE3)
+
+using V16 = __m128i;
+
+inline V16 Load(const uint8_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+inline void Store(uint8_t* p, V16 v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+inline V16 Broadcast(uint8_t c) { return _mm_set1_epi8(static_cast<char>(c)); }
+inline V16 Xor(V16 a, V16 b) { return _mm_xor_si128(a, b); }
+inline V16 Mul(V16 v, const uint8_t* lo, const uint8_t* hi)
+{
+	const auto mask = _mm_set1_epi8(0x0F);
+	return _mm_xor_si128(_mm_shuffle_epi8(Load(lo), _mm_and_si128(v, mask)),
+						 _mm_shuffle_epi8(Load(hi), _mm_and_si128(_mm_srli_epi64(v, 4), mask)));
+}
+inline unsigned ZeroMask(V16 v) { return _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128())); }
+
+#elif defined(ZX_GF256_NEON)
+
+using V16 = uint8x16_t;
+
+inline V16 Load(const uint8_t* p) { return vld1q_u8(p); }
+inline void Store(uint8_t* p, V16 v) { vst1q_u8(p, v); }
+inline V16 Broadcast(uint8_t c) { return vdupq_n_u8(c); }
+inline V16 Xor(V16 a, V16 b) { return veorq_u8(a, b); }
+inline V16 Mul(V16 v, const uint8_t* lo, const uint8_t* hi)
+{
+	return veorq_u8(vqtbl1q_u8(vld1q_u8(lo), vandq_u8(v, vdupq_n_u8(0x0F))), vqtbl1q_u8(vld1q_u8(hi), vshrq_n_u8(v, 4)));
+}
+inline unsigned ZeroMask(V16 v)
+{
+	uint8_t lanes[16];
+	vst1q_u8(lanes, vceqzq_u8(v));
+	unsigned res = 0;
+	for (int i = 0; i < 16; ++i)
+		res |= (lanes[i] & 1u) << i;
+	return res;
+}
+
+#else
+
+struct V16
+{
+	uint8_t v[16];
+};
+
+inline V16 Load(const uint8_t* p)
+{
+	V16 res;
+	for (int i = 0; i < 16; ++i)
+		res.v[i] = p[i];
+	return res;
+}
+inline void Store(uint8_t* p, const V16& a)
+{
+	for (int i = 0; i < 16; ++i)
+		p[i] = a.v[i];
+}
+inline V16 Broadcast(uint8_t c)
+{
+	V16 res;
+	for (auto& v : res.v)
+		v = c;
+	return res;
+}
+inline V16 Xor(V16 a, const V16& b)
+{
+	for (int i = 0; i < 16; ++i)
+		a.v[i] ^= b.v[i];
+	return a;
+}
+inline V16 Mul(V16 a, const uint8_t* lo, const uint8_t* hi)
+{
+	for (auto& v : a.v)
+		v = lo[v & 0x0F] ^ hi[v >> 4];
+	return a;
+}
+inline unsigned ZeroMask(const V16& a)
+{
+	unsigned res = 0;
+	for (int i = 0; i < 16; ++i)
+		res |= unsigned(a.v[i] == 0) << i;
+	return res;
+}
+
+#endif
+
+} // namespace
+
+GF256::GF256(int primitive)
+{
+	int x = 1;
+	for (int i = 0; i < 255; ++i) {
+		_exp[i] = _exp[i + 255] = x;
+		_log[x] = i;
+		x <<= 1; // we're assuming the generator alpha is 2
+		if (x & 0x100)
+			x ^= primitive;
+	}
+	_exp[510] = _exp[0];
+	_exp[511] = _exp[1];
+	_log[0] = 0; // should never be used
+
+	for (int c = 0; c < 256; ++c)
+		for (int n = 0; n < 16; ++n) {
+			_mulLo[c][n] = multiply(c, n);
+			_mulHi[c][n] = multiply(c, n << 4);
+		}
+}
+
+const GF256* GF256::Of(const GenericGF& field)
+{
+	static const GF256 qrCode(0x011D);     // x^8 + x^4 + x^3 + x^2 + 1
+	static const GF256 dataMatrix(0x012D); // x^8 + x^5 + x^3 + x^2 + 1
+
+	if (field.size() != 256)
+		return nullptr;
+
+	// a^8 reveals the lower 8 bits of the primitive polynomial
+	switch (field.exp(8)) {
+	case 0x1D: return &qrCode;
+	case 0x2D: return &dataMatrix;
+	default: return nullptr;
+	}
+}
+
+uint8_t GF256::evaluateAt(const uint8_t* poly, int n, uint8_t x) const noexcept
+{
+	// the leading n % 16 coefficients are processed with the scalar Horner's method
+	int head = n % 16;
+	uint8_t res = 0;
+	for (int i = 0; i < head; ++i)
+		res = multiply(res, x) ^ poly[i];
+	if (head == n)
+		return res;
+
+	// Split the remaining coefficients into 16 interleaved lanes and run Horner's method with x^16 on all lanes in
+	// parallel: p(x) = sum_l x^(15-l) * sum_m p[16m + l] * (x^16)^(M-1-m)
+	uint8_t x16 = x ? exp((16 * log(x)) % 255) : 0;
+	auto lo = mulLo(x16), hi = mulHi(x16);
+
+	V16 acc = Broadcast(0);
+	for (int i = head; i < n; i += 16)
+		acc = Xor(Mul(acc, lo, hi), Load(poly + i));
+
+	uint8_t lanes[16];
+	Store(lanes, acc);
+	uint8_t tail = 0;
+	for (uint8_t l : lanes)
+		tail = multiply(tail, x) ^ l;
+
+	uint8_t xn = x ? exp((log(x) * (n - head)) % 255) : 0; // x^(n - head)
+	return multiply(res, xn) ^ tail;
+}
+
+int GF256::findRoots(const uint8_t* poly, int degree, int n, uint8_t* roots) const noexcept
+{
+	auto expNeg = [this](int e) { return exp((255 - e % 255) % 255); }; // a^-e
+
+	// terms[t] holds poly[t] * a^(-t*k) for the 16 consecutive k of the current block. Advancing to the next
+	// block multiplies all lanes of terms[t] by the same constant a^(-16t).
+	V16 terms[256];
+	uint8_t lanes[16];
+	for (int t = 1; t <= degree; ++t) {
+		for (int l = 0; l < 16; ++l)
+			lanes[l] = multiply(poly[t], expNeg(t * l));
+		terms[t] = Load(lanes);
+	}
+
+	int numRoots = 0;
+	for (int k = 0; k < n; k += 16) {
+		V16 sum = Broadcast(poly[0]);
+		for (int t = 1; t <= degree; ++t)
+			sum = Xor(sum, terms[t]);
+
+		unsigned zeros = ZeroMask(sum);
+		for (int l = 0; zeros && l < 16 && k + l < n; ++l)
+			if (zeros & (1u << l)) {
+				if (numRoots == degree)
+					return degree + 1;
+				roots[numRoots++] = k + l;
+			}
+
+		for (int t = 1; t <= degree; ++t) {
+			uint8_t step = expNeg(16 * t);
+			terms[t] = Mul(terms[t], mulLo(step), mulHi(step));
+		}
+	}
+
+	return numRoots;
+}
+
+} // namespace ZXing
@@ -0,0 +1,60 @@
+/*
+* Copyright 2026 ZXing authors
+*/
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace ZXing {
+
+class GenericGF;
+
+/**
+ * Table driven arithmetic in GF(256) for the Reed-Solomon decoder fast path (QRCode, DataMatrix, 8-bit Aztec).
+ *
+ * Besides log/exp tables this provides split-nibble product tables: for every constant c
+ *   c * x == mulLo(c)[x & 0xF] ^ mulHi(c)[x >> 4]
+ * This allows to multiply 16 field elements by the same constant with two byte shuffles (PSHUFB on SSSE3, TBL on
+ * AArch64). The bulk operations below fall back to the same tables in plain C++ if no such instructions are available.
+ */
+class GF256
+{
+	std::array<uint8_t, 512> _exp;
+	std::array<uint8_t, 256> _log;
+	std::array<std::array<uint8_t, 16>, 256> _mulLo;
+	std::array<std::array<uint8_t, 16>, 256> _mulHi;
+
+	explicit GF256(int primitive);
+
+public:
+	/**
+	 * @return the GF(256) matching the given field or nullptr if field is not a GF(256)
+	 */
+	static const GF256* Of(const GenericGF& field);
+
+	uint8_t exp(int a) const noexcept { return _exp[a]; } // a in [0, 510]
+	int log(uint8_t a) const noexcept { return _log[a]; }
+	uint8_t inverse(uint8_t a) const noexcept { return _exp[255 - _log[a]]; }
+	uint8_t multiply(uint8_t a, uint8_t b) const noexcept { return a && b ? _exp[_log[a] + _log[b]] : 0; }
+
+	const uint8_t* mulLo(uint8_t c) const noexcept { return _mulLo[c].data(); }
+	const uint8_t* mulHi(uint8_t c) const noexcept { return _mulHi[c].data(); }
+
+	/**
+	 * @brief evaluate the polynomial with coefficients poly[0..n) (highest power first) at x.
+	 */
+	uint8_t evaluateAt(const uint8_t* poly, int n, uint8_t x) const noexcept;
+
+	/**
+	 * @brief Chien search for the roots of poly (lowest power first) among a^-k for k in [0, n).
+	 *
+	 * @param roots receives every k with poly(a^-k) == 0, has to hold at least degree elements
+	 * @return number of roots found (stops after degree + 1)
+	 */
+	int findRoots(const uint8_t* poly, int degree, int n, uint8_t* roots) const noexcept;
+};
+
+} // namespace ZXing
@@ -9,7 +9,9 @@
 
 #include "ZXAlgorithms.h"
 
+#include <array>
 #include <cmath>
+#include <cstdint>
 #include <cstring>
 #include <string_view>
 
@@ -33,7 +35,7 @@ struct AiInfo
 };
 
 // https://github.com/gs1/gs1-syntax-dictionary 2024-06-10
-static const AiInfo aiInfos[] = {
+static constexpr AiInfo aiInfos[] = {
 //TWO_DIGIT_DATA_LENGTH
 	{ "00", 18 },
 	{ "01", 14 },
@@ -256,27 +258,79 @@ static const AiInfo aiInfos[] = {
 	{ "8200", -70 },
 };
 
-std::string HRIFromGS1(std::string_view gs1)
+// Index of the aiInfos entries by the first 3 digits of their prefix. A 2-digit prefix like "01" is listed in all 10
+// buckets "010".."019". The list of bucket b is entries[start[b]..start[b+1]), it contains at most a handful of items.
+static constexpr int AiIndexSize()
+{
+	int n = 0;
+	for (const auto& i : aiInfos)
+		n += i.aiPrefix[2] ? 1 : 10;
+	return n;
+}
+
+static_assert(Size(aiInfos) <= 256, "AiIndex::entries stores the aiInfos indices as uint8_t");
+
+struct AiIndex
+{
+	std::array<uint16_t, 1001> start = {};
+	std::array<uint8_t, AiIndexSize()> entries = {};
+};
+
+static constexpr AiIndex BuildAiIndex()
+{
+	AiIndex index;
+	int n = 0;
+	for (int b = 0; b < 1000; ++b) {
+		index.start[b] = n;
+		const char digits[3] = {char('0' + b / 100), char('0' + b / 10 % 10), char('0' + b % 10)};
+		for (int i = 0; i < Size(aiInfos); ++i) {
+			const char* pre = aiInfos[i].aiPrefix;
+			if (pre[0] == digits[0] && pre[1] == digits[1] && (!pre[2] || pre[2] == digits[2]))
+				index.entries[n++] = i;
+		}
+	}
+	index.start[1000] = n;
+	return index;
+}
+
+static constexpr AiIndex aiIndex = BuildAiIndex();
+
+static const AiInfo* FindAiInfo(std::string_view rem)
+{
+	auto isDigit = [](char c) { return '0' <= c && c <= '9'; };
+	if (rem.size() < 2 || !isDigit(rem[0]) || !isDigit(rem[1]))
+		return nullptr;
+
+	// if the 3rd character is not a digit, only a 2-digit AI can match, which is listed in every bucket of its range
+	int b = (rem[0] - '0') * 100 + (rem[1] - '0') * 10 + (rem.size() > 2 && isDigit(rem[2]) ? rem[2] - '0' : 0);
+	for (int k = aiIndex.start[b]; k < aiIndex.start[b + 1]; ++k) {
+		const AiInfo& i = aiInfos[aiIndex.entries[k]];
+		std::string_view pre = i.aiPrefix;
+		if (rem.substr(0, pre.size()) == pre)
+			return &i;
+	}
+	return nullptr;
+}
+
+// Splits the GS1 element string gs1 into AI/value pairs and calls func(ai, value) for each of them.
+// Returns false if gs1 is not a valid element string.
+template <typename FUNC>
+static bool ForEachGS1Element(std::string_view gs1, FUNC&& func)
 {
-	//TODO: c++20
-	auto starts_with = [](std::string_view str, std::string_view pre) { return str.substr(0, pre.size()) == pre; };
 	constexpr char GS = 29; // GS character (29 / 0x1D)
 
 	std::string_view rem = gs1;
-	std::string res;
 
 	while (rem.size()) {
-		const AiInfo* i = FindIf(aiInfos, [&](const AiInfo& i) { return starts_with(rem, i.aiPrefix); });
-		if (i == std::end(aiInfos))
-			return {};
+		const AiInfo* i = FindAiInfo(rem);
+		if (!i)
+			return false;
 
 		int aiSize = i->aiSize();
 		if (Size(rem) < aiSize)
-			return {};
+			return false;
 
-		res += '(';
-		res += rem.substr(0, aiSize);
-		res += ')';
+		auto ai = rem.substr(0, aiSize);
 		rem.remove_prefix(aiSize);
 
 		int fieldSize = i->fieldSize();
@@ -290,9 +344,9 @@ std::string HRIFromGS1(std::string_view gs1)
 #endif
 		}
 		if (fieldSize == 0 || Size(rem) < fieldSize)
-			return {};
+			return false;
 
-		res += rem.substr(0, fieldSize);
+		func(ai, rem.substr(0, fieldSize));
 		rem.remove_prefix(fieldSize);
 
 		// See General Specification v22.0 Section 7.8.6.3: "...the processing routine SHALL tolerate a single separator character
@@ -301,6 +355,31 @@ std::string HRIFromGS1(std::string_view gs1)
 			rem.remove_prefix(1);
 	}
 
+	return true;
+}
+
+std::string HRIFromGS1(std::string_view gs1)
+{
+	std::string res;
+	res.reserve(gs1.size() + 8);
+
+	bool valid = ForEachGS1Element(gs1, [&res](std::string_view ai, std::string_view value) {
+		res += '(';
+		res += ai;
+		res += ')';
+		res += value;
+	});
+
+	return valid ? res : std::string();
+}
+
+std::vector<GS1Element> ParseGS1(std::string_view gs1)
+{
+	std::vector<GS1Element> res;
+
+	if (!ForEachGS1Element(gs1, [&res](std::string_view ai, std::string_view value) { res.push_back({ai, value}); }))
+		res.clear();
+
 	return res;
 }
 
@@ -7,10 +7,21 @@
 
 #include <string>
 #include <string_view>
+#include <vector>
 
 namespace ZXing {
 
+struct GS1Element
+{
+	std::string_view ai;
+	std::string_view value;
+};
+
 std::string HRIFromGS1(std::string_view gs1);
+
+/// Splits a GS1 element string into its AI/value pairs (views into gs1), returns an empty list if gs1 is invalid.
+std::vector<GS1Element> ParseGS1(std::string_view gs1);
+
 std::string HRIFromISO15434(std::string_view str);
 
 } // namespace ZXing
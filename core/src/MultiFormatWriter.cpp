@@ -76,7 +76,7 @@ MultiFormatWriter::encode(const std::wstring& contents, int width, int height) c
 	case BarcodeFormat::Aztec: return exec1(Aztec::Writer(), AztecEccLevel);
 #endif
 #ifdef ZXING_WITH_DATAMATRIX
-	case BarcodeFormat::DataMatrix: return exec2(DataMatrix::Writer());
+	case BarcodeFormat::DataMatrix: return exec2(DataMatrix::Writer().setMinimalEncoding(_minimalEncoding));
 #endif
 #ifdef ZXING_WITH_PDF417
 	case BarcodeFormat::PDF417: return exec1(Pdf417::Writer(), Pdf417EccLevel);
@@ -41,6 +41,14 @@ public:
 		return *this;
 	}
 
+	/**
+	* Used for DataMatrix only, see DataMatrix::Writer::setMinimalEncoding().
+	*/
+	MultiFormatWriter& setMinimalEncoding(bool minimal) {
+		_minimalEncoding = minimal;
+		return *this;
+	}
+
 	/**
 	* Used for all formats, sets the minimum number of quiet zone pixels.
 	*/
@@ -57,6 +65,7 @@ private:
 	CharacterSet _encoding = CharacterSet::Unknown;
 	int _margin = -1;
 	int _eccLevel = -1;
+	bool _minimalEncoding = false;
 };
 
 } // ZXing
@@ -17,28 +17,44 @@
 #include "ThresholdBinarizer.h"
 #endif
 
+#include <algorithm>
+#include <atomic>
 #include <climits>
+#include <exception>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
+#include <thread>
 
 namespace ZXing {
 
 #ifdef ZXING_READERS
 
-class LumImage : public Image
+// A Lum image buffer that can be reused for consecutive images without reallocating, as long as they don't grow.
+class LumBuffer
 {
+	std::unique_ptr<uint8_t[]> _memory;
+	size_t _size = 0;
+
 public:
-	using Image::Image;
+	ImageView view(int width, int height)
+	{
+		if (auto size = static_cast<size_t>(width) * height; size > _size) {
+			_memory = std::make_unique<uint8_t[]>(size);
+			_size = size;
+		}
+		return {_memory.get(), width, height, ImageFormat::Lum};
+	}
 
-	uint8_t* data() { return const_cast<uint8_t*>(Image::data()); }
+	uint8_t* data() { return _memory.get(); }
 };
 
 template<typename P>
-static LumImage ExtractLum(const ImageView& iv, P projection)
+static ImageView ExtractLum(const ImageView& iv, LumBuffer& buffer, P projection)
 {
-	LumImage res(iv.width(), iv.height());
+	auto res = buffer.view(iv.width(), iv.height());
 
-	auto* dst = res.data();
+	auto* dst = buffer.data();
 	for(int y = 0; y < iv.height(); ++y)
 		for(int x = 0, w = iv.width(); x < w; ++x)
 			*dst++ = projection(iv.data(x, y));
@@ -48,16 +64,18 @@ static LumImage ExtractLum(const ImageView& iv, P projection)
 
 class LumImagePyramid
 {
-	std::vector<LumImage> buffers;
+	std::vector<LumBuffer> buffers;
 
 	template<int N>
 	void addLayer()
 	{
 		auto siv = layers.back();
-		buffers.emplace_back(siv.width() / N, siv.height() / N);
-		layers.push_back(buffers.back());
-		auto& div = buffers.back();
-		auto* d   = div.data();
+		if (buffers.size() < layers.size())
+			buffers.emplace_back();
+		auto& buffer = buffers[layers.size() - 1];
+		auto div = buffer.view(siv.width() / N, siv.height() / N);
+		layers.push_back(div);
+		auto* d = buffer.data();
 
 		for (int dy = 0; dy < div.height(); ++dy)
 			for (int dx = 0; dx < div.width(); ++dx) {
@@ -83,11 +101,12 @@ class LumImagePyramid
 public:
 	std::vector<ImageView> layers;
 
-	LumImagePyramid(const ImageView& iv, int threshold, int factor)
+	void build(const ImageView& iv, int threshold, int factor)
 	{
 		if (factor < 2)
 			throw std::invalid_argument("Invalid ReaderOptions::downscaleFactor");
 
+		layers.clear();
 		layers.push_back(iv);
 		// TODO: if only matrix codes were considered, then using std::min would be sufficient (see #425)
 		while (threshold > 0 && std::max(layers.back().width(), layers.back().height()) > threshold &&
@@ -102,7 +121,7 @@ public:
 	}
 };
 
-ImageView SetupLumImageView(ImageView iv, LumImage& lum, const ReaderOptions& opts)
+ImageView SetupLumImageView(ImageView iv, LumBuffer& lum, const ReaderOptions& opts)
 {
 	if (iv.format() == ImageFormat::None)
 		throw std::invalid_argument("Invalid image format");
@@ -110,20 +129,18 @@ ImageView SetupLumImageView(ImageView iv, LumImage& lum, const ReaderOptions& op
 	if (opts.binarizer() == Binarizer::GlobalHistogram || opts.binarizer() == Binarizer::LocalAverage) {
 		// manually spell out the 3 most common pixel formats to get at least gcc to vectorize the code
 		if (iv.format() == ImageFormat::RGB && iv.pixStride() == 3) {
-			lum = ExtractLum(iv, [](const uint8_t* src) { return RGBToLum(src[0], src[1], src[2]); });
+			return ExtractLum(iv, lum, [](const uint8_t* src) { return RGBToLum(src[0], src[1], src[2]); });
 		} else if (iv.format() == ImageFormat::RGBA && iv.pixStride() == 4) {
-			lum = ExtractLum(iv, [](const uint8_t* src) { return RGBToLum(src[0], src[1], src[2]); });
+			return ExtractLum(iv, lum, [](const uint8_t* src) { return RGBToLum(src[0], src[1], src[2]); });
 		} else if (iv.format() == ImageFormat::BGR && iv.pixStride() == 3) {
-			lum = ExtractLum(iv, [](const uint8_t* src) { return RGBToLum(src[2], src[1], src[0]); });
+			return ExtractLum(iv, lum, [](const uint8_t* src) { return RGBToLum(src[2], src[1], src[0]); });
 		} else if (iv.format() != ImageFormat::Lum) {
-			lum = ExtractLum(iv, [r = RedIndex(iv.format()), g = GreenIndex(iv.format()), b = BlueIndex(iv.format())](
-									 const uint8_t* src) { return RGBToLum(src[r], src[g], src[b]); });
+			return ExtractLum(iv, lum, [r = RedIndex(iv.format()), g = GreenIndex(iv.format()), b = BlueIndex(iv.format())](
+										   const uint8_t* src) { return RGBToLum(src[r], src[g], src[b]); });
 		} else if (iv.pixStride() != 1) {
 			// GlobalHistogram and LocalAverage need dense line memory layout
-			lum = ExtractLum(iv, [](const uint8_t* src) { return *src; });
+			return ExtractLum(iv, lum, [](const uint8_t* src) { return *src; });
 		}
-		if (lum.data())
-			return lum;
 	}
 	return iv;
 }
@@ -139,40 +156,63 @@ std::unique_ptr<BinaryBitmap> CreateBitmap(ZXing::Binarizer binarizer, const Ima
 	return {}; // silence gcc warning
 }
 
-Barcode ReadBarcode(const ImageView& _iv, const ReaderOptions& opts)
+/**
+ * Everything needed to read an image apart from the image itself: the reader objects and the intermediate image
+ * buffers. Reusing a ReadContext for a sequence of images read with the same options saves setting up the readers and
+ * (re)allocating the buffers for every single one of them.
+ */
+class ReadContext
 {
-	return FirstOrDefault(ReadBarcodes(_iv, ReaderOptions(opts).setMaxNumberOfSymbols(1)));
-}
+	const ReaderOptions _opts;
+	MultiFormatReader _reader;
+#ifdef ZXING_EXPERIMENTAL_API
+	ReaderOptions _closedOpts;
+	std::unique_ptr<MultiFormatReader> _closedReader;
+#endif
+	LumBuffer _lum;
+	LumImagePyramid _pyramid;
 
-Barcodes ReadBarcodes(const ImageView& _iv, const ReaderOptions& opts)
+public:
+	explicit ReadContext(const ReaderOptions& opts) : _opts(opts), _reader(_opts)
+	{
+#ifdef ZXING_EXPERIMENTAL_API
+		auto formatsBenefittingFromClosing = BarcodeFormat::Aztec | BarcodeFormat::DataMatrix | BarcodeFormat::QRCode | BarcodeFormat::MicroQRCode;
+		if (_opts.tryDenoise() && _opts.hasFormat(formatsBenefittingFromClosing)) {
+			_closedOpts = _opts;
+			_closedOpts.setFormats((_opts.formats().empty() ? BarcodeFormat::Any : _opts.formats()) & formatsBenefittingFromClosing);
+			_closedReader = std::make_unique<MultiFormatReader>(_closedOpts);
+		}
+#endif
+	}
+
+	Barcodes read(const ImageView& _iv);
+};
+
+Barcodes ReadContext::read(const ImageView& _iv)
 {
+	const auto& opts = _opts;
+
 	if (sizeof(PatternType) < 4 && (_iv.width() > 0xffff || _iv.height() > 0xffff))
 		throw std::invalid_argument("Maximum image width/height is 65535");
 
 	if (!_iv.data() || _iv.width() * _iv.height() == 0)
 		throw std::invalid_argument("ImageView is null/empty");
 
-	LumImage lum;
-	ImageView iv = SetupLumImageView(_iv, lum, opts);
-	MultiFormatReader reader(opts);
+	ImageView iv = SetupLumImageView(_iv, _lum, opts);
 
 	if (opts.isPure())
-		return {reader.read(*CreateBitmap(opts.binarizer(), iv)).setReaderOptions(opts)};
+		return {_reader.read(*CreateBitmap(opts.binarizer(), iv)).setReaderOptions(opts)};
 
-	std::unique_ptr<MultiFormatReader> closedReader;
+	const MultiFormatReader* closedReader = nullptr;
 #ifdef ZXING_EXPERIMENTAL_API
-	auto formatsBenefittingFromClosing = BarcodeFormat::Aztec | BarcodeFormat::DataMatrix | BarcodeFormat::QRCode | BarcodeFormat::MicroQRCode;
-	ReaderOptions closedOptions = opts;
-	if (opts.tryDenoise() && opts.hasFormat(formatsBenefittingFromClosing) && _iv.height() >= 3) {
-		closedOptions.setFormats((opts.formats().empty() ? BarcodeFormat::Any : opts.formats()) & formatsBenefittingFromClosing);
-		closedReader = std::make_unique<MultiFormatReader>(closedOptions);
-	}
+	if (_iv.height() >= 3)
+		closedReader = _closedReader.get();
 #endif
-	LumImagePyramid pyramid(iv, opts.downscaleThreshold() * opts.tryDownscale(), opts.downscaleFactor());
+	_pyramid.build(iv, opts.downscaleThreshold() * opts.tryDownscale(), opts.downscaleFactor());
 
 	Barcodes res;
 	int maxSymbols = opts.maxNumberOfSymbols() ? opts.maxNumberOfSymbols() : INT_MAX;
-	for (auto&& iv : pyramid.layers) {
+	for (auto&& iv : _pyramid.layers) {
 		auto bitmap = CreateBitmap(opts.binarizer(), iv);
 		for (int close = 0; close <= (closedReader ? 1 : 0); ++close) {
 			if (close) {
@@ -186,7 +226,7 @@ Barcodes ReadBarcodes(const ImageView& _iv, const ReaderOptions& opts)
 			for (int invert = 0; invert <= static_cast<int>(opts.tryInvert() && !close); ++invert) {
 				if (invert)
 					bitmap->invert();
-				auto rs = (close ? *closedReader : reader).readMultiple(*bitmap, maxSymbols);
+				auto rs = (close ? *closedReader : _reader).readMultiple(*bitmap, maxSymbols);
 				for (auto& r : rs) {
 					if (iv.width() != _iv.width())
 						r.setPosition(Scale(r.position(), _iv.width() / iv.width()));
@@ -206,6 +246,57 @@ Barcodes ReadBarcodes(const ImageView& _iv, const ReaderOptions& opts)
 	return res;
 }
 
+Barcode ReadBarcode(const ImageView& _iv, const ReaderOptions& opts)
+{
+	return FirstOrDefault(ReadBarcodes(_iv, ReaderOptions(opts).setMaxNumberOfSymbols(1)));
+}
+
+Barcodes ReadBarcodes(const ImageView& _iv, const ReaderOptions& opts)
+{
+	return ReadContext(opts).read(_iv);
+}
+
+std::vector<Barcodes> ReadBarcodesBatch(ArrayView<ImageView> images, const ReaderOptions& opts, int numThreads)
+{
+	std::vector<Barcodes> res(images.size());
+	if (images.empty())
+		return res;
+
+	if (numThreads <= 0)
+		numThreads = std::max(1, narrow_cast<int>(std::thread::hardware_concurrency()));
+	numThreads = std::min(numThreads, Size(images));
+
+	std::atomic<size_t> next = 0;
+	std::exception_ptr error;
+	std::mutex errorMutex;
+
+	// each worker keeps its own ReadContext, the images are handed out one by one to balance the load
+	auto worker = [&] {
+		try {
+			ReadContext context(opts);
+			for (size_t i = next++; i < images.size(); i = next++)
+				res[i] = context.read(images[i]);
+		} catch (...) {
+			std::lock_guard<std::mutex> lock(errorMutex);
+			if (!error)
+				error = std::current_exception();
+			next = images.size(); // stop the other workers
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (int i = 1; i < numThreads; ++i)
+		threads.emplace_back(worker);
+	worker();
+	for (auto& thread : threads)
+		thread.join();
+
+	if (error)
+		std::rethrow_exception(error);
+
+	return res;
+}
+
 #else // ZXING_READERS
 
 Barcode ReadBarcode(const ImageView&, const ReaderOptions&)
@@ -218,6 +309,11 @@ Barcodes ReadBarcodes(const ImageView&, const ReaderOptions&)
 	throw std::runtime_error("This build of zxing-cpp does not support reading barcodes.");
 }
 
+std::vector<Barcodes> ReadBarcodesBatch(ArrayView<ImageView>, const ReaderOptions&, int)
+{
+	throw std::runtime_error("This build of zxing-cpp does not support reading barcodes.");
+}
+
 #endif // ZXING_READERS
 
 } // ZXing
@@ -8,6 +8,9 @@
 #include "ReaderOptions.h"
 #include "ImageView.h"
 #include "Barcode.h"
+#include "Range.h"
+
+#include <vector>
 
 namespace ZXing {
 
@@ -29,5 +32,19 @@ Barcode ReadBarcode(const ImageView& image, const ReaderOptions& options = {});
  */
 Barcodes ReadBarcodes(const ImageView& image, const ReaderOptions& options = {});
 
+/**
+ * Read barcodes from a list of ImageViews
+ *
+ * This is equivalent to calling ReadBarcodes for each image but faster for large numbers of (small) images: the
+ * images are distributed over a number of worker threads, each of which sets up its readers and intermediate buffers
+ * only once and reuses them for all of its images.
+ *
+ * @param images  list of views of the image data
+ * @param options  optional ReaderOptions to parameterize / speed up detection, used for all images
+ * @param numThreads  number of threads to use, 0 means std::thread::hardware_concurrency()
+ * @return list of #Barcodes, one for each image in the same order as the input
+ */
+std::vector<Barcodes> ReadBarcodesBatch(ArrayView<ImageView> images, const ReaderOptions& options = {}, int numThreads = 0);
+
 } // ZXing
 
@@ -7,19 +7,26 @@
 
 #include "ReedSolomonDecoder.h"
 
+#include "ByteArray.h"
+#include "GF256.h"
 #include "GenericGF.h"
 #include "ZXConfig.h"
+#include "ZXTestSupport.h"
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <stdexcept>
 #include <utility>
 
 namespace ZXing {
 
 static bool
-RunEuclideanAlgorithm(const GenericGF& field, std::vector<int>&& rCoefs, GenericGFPoly& sigma, GenericGFPoly& omega)
+RunEuclideanAlgorithm(const GenericGF& field, std::vector<int>&& rCoefs, const GenericGFPoly& erasureLocator, GenericGFPoly& sigma,
+					  GenericGFPoly& omega)
 {
 	int R = Size(rCoefs); // == numECCodeWords
+	int E = erasureLocator.degree(); // == number of erasures
 	GenericGFPoly r(field, std::move(rCoefs));
 	GenericGFPoly& tLast = omega.setField(field);
 	GenericGFPoly& t = sigma.setField(field);
@@ -30,14 +37,21 @@ RunEuclideanAlgorithm(const GenericGF& field, std::vector<int>&& rCoefs, Generic
 
 	rLast.setMonomial(1, R);
 	tLast.setMonomial(0);
-	t.setMonomial(1);
+	t = erasureLocator;
+
+	// With known erasure locations, solve the key equation for the modified syndromes S(x) * Gamma(x) mod x^R and
+	// start with t = Gamma(x), so that t ends up being the combined errata (errors and erasures) locator.
+	if (E > 0) {
+		r.multiply(erasureLocator);
+		r.divide(rLast, q);
+	}
 
 	// Assume r's degree is < rLast's
 	if (r.degree() >= rLast.degree())
 		swap(r, rLast);
 
-	// Run Euclidean algorithm until r's degree is less than R/2
-	while (r.degree() >= R / 2) {
+	// Run Euclidean algorithm until r's degree is less than (R+E)/2
+	while (r.degree() >= (R + E) / 2) {
 		swap(tLast, t);
 		swap(rLast, r);
 
@@ -102,22 +116,40 @@ FindErrorMagnitudes(const GenericGF& field, const GenericGFPoly& errorEvaluator,
 	return res;
 }
 
-bool
-ReedSolomonDecode(const GenericGF& field, std::vector<int>& message, int numECCodeWords)
+ZXING_EXPORT_TEST_ONLY
+bool ReedSolomonDecodeEuclidean(const GenericGF& field, std::vector<int>& message, int numECCodeWords, const std::vector<int>& erasures)
 {
-	GenericGFPoly poly(field, message);
+	int msgLen = Size(message);
+	if (Size(erasures) > numECCodeWords)
+		return false;
 
-	std::vector<int> syndromes(numECCodeWords);
-	for (int i = 0; i < numECCodeWords; i++)
-		syndromes[numECCodeWords - 1 - i] = poly.evaluateAt(field.exp(i + field.generatorBase()));
+	auto syndrome = [&](int i) {
+		int x = field.exp(i + field.generatorBase());
+		return Reduce(message, 0, [&](int s, int c) { return field.multiply(s, x) ^ c; });
+	};
 
-	// if all syndromes are 0 there is no error to correct
-	if (std::all_of(syndromes.begin(), syndromes.end(), [](int c) { return c == 0; }))
+	// if all syndromes are 0 there is no error to correct (checked without setting up any polynomials)
+	int firstNonZero = 0;
+	while (firstNonZero < numECCodeWords && syndrome(firstNonZero) == 0)
+		++firstNonZero;
+	if (firstNonZero == numECCodeWords)
 		return true;
 
-	ZX_THREAD_LOCAL GenericGFPoly sigma, omega;
+	std::vector<int> syndromes(numECCodeWords);
+	for (int i = firstNonZero; i < numECCodeWords; i++)
+		syndromes[numECCodeWords - 1 - i] = syndrome(i);
+
+	ZX_THREAD_LOCAL GenericGFPoly sigma, omega, erasureLocator;
 
-	if (!RunEuclideanAlgorithm(field, std::move(syndromes), sigma, omega))
+	// Gamma(x) = product of (1 + X_j * x) with X_j = a^(msgLen - 1 - position_j) for every erasure j
+	erasureLocator.setField(field).setMonomial(1);
+	for (int position : erasures) {
+		if (position < 0 || position >= msgLen || msgLen - 1 - position >= field.size() - 1)
+			return false;
+		erasureLocator.multiply(GenericGFPoly(field, {field.exp(msgLen - 1 - position), 1}));
+	}
+
+	if (!RunEuclideanAlgorithm(field, std::move(syndromes), erasureLocator, sigma, omega))
 		return false;
 
 	auto errorLocations = FindErrorLocations(field, sigma);
@@ -126,7 +158,6 @@ ReedSolomonDecode(const GenericGF& field, std::vector<int>& message, int numECCo
 
 	auto errorMagnitudes = FindErrorMagnitudes(field, omega, errorLocations);
 
-	int msgLen = Size(message);
 	for (int i = 0; i < Size(errorLocations); ++i) {
 		int position = msgLen - 1 - field.log(errorLocations[i]);
 		if (position < 0)
@@ -137,13 +168,162 @@ ReedSolomonDecode(const GenericGF& field, std::vector<int>& message, int numECCo
 
 #if 1
 	// re-evaluate the syndromes of the recovered message to make sure it is a valid (see #940)
-	poly = GenericGFPoly(field, message);
-
 	for (int i = 0; i < numECCodeWords; i++)
-		if (poly.evaluateAt(field.exp(i + field.generatorBase())) != 0)
+		if (syndrome(i) != 0)
+			return false;
+#endif
+
+	return true;
+}
+
+/**
+ * Reed-Solomon decoder for GF(256) based on the Berlekamp-Massey algorithm, working in-place on a byte array and with
+ * all temporary polynomials on the stack. The syndrome computation and Chien search process 16 codewords at a time
+ * (see GF256). Clean messages are verified by the syndrome computation alone.
+ *
+ * All polynomials below are stored lowest power first, except the message, which has the highest power first.
+ */
+static bool ReedSolomonDecode(const GF256& gf, int generatorBase, uint8_t* msg, int n, int numECCodeWords,
+							  const std::vector<int>& erasures)
+{
+	const int R = numECCodeWords;
+	const int E = Size(erasures);
+	if (n > 255 || R > n || E > R)
+		return false;
+
+	auto computeSyndromes = [&](uint8_t* syndromes) {
+		bool allZero = true;
+		for (int i = 0; i < R; ++i)
+			allZero &= (syndromes[i] = gf.evaluateAt(msg, n, gf.exp(i + generatorBase))) == 0;
+		return allZero;
+	};
+
+	std::array<uint8_t, 256> S;
+	if (computeSyndromes(S.data()))
+		return true;
+
+	// erasure locator Gamma(x) = product of (1 + X_j * x) with X_j = a^(n - 1 - position_j)
+	std::array<uint8_t, 257> lambda = {1}, B, T;
+	for (int j = 0; j < E; ++j) {
+		if (erasures[j] < 0 || erasures[j] >= n)
+			return false;
+		uint8_t X = gf.exp(n - 1 - erasures[j]);
+		for (int i = j + 1; i > 0; --i)
+			lambda[i] ^= gf.multiply(lambda[i - 1], X);
+	}
+	B = lambda;
+
+	// Berlekamp-Massey with erasures (see Blahut, "Algebraic Codes for Data Transmission", ch. 7): lambda ends up
+	// as the errata (errors and erasures) locator of degree L
+	int L = E;
+	for (int r = E; r < R; ++r) {
+		uint8_t delta = 0;
+		for (int i = 0; i <= std::min(L, r); ++i)
+			delta ^= gf.multiply(lambda[i], S[r - i]);
+
+		// B = x * B
+		std::copy_backward(B.begin(), B.end() - 1, B.end());
+		B[0] = 0;
+
+		if (delta == 0)
+			continue;
+
+		T = lambda;
+		for (int i = 0; i <= R; ++i)
+			lambda[i] ^= gf.multiply(delta, B[i]);
+
+		if (2 * L <= r + E) {
+			L = r + 1 + E - L;
+			uint8_t deltaInv = gf.inverse(delta);
+			for (int i = 0; i <= R; ++i)
+				B[i] = gf.multiply(T[i], deltaInv);
+		}
+	}
+
+	// more errata than the EC capacity allows (2 * errors + erasures > R) can not be corrected reliably
+	if (2 * L - E > R || std::any_of(lambda.begin() + L + 1, lambda.begin() + R + 1, [](uint8_t c) { return c != 0; }))
+		return false;
+
+	std::array<uint8_t, 256> errorPowers;
+	if (gf.findRoots(lambda.data(), L, n, errorPowers.data()) != L)
+		return false; // Error locator degree does not match number of roots, most likely there are more errors than can be recovered
+
+	// error evaluator Omega(x) = S(x) * Lambda(x) mod x^R
+	std::array<uint8_t, 256> omega = {};
+	for (int k = 0; k < R; ++k)
+		for (int i = 0; i <= std::min(k, L); ++i)
+			omega[k] ^= gf.multiply(lambda[i], S[k - i]);
+
+	auto evaluate = [&gf](const uint8_t* poly, int degree, int step, uint8_t x) {
+		uint8_t res = 0;
+		for (int i = degree - (degree % step); i >= 0; i -= step)
+			res = gf.multiply(res, x) ^ poly[i];
+		return res;
+	};
+
+	// Forney's formula: e_k = X_k^(1-b) * Omega(X_k^-1) / Lambda'(X_k^-1)
+	std::array<uint8_t, 256> magnitudes;
+	for (int j = 0; j < L; ++j) {
+		int k = errorPowers[j];
+		uint8_t xInv = gf.exp((255 - k) % 255);
+		// the formal derivative in GF(2^m) only contains the odd powers: Lambda'(x) = lambda_1 + lambda_3 x^2 + ...
+		uint8_t denom = evaluate(lambda.data() + 1, L - 1, 2, gf.multiply(xInv, xInv));
+		if (denom == 0)
 			return false;
+		magnitudes[j] = gf.multiply(evaluate(omega.data(), R - 1, 1, xInv), gf.inverse(denom));
+		if (generatorBase == 0)
+			magnitudes[j] = gf.multiply(magnitudes[j], gf.exp(k));
+	}
+
+	auto applyCorrections = [&] {
+		for (int j = 0; j < L; ++j)
+			msg[n - 1 - errorPowers[j]] ^= magnitudes[j];
+	};
+	applyCorrections();
+
+	// re-evaluate the syndromes of the recovered message to make sure it is a valid (see #940)
+	if (!computeSyndromes(S.data())) {
+		applyCorrections(); // leave the message untouched on failure
+		return false;
+	}
+
+	return true;
+}
+
+ZXING_EXPORT_TEST_ONLY
+bool ReedSolomonDecodeBerlekampMassey(const GF256& gf, int generatorBase, std::vector<int>& message, int numECCodeWords,
+									  const std::vector<int>& erasures)
+{
+	if (Size(message) > 255)
+		return false;
+
+	std::array<uint8_t, 255> msg;
+	std::copy(message.begin(), message.end(), msg.begin());
+	if (!ReedSolomonDecode(gf, generatorBase, msg.data(), Size(message), numECCodeWords, erasures))
+		return false;
+	std::copy_n(msg.begin(), message.size(), message.begin());
+	return true;
+}
+
+bool ReedSolomonDecode(const GenericGF& field, std::vector<int>& message, int numECCodeWords, const std::vector<int>& erasures)
+{
+#ifdef ZX_REED_SOLOMON_GF256_FAST_PATH
+	if (auto gf256 = GF256::Of(field); gf256 && Size(message) <= 255)
+		return ReedSolomonDecodeBerlekampMassey(*gf256, field.generatorBase(), message, numECCodeWords, erasures);
 #endif
+	return ReedSolomonDecodeEuclidean(field, message, numECCodeWords, erasures);
+}
 
+bool ReedSolomonDecode(const GenericGF& field, ByteArray& message, int numECCodeWords, const std::vector<int>& erasures)
+{
+#ifdef ZX_REED_SOLOMON_GF256_FAST_PATH
+	if (auto gf256 = GF256::Of(field); gf256 && Size(message) <= 255)
+		return ReedSolomonDecode(*gf256, field.generatorBase(), message.data(), Size(message), numECCodeWords, erasures);
+#endif
+	std::vector<int> ints(message.begin(), message.end());
+	if (!ReedSolomonDecodeEuclidean(field, ints, numECCodeWords, erasures))
+		return false;
+	std::copy(ints.begin(), ints.end(), message.begin());
 	return true;
 }
 
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include "ByteArray.h"
+
 #include <vector>
 
 namespace ZXing {
@@ -38,10 +40,24 @@ class GenericGF;
 /**
  * @brief ReedSolomonDecode fixes errors in a message containing both data and parity codewords.
  *
+ * Known erasures (codewords that could not be sampled reliably) can be passed in to be corrected together with
+ * unknown errors. Each erasure costs one error-correction codeword instead of two, i.e. decoding succeeds as long as
+ * 2 * numErrors + numErasures <= numECCodeWords.
+ *
  * @param message data and error-correction/parity codewords
  * @param numECCodeWords number of error-correction code words
+ * @param erasures indices into message of codewords with unknown value
  * @return true iff message errors could successfully be fixed (or there have not been any)
  */
-bool ReedSolomonDecode(const GenericGF& field, std::vector<int>& message, int numECCodeWords);
+bool ReedSolomonDecode(const GenericGF& field, std::vector<int>& message, int numECCodeWords,
+					   const std::vector<int>& erasures = {});
+
+/**
+ * @brief ReedSolomonDecode in-place variant for fields with at most 256 elements (QRCode, DataMatrix, Aztec 8-bit).
+ *
+ * Messages without errors are verified by a syndrome check alone. The message is only modified if errors could
+ * successfully be fixed.
+ */
+bool ReedSolomonDecode(const GenericGF& field, ByteArray& message, int numECCodeWords, const std::vector<int>& erasures = {});
 
 } // ZXing
@@ -7,15 +7,47 @@
 
 #include "TextDecoder.h"
 
+#include "Utf.h"
 #include "ZXAlgorithms.h"
 #include "libzueci/zueci.h"
 
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <stdexcept>
 
 namespace ZXing {
 
-std::string BytesToUtf8(ByteView bytes, ECI eci)
+int Utf8PrefixLength(ByteView bytes)
+{
+	int i = 0;
+	const int size = Size(bytes);
+	while (true) {
+		i += AsciiPrefixLength(bytes.subview(i));
+		if (i == size)
+			return i;
+
+		// validate a single multi-byte sequence, see table 3-7 'Well-Formed UTF-8 Byte Sequences' of the Unicode standard
+		int c = bytes[i], n = 0, lo = 0x80, hi = 0xBF;
+		if (c >= 0xC2 && c <= 0xDF)
+			n = 1;
+		else if (c >= 0xE0 && c <= 0xEF)
+			n = 2, lo = c == 0xE0 ? 0xA0 : lo, hi = c == 0xED ? 0x9F : hi;
+		else if (c >= 0xF0 && c <= 0xF4)
+			n = 3, lo = c == 0xF0 ? 0x90 : lo, hi = c == 0xF4 ? 0x8F : hi;
+		else
+			return i;
+
+		if (i + n >= size || bytes[i + 1] < lo || bytes[i + 1] > hi)
+			return i;
+		for (int j = 2; j <= n; ++j)
+			if ((bytes[i + j] & 0xC0) != 0x80)
+				return i;
+		i += n + 1;
+	}
+}
+
+void AppendUtf8(std::string& utf8, ByteView bytes, ECI eci)
 {
 	constexpr unsigned int replacement = 0xFFFD;
 	constexpr unsigned int flags = ZUECI_FLAG_SB_STRAIGHT_THRU | ZUECI_FLAG_SJIS_STRAIGHT_THRU;
@@ -24,19 +56,36 @@ std::string BytesToUtf8(ByteView bytes, ECI eci)
 	if (eci == ECI::Unknown)
 		eci = ECI::Binary;
 
+	// Apart from UTF-16/32, all supported encodings map ASCII to itself (see the zueci flags above) and valid UTF-8 maps
+	// to itself anyway. That means the (typically very common) leading ASCII or UTF-8 part can simply be copied.
+	bool isAsciiCompatible = !(eci == ECI::UTF16BE || eci == ECI::UTF16LE || eci == ECI::UTF32BE || eci == ECI::UTF32LE);
+	if (isAsciiCompatible) {
+		int n = eci == ECI::UTF8 ? Utf8PrefixLength(bytes) : AsciiPrefixLength(bytes);
+		utf8.append(reinterpret_cast<const char*>(bytes.data()), n);
+		bytes = bytes.subview(n);
+		if (bytes.empty())
+			return;
+	}
+
 	int error_number = zueci_dest_len_utf8(ToInt(eci), bytes.data(), bytes.size(), replacement, flags, &utf8_len);
 	if (error_number >= ZUECI_ERROR)
 		throw std::runtime_error("zueci_dest_len_utf8 failed");
 
-	std::string utf8(utf8_len, 0);
+	auto offset = utf8.size();
+	utf8.resize(offset + utf8_len);
 
 	error_number = zueci_eci_to_utf8(ToInt(eci), bytes.data(), bytes.size(), replacement, flags,
-									 reinterpret_cast<uint8_t*>(utf8.data()), &utf8_len);
+									 reinterpret_cast<uint8_t*>(utf8.data() + offset), &utf8_len);
 	if (error_number >= ZUECI_ERROR)
 		throw std::runtime_error("zueci_eci_to_utf8 failed");
 
-	assert(Size(utf8) == utf8_len);
+	assert(Size(utf8) == narrow_cast<int>(offset) + utf8_len);
+}
 
+std::string BytesToUtf8(ByteView bytes, ECI eci)
+{
+	std::string utf8;
+	AppendUtf8(utf8, bytes, eci);
 	return utf8;
 }
 
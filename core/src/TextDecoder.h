@@ -13,6 +13,12 @@
 
 namespace ZXing {
 
+/// Length of the longest prefix of `bytes` that is valid UTF-8 (without overlong forms, surrogates or truncated sequences).
+int Utf8PrefixLength(ByteView bytes);
+
+/// Transcode `bytes` encoded in `eci` to UTF-8 and append them to `utf8`.
+void AppendUtf8(std::string& utf8, ByteView bytes, ECI eci);
+
 std::string BytesToUtf8(ByteView bytes, ECI eci);
 
 inline std::string BytesToUtf8(ByteView bytes, CharacterSet cs)
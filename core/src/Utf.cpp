@@ -12,6 +12,7 @@
 
 #include <iomanip>
 #include <cstdint>
+#include <cstring>
 #include <sstream>
 
 #if __cplusplus <= 201703L
@@ -269,4 +270,20 @@ std::string EscapeNonGraphical(std::string_view utf8)
 	return ToUtf8(EscapeNonGraphical(FromUtf8(utf8)));
 }
 
+int AsciiPrefixLength(ByteView bytes)
+{
+	size_t i = 0;
+	// check 16 bytes per iteration, the memcpy calls compile into plain (unaligned) loads
+	for (; i + 16 <= bytes.size(); i += 16) {
+		uint64_t a, b;
+		std::memcpy(&a, bytes.data() + i, 8);
+		std::memcpy(&b, bytes.data() + i + 8, 8);
+		if ((a | b) & 0x8080808080808080ull)
+			break;
+	}
+	while (i < bytes.size() && bytes[i] < 0x80)
+		++i;
+	return narrow_cast<int>(i);
+}
+
 } // namespace ZXing
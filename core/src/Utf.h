@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include "Range.h"
+
 #include <string>
 #include <string_view>
 
@@ -19,4 +21,7 @@ std::wstring FromUtf8(std::u8string_view utf8);
 std::wstring EscapeNonGraphical(std::wstring_view str);
 std::string EscapeNonGraphical(std::string_view utf8);
 
+/// Length of the longest prefix of `bytes` that consists of ASCII (0x00-0x7F) characters only.
+int AsciiPrefixLength(ByteView bytes);
+
 } // namespace ZXing
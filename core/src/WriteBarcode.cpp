@@ -8,19 +8,29 @@
 
 #include "WriteBarcode.h"
 #include "BitMatrix.h"
+#include "BitMatrixIO.h"
 #include "JSON.h"
 
 #if !defined(ZXING_READERS) && !defined(ZXING_WRITERS)
 #include "Version.h"
 #endif
 
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <mutex>
 #include <sstream>
+#include <thread>
+#include <utility>
 
-#ifdef ZXING_USE_ZINT
-
+#if defined(ZXING_USE_ZINT) || defined(ZXING_USE_BUILTIN_WRITERS)
 #include "DecoderResult.h"
 #include "DetectorResult.h"
 #include "TextEncoder.h"
+#endif
+
+#ifdef ZXING_USE_ZINT
+
 #include <zint.h>
 
 #else
@@ -70,6 +80,8 @@ ZX_RO_PROPERTY(bool, stacked);
 ZX_RO_PROPERTY(bool, forceSquare);
 ZX_RO_PROPERTY(int, version);
 ZX_RO_PROPERTY(int, dataMask);
+ZX_RO_PROPERTY(bool, minimalEncoding);
+ZX_RO_PROPERTY(bool, builtinWriter);
 
 #undef ZX_RO_PROPERTY
 
@@ -85,6 +97,7 @@ struct WriterOptions::Data
 	int rotate = 0;
 	bool withHRT = false;
 	bool withQuietZones = true;
+	ImageFormat imageFormat = ImageFormat::Lum;
 };
 
 #define ZX_PROPERTY(TYPE, NAME) \
@@ -97,6 +110,7 @@ ZX_PROPERTY(int, sizeHint)
 ZX_PROPERTY(int, rotate)
 ZX_PROPERTY(bool, withHRT)
 ZX_PROPERTY(bool, withQuietZones)
+ZX_PROPERTY(ImageFormat, imageFormat)
 
 #undef ZX_PROPERTY
 
@@ -110,37 +124,103 @@ static std::string ToSVG(ImageView iv)
 	if (!iv.data())
 		return {};
 
-	// see https://stackoverflow.com/questions/10789059/create-qr-code-in-vector-image/60638350#60638350
-
-	std::ostringstream res;
-
-	res << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
-		<< "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\" viewBox=\"0 0 " << iv.width() << " " << iv.height()
-		<< "\" stroke=\"none\">\n"
-		<< "<path d=\"";
-
+	BitMatrix bits(iv.width(), iv.height());
 	for (int y = 0; y < iv.height(); ++y)
 		for (int x = 0; x < iv.width(); ++x)
 			if (*iv.data(x, y) == 0)
-				res << "M" << x << "," << y << "h1v1h-1z";
+				bits.set(x, y);
 
-	res << "\"/>\n</svg>";
+	return ZXing::ToSVG(bits);
+}
 
-	return res.str();
+// packedBits selects the 1 bit per pixel output of WriteBarcodeToBitmap, format is ignored then
+static int RowBytes(ImageFormat format, bool packedBits, int width)
+{
+	return packedBits ? (width + 7) / 8 : width * PixStride(format);
 }
 
-static Image ToImage(BitMatrix bits, bool isLinearCode, const WriterOptions& opts)
+// black or white pixel in the given format, an eventual alpha channel is opaque
+static std::array<uint8_t, 4> Pixel(ImageFormat format, uint8_t lum)
 {
-	bits.flipAll();
-	auto symbol = Inflate(std::move(bits), opts.sizeHint(),
-						  isLinearCode ? std::clamp(opts.sizeHint() / 2, 50, 300) : opts.sizeHint(),
-						  opts.withQuietZones() ? 10 : 0);
-	auto bitmap = ToMatrix<uint8_t>(symbol);
-	auto iv = Image(symbol.width(), symbol.height());
-	std::memcpy(const_cast<uint8_t*>(iv.data()), bitmap.data(), iv.width() * iv.height());
-	return iv;
+	std::array<uint8_t, 4> res = {0xff, 0xff, 0xff, 0xff};
+	res[RedIndex(format)] = res[GreenIndex(format)] = res[BlueIndex(format)] = lum;
+	return res;
 }
 
+static void SetBits(uint8_t* row, int from, int count)
+{
+	for (int end = from + count; from < end;) {
+		if (from % 8 == 0 && end - from >= 8) {
+			int n = (end - from) / 8;
+			std::memset(row + from / 8, 0xff, n);
+			from += 8 * n;
+		} else {
+			row[from / 8] |= 0x80 >> (from % 8);
+			++from;
+		}
+	}
+}
+
+// Renders the symbol of the built-in writers (black modules are 0) the same way as Inflate() does, but directly into
+// the destination format: each module row is drawn once as runs of black pixels and then copied scale - 1 times.
+struct SymbolRenderer
+{
+	ImageView symbol;
+	int width, height, scale, left, top;
+
+	SymbolRenderer(ImageView symbol, bool isLinearCode, const WriterOptions& opts) : symbol(symbol)
+	{
+		int quietZone = opts.withQuietZones() ? 10 : 0;
+		width = std::max(opts.sizeHint(), symbol.width() + 2 * quietZone);
+		height = std::max(isLinearCode ? std::clamp(opts.sizeHint() / 2, 50, 300) : opts.sizeHint(),
+						  symbol.height() + 2 * quietZone);
+		scale = std::min((width - 2 * quietZone) / symbol.width(), (height - 2 * quietZone) / symbol.height());
+		left = (width - symbol.width() * scale) / 2;
+		top = (height - symbol.height() * scale) / 2;
+	}
+
+	void render(ImageFormat format, bool packedBits, uint8_t* dst, int rowStride) const
+	{
+		const int rowBytes = RowBytes(format, packedBits, width);
+		const uint8_t background = packedBits ? 0 : 0xff;
+		const auto black = Pixel(format, 0);
+		const int pixStride = packedBits ? 0 : PixStride(format);
+
+		auto fillRun = [&](uint8_t* row, int from, int count) {
+			if (packedBits)
+				SetBits(row, from, count);
+			else if (pixStride == 1)
+				std::memset(row + from, black[0], count);
+			else
+				for (auto* p = row + from * pixStride, *end = p + count * pixStride; p != end; p += pixStride)
+					std::memcpy(p, black.data(), pixStride);
+		};
+
+		for (int y = 0; y < top; ++y)
+			std::memset(dst + y * rowStride, background, rowBytes);
+
+		for (int sy = 0; sy < symbol.height(); ++sy) {
+			auto* row = dst + (top + sy * scale) * rowStride;
+			std::memset(row, background, rowBytes);
+			for (int sx = 0; sx < symbol.width();) {
+				if (*symbol.data(sx, sy)) {
+					++sx;
+					continue;
+				}
+				int start = sx;
+				while (sx < symbol.width() && !*symbol.data(sx, sy))
+					++sx;
+				fillRun(row, left + start * scale, (sx - start) * scale);
+			}
+			for (int i = 1; i < scale; ++i)
+				std::memcpy(row + i * rowStride, row, rowBytes);
+		}
+
+		for (int y = top + symbol.height() * scale; y < height; ++y)
+			std::memset(dst + y * rowStride, background, rowBytes);
+	}
+};
+
 } // namespace ZXing
 
 
@@ -268,10 +348,8 @@ static constexpr struct { BarcodeFormat format; SymbologyIdentifier si; } barcod
 	{BarcodeFormat::UPCE, {'E', '0'}},
 };
 
-static SymbologyIdentifier SymbologyIdentifierZint2ZXing(const CreatorOptions& opts, const ByteArray& ba)
+static SymbologyIdentifier SymbologyIdentifierZint2ZXing(BarcodeFormat format, bool gs1, const ByteArray& ba)
 {
-	const BarcodeFormat format = opts.format();
-
 	auto i = FindIf(barcodeFormat2SymbologyIdentifier, [format](auto& v) { return v.format == format; });
 	assert(i != std::end(barcodeFormat2SymbologyIdentifier));
 	SymbologyIdentifier ret = i->si;
@@ -282,7 +360,7 @@ static SymbologyIdentifier SymbologyIdentifierZint2ZXing(const CreatorOptions& o
 	} else if (format == BarcodeFormat::Code39) {
 		if (FindIf(ba, iscntrl) != ba.end()) // Extended Code 39?
 			ret.modifier = static_cast<char>(ret.modifier + 4);
-	} else if (opts.gs1() && SupportsGS1(format)) {
+	} else if (gs1) {
 		if ((BarcodeFormat::Aztec | BarcodeFormat::Code128).testFlag(format))
 			ret.modifier = '1';
 		else if (format == BarcodeFormat::DataMatrix)
@@ -365,45 +443,50 @@ static std::string BinaryToUtf8(ByteView ba)
 }
 #endif
 
-zint_symbol* CreatorOptions::zint() const
+static unique_zint_symbol CreateZintSymbol(const CreatorOptions& opts)
 {
-	auto& zint = d->zint;
-
-	if (!zint) {
 #ifdef PRINT_DEBUG
-//		printf("zint version: %d, sizeof(zint_symbol): %ld, options: %s\n", ZBarcode_Version(), sizeof(zint_symbol), options().c_str());
+//	printf("zint version: %d, sizeof(zint_symbol): %ld, options: %s\n", ZBarcode_Version(), sizeof(zint_symbol), opts.options().c_str());
 #endif
-		zint.reset(ZBarcode_Create());
+	unique_zint_symbol zint(ZBarcode_Create());
+	const BarcodeFormat format = opts.format();
 
-		auto i = FindIf(barcodeFormatZXing2Zint, [zxing = format()](auto& v) { return v.zxing == zxing; });
-		if (i == std::end(barcodeFormatZXing2Zint))
-			throw std::invalid_argument("unsupported barcode format: " + ToString(format()));
+	auto i = FindIf(barcodeFormatZXing2Zint, [format](auto& v) { return v.zxing == format; });
+	if (i == std::end(barcodeFormatZXing2Zint))
+		throw std::invalid_argument("unsupported barcode format: " + ToString(format));
 
-		if (format() == BarcodeFormat::Code128 && gs1())
-			zint->symbology = BARCODE_GS1_128;
-		else if (format() == BarcodeFormat::DataBar && stacked())
-			zint->symbology = BARCODE_DBAR_OMNSTK;
-		else if (format() == BarcodeFormat::DataBarExpanded && stacked())
-			zint->symbology = BARCODE_DBAR_EXPSTK;
-		else
-			zint->symbology = i->zint;
+	if (format == BarcodeFormat::Code128 && opts.gs1())
+		zint->symbology = BARCODE_GS1_128;
+	else if (format == BarcodeFormat::DataBar && opts.stacked())
+		zint->symbology = BARCODE_DBAR_OMNSTK;
+	else if (format == BarcodeFormat::DataBarExpanded && opts.stacked())
+		zint->symbology = BARCODE_DBAR_EXPSTK;
+	else
+		zint->symbology = i->zint;
 
-		zint->scale = 0.5f;
+	zint->scale = 0.5f;
 
-		if (!ecLevel().empty())
-			zint->option_1 = ParseECLevel(zint->symbology, ecLevel());
+	if (!opts.ecLevel().empty())
+		zint->option_1 = ParseECLevel(zint->symbology, opts.ecLevel());
 
-		if (auto val = version(); val && !IsLinearBarcode(format()))
-			zint->option_2 = *val;
+	if (auto val = opts.version(); val && !IsLinearBarcode(format))
+		zint->option_2 = *val;
 
-		if (auto val = dataMask(); val && (BarcodeFormat::QRCode | BarcodeFormat::MicroQRCode).testFlag(format()))
-			zint->option_3 = (zint->option_3 & 0xFF) | (*val + 1) << 8;
+	if (auto val = opts.dataMask(); val && (BarcodeFormat::QRCode | BarcodeFormat::MicroQRCode).testFlag(format))
+		zint->option_3 = (zint->option_3 & 0xFF) | (*val + 1) << 8;
 
-		if (format() == BarcodeFormat::DataMatrix)
-			zint->option_3 = (forceSquare() ? DM_SQUARE : DM_DMRE) | DM_ISO_144;
-	}
+	if (format == BarcodeFormat::DataMatrix)
+		zint->option_3 = (opts.forceSquare() ? DM_SQUARE : DM_DMRE) | DM_ISO_144;
+
+	return zint;
+}
 
-	return zint.get();
+zint_symbol* CreatorOptions::zint() const
+{
+	if (!d->zint)
+		d->zint = CreateZintSymbol(*this);
+
+	return d->zint.get();
 }
 
 #define CHECK(ZINT_CALL) \
@@ -413,11 +496,10 @@ zint_symbol* CreatorOptions::zint() const
 	if (WARN = (ZINT_CALL); WARN >= ZINT_ERROR) \
 		throw std::invalid_argument(StrCat(zint->errtxt, " (retval: ", std::to_string(WARN), ")"));
 
-Barcode CreateBarcode(const void* data, int size, int mode, const CreatorOptions& opts)
+// Encode data with a configured zint symbol, the returned Barcode is not linked to the symbol.
+static Barcode CreateBarcode(zint_symbol* zint, const void* data, int size, int mode, BarcodeFormat format, bool gs1)
 {
-	auto zint = opts.zint();
-
-	zint->input_mode = mode == UNICODE_MODE && opts.gs1() && SupportsGS1(opts.format()) ? GS1_MODE : mode;
+	zint->input_mode = mode == UNICODE_MODE && gs1 ? GS1_MODE : mode;
 	if (mode == UNICODE_MODE && static_cast<const char*>(data)[0] != '[')
 		zint->input_mode |= GS1PARENS_MODE;
 	zint->output_options |= OUT_BUFFER_INTERMEDIATE | BARCODE_QUIET_ZONES | BARCODE_CONTENT_SEGS;
@@ -438,11 +520,11 @@ Barcode CreateBarcode(const void* data, int size, int mode, const CreatorOptions
 				   [](unsigned char v) { return (v == '0') * 0xff; });
 
 	auto res = ReadBarcode({buffer.data(), zint->bitmap_width, zint->bitmap_height, ImageFormat::Lum},
-						   ReaderOptions().setFormats(opts.format()).setIsPure(true).setBinarizer(Binarizer::BoolCast));
+						   ReaderOptions().setFormats(format).setIsPure(true).setBinarizer(Binarizer::BoolCast));
 #else
 	assert(zint->content_seg_count == 1);
 	const auto& content_seg = zint->content_segs[0];
-	const size_t content_seg_len = static_cast<size_t>(content_seg.length - (opts.format() == BarcodeFormat::Code93 && content_seg.length >= 2 ? 2 : 0));
+	const size_t content_seg_len = static_cast<size_t>(content_seg.length - (format == BarcodeFormat::Code93 && content_seg.length >= 2 ? 2 : 0));
 
 	Content content;
 
@@ -465,40 +547,65 @@ Barcode CreateBarcode(const void* data, int size, int mode, const CreatorOptions
 #endif
 	}
 
-	content.symbology = SymbologyIdentifierZint2ZXing(opts, content.bytes);
+	content.symbology = SymbologyIdentifierZint2ZXing(format, gs1, content.bytes);
 
 	DecoderResult decRes(std::move(content));
 	decRes.setEcLevel(ECLevelZint2ZXing(zint));
 	DetectorResult detRes;
 
-	auto res = Barcode(std::move(decRes), std::move(detRes), opts.format());
+	auto res = Barcode(std::move(decRes), std::move(detRes), format);
 #endif
 
 	auto bits = BitMatrix(zint->bitmap_width, zint->bitmap_height);
 	std::transform(zint->bitmap, zint->bitmap + zint->bitmap_width * zint->bitmap_height, bits.row(0).begin(),
 				   [](unsigned char v) { return (v == '1') * BitMatrix::SET_V; });
 	res.symbol(std::move(bits));
-	res.zint(std::move(opts.d->zint));
 
 	return res;
 }
 
-Barcode CreateBarcodeFromText(std::string_view contents, const CreatorOptions& opts)
+Barcode CreateBarcode(const void* data, int size, int mode, const CreatorOptions& opts)
 {
-	return CreateBarcode(contents.data(), contents.size(), UNICODE_MODE, opts);
-}
+	auto res = CreateBarcode(opts.zint(), data, size, mode, opts.format(), opts.gs1() && SupportsGS1(opts.format()));
+	res.zint(std::move(opts.d->zint));
 
-#if __cplusplus > 201703L
-Barcode CreateBarcodeFromText(std::u8string_view contents, const CreatorOptions& opts)
-{
-	return CreateBarcode(contents.data(), contents.size(), UNICODE_MODE, opts);
+	return res;
 }
-#endif
 
-Barcode CreateBarcodeFromBytes(const void* data, int size, const CreatorOptions& opts)
+// Encoder of a BarcodeFactory worker: the options are parsed once and the zint symbol is reset and reconfigured for
+// each payload instead of being created from scratch (zint writes the chosen version etc. back into the symbol).
+class ZintBatchEncoder
 {
-	return CreateBarcode(data, size, DATA_MODE, opts);
-}
+	unique_zint_symbol _zint;
+	BarcodeFormat _format;
+	bool _gs1;
+	int _symbology, _option_1, _option_2, _option_3;
+	float _scale;
+
+public:
+	explicit ZintBatchEncoder(const CreatorOptions& opts)
+		: _zint(CreateZintSymbol(opts)), _format(opts.format()), _gs1(opts.gs1() && SupportsGS1(opts.format()))
+	{
+		_symbology = _zint->symbology;
+		_option_1 = _zint->option_1;
+		_option_2 = _zint->option_2;
+		_option_3 = _zint->option_3;
+		_scale = _zint->scale;
+	}
+
+	Barcode operator()(const void* data, int size, bool isText)
+	{
+		auto zint = _zint.get();
+		ZBarcode_Reset(zint);
+		zint->symbology = _symbology;
+		zint->option_1 = _option_1;
+		zint->option_2 = _option_2;
+		zint->option_3 = _option_3;
+		zint->scale = _scale;
+
+		return CreateBarcode(zint, data, size, isText ? UNICODE_MODE : DATA_MODE, _format, _gs1);
+	}
+};
 
 // Writer ========================================================================
 
@@ -527,59 +634,348 @@ struct SetCommonWriterOptions
 
 } // ZXing
 
-#else // ZXING_USE_ZINT
+#endif // ZXING_USE_ZINT
+
+#ifdef ZXING_USE_BUILTIN_WRITERS
 
+#include "ECI.h"
 #include "MultiFormatWriter.h"
-#include "ReadBarcode.h"
+#include "Quadrilateral.h"
+#include "Utf.h"
+
+#ifdef ZXING_WITH_AZTEC
+#include "aztec/AZEncoder.h"
+#endif
+#ifdef ZXING_WITH_DATAMATRIX
+#include "datamatrix/DMVersion.h"
+#endif
+#ifdef ZXING_WITH_1D
+#include "GTIN.h"
+#include "oned/ODUPCEANCommon.h"
+#endif
+#ifdef ZXING_WITH_PDF417
+#include "pdf417/PDFEncoder.h"
+#endif
+#ifdef ZXING_WITH_QRCODE
+#include "qrcode/QREncodeResult.h"
+#include "qrcode/QREncoder.h"
+#include "qrcode/QRErrorCorrectionLevel.h"
+#endif
 
 namespace ZXing {
 
+#ifndef ZXING_USE_ZINT
 zint_symbol* CreatorOptions::zint() const { return nullptr; }
+#endif
+
+#ifndef ZXING_READERS
+// Content::text() is rendered from utf8Cache without readers, which needs one entry per encoding. The built-in
+// writers store text as UTF-8 (or ASCII) and binary data as ISO-8859-1, so this works without a text decoder.
+static void FillUtf8Cache(Content& content, bool isUtf8)
+{
+	if (content.encodings.empty() || content.encodings.front().pos != 0)
+		content.encodings.insert(content.encodings.begin(), {content.hasECI ? ECI::ISO8859_1 : ECI::Unknown, 0});
+
+	for (int i = 0; i < Size(content.encodings); ++i) {
+		int begin = content.encodings[i].pos;
+		int end = i + 1 < Size(content.encodings) ? content.encodings[i + 1].pos : Size(content.bytes);
+		auto block = content.bytes.asView(begin, end - begin);
+		content.utf8Cache.push_back(isUtf8 ? std::string(block.begin(), block.end()) : ToUtf8(std::wstring(block.begin(), block.end())));
+	}
+}
+#endif
 
-static Barcode CreateBarcode(BitMatrix&& bits, const CreatorOptions& opts)
+// DecoderResult of content from a built-in writer
+static DecoderResult ToDecoderResult(Content&& content, [[maybe_unused]] bool isUtf8)
 {
-	auto img = ToMatrix<uint8_t>(bits);
+#ifndef ZXING_READERS
+	FillUtf8Cache(content, isUtf8);
+#endif
+	return DecoderResult(std::move(content));
+}
 
-	auto res = ReadBarcode({img.data(), img.width(), img.height(), ImageFormat::Lum},
-						   ReaderOptions().setFormats(opts.format()).setIsPure(true).setBinarizer(Binarizer::BoolCast));
+#ifdef ZXING_WITH_1D
+// DecoderResult of a linear symbol the way the reader reports it, the input has been validated by the writer already.
+// Symbology identifier modifiers the reader can only guess (accidental check characters of Code 39 and ITF) are
+// reported as written, like the zint backend does.
+static DecoderResult LinearResult(BarcodeFormat format, const std::wstring& input)
+{
+	std::string text, upce;
+	SymbologyIdentifier si;
+	bool readerInit = false;
+
+	switch (format) {
+	case BarcodeFormat::Codabar:
+		// the writer maps the alternative start/stop characters TN*E to ABCD and adds 'A' if there are none
+		text = ToUtf8(input);
+		if (text.size() < 2 || !Contains("ABCDTN*E", text.front())) {
+			text = 'A' + text + 'A';
+		} else {
+			text.front() = "ABCD"[IndexOf("ABCDTN*E", text.front()) % 4];
+			text.back() = "ABCD"[IndexOf("ABCDTN*E", text.back()) % 4];
+		}
+		si = {'F', '0'};
+		break;
+	case BarcodeFormat::Code39:
+		// the writer switches to full ASCII mode if there are characters outside of the basic set
+		text = ToUtf8(input);
+		si = {'A', text.find_first_not_of("0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ-. *$/+%") == std::string::npos ? '0' : '4'};
+		break;
+	case BarcodeFormat::Code93:
+		text = ToUtf8(input);
+		si = {'G', '0'};
+		break;
+	case BarcodeFormat::Code128: {
+		// the writer takes the function characters FNC1 to FNC4 as U+00F1 to U+00F4, see Raw2TxtDecoder in ODCode128Reader.cpp
+		si = {'C', '0'};
+		auto isDigit = [](char c) { return c >= '0' && c <= '9'; };
+		auto isLetter = [](char c) { return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z'); };
+		bool fnc4All = false, fnc4Next = false;
+		for (wchar_t c : input) {
+			switch (c) {
+			case L'\u00f1': // FNC1
+				if (text.empty())
+					si = {'C', '1', 0, AIFlag::GS1};
+				else if ((text.size() == 2 && isDigit(text[0]) && isDigit(text[1])) || (text.size() == 1 && isLetter(text[0])))
+					si = {'C', '2', 0, AIFlag::AIM};
+				else
+					text.push_back(29);
+				break;
+			case L'\u00f2': break; // FNC2, message append
+			case L'\u00f3': readerInit = true; break; // FNC3
+			case L'\u00f4': // FNC4
+				if (fnc4Next)
+					fnc4All = !fnc4All;
+				fnc4Next = !fnc4Next;
+				break;
+			default:
+				text.push_back(static_cast<char>(c + (fnc4All != fnc4Next) * 128));
+				fnc4Next = false;
+			}
+		}
+		break;
+	}
+	case BarcodeFormat::EAN8:
+	case BarcodeFormat::EAN13:
+	case BarcodeFormat::UPCA:
+	case BarcodeFormat::UPCE: {
+		// the writers append the check digit if it is missing, the reader reports UPC-A/E as EAN-13
+		text = ToUtf8(input);
+		int length = format == BarcodeFormat::EAN13 ? 13 : format == BarcodeFormat::UPCA ? 12 : 8;
+		if (Size(text) == length - 1)
+			text += GTIN::ComputeCheckDigit(format == BarcodeFormat::UPCE ? OneD::UPCEANCommon::ConvertUPCEtoUPCA(text) : text);
+		if (format == BarcodeFormat::UPCE)
+			upce = std::exchange(text, "0" + OneD::UPCEANCommon::ConvertUPCEtoUPCA(text));
+		else if (format == BarcodeFormat::UPCA)
+			text.insert(0, 1, '0');
+		si = {'E', format == BarcodeFormat::EAN8 ? '4' : '0'};
+		break;
+	}
+	case BarcodeFormat::ITF:
+		text = ToUtf8(input);
+		si = {'I', '0'};
+		break;
+	default: break;
+	}
+
+	return ToDecoderResult({ByteArray(text), si}, false).setReaderInit(readerInit).addExtra(BarcodeExtra::UPCE, upce);
+}
+#endif
+
+// Create a Barcode from the symbol of a built-in writer and the DecoderResult a reader would return for it, so the
+// symbol does not need to be read back.
+static Barcode CreateBarcode(BitMatrix&& bits, DecoderResult&& decRes, BarcodeFormat format)
+{
+	Barcode res(std::move(decRes), DetectorResult({}, Rectangle<PointI>(bits.width() - 1, bits.height() - 1)), format);
 	res.symbol(std::move(bits));
 	return res;
 }
 
-Barcode CreateBarcodeFromText(std::string_view contents, const CreatorOptions& opts)
+static Barcode CreateBuiltinBarcode(const std::wstring& contents, bool isText, const CreatorOptions& opts)
 {
-	auto writer = MultiFormatWriter(opts.format()).setMargin(0);
-	if (!opts.ecLevel().empty())
-		writer.setEccLevel(std::stoi(opts.ecLevel()));
-	writer.setEncoding(CharacterSet::UTF8); // write UTF8 (ECI value 26) for maximum compatibility
+	// write UTF8 (ECI value 26) for maximum compatibility, binary data is written with ECI value 899
+	auto encoding = isText ? CharacterSet::UTF8 : CharacterSet::BINARY;
+	auto format = opts.format();
+	// the ecLevel is a number between 0 and 8, see MultiFormatWriter::setEccLevel()
+	[[maybe_unused]] int eccLevel = opts.ecLevel().empty() ? -1 : std::stoi(opts.ecLevel());
+	[[maybe_unused]] bool hasEccLevel = eccLevel >= 0 && eccLevel <= 8;
+
+	switch (format) {
+#ifdef ZXING_WITH_AZTEC
+	case BarcodeFormat::Aztec: {
+		auto bytes = TextEncoder::FromUnicode(contents, encoding);
+		auto code = Aztec::Encoder::Encode(bytes, hasEccLevel ? eccLevel * 100 / 8 : Aztec::Encoder::DEFAULT_EC_PERCENT,
+										   Aztec::Encoder::DEFAULT_AZTEC_LAYERS);
+		return CreateBarcode(std::move(code.matrix),
+							 ToDecoderResult(Content(ByteArray(bytes), {'z', '0', 3}), isText)
+								 .setEcLevel(std::to_string(code.eccPercent) + "%")
+								 .setVersionNumber(code.layers),
+							 format);
+	}
+#endif
+#ifdef ZXING_WITH_PDF417
+	case BarcodeFormat::PDF417: {
+		Pdf417::Encoder encoder;
+		encoder.setEncoding(encoding);
+		int ecLevel = hasEccLevel ? eccLevel : 2; // default of Pdf417::Writer
+		auto matrix = encoder.generateBarcodeLogic(contents, ecLevel);
+
+		// same module size (1x4) and orientation as Pdf417::Writer, getScaledMatrix() returns the rows bottom up
+		std::vector<std::vector<bool>> rows;
+		matrix.getScaledMatrix(1, 4, rows);
+		BitMatrix bits(Size(rows[0]), Size(rows));
+		for (int y = 0; y < bits.height(); ++y)
+			for (int x = 0; x < bits.width(); ++x)
+				bits.set(x, bits.height() - 1 - y, rows[y][x]);
+
+		Content content;
+		content.symbology = {'L', '2', char(-1)};
+		if (encoding != CharacterSet::ISO8859_1)
+			content.switchEncoding(ToECI(encoding));
+		content.append(TextEncoder::FromUnicode(contents, encoding));
+
+		int numECCodewords = 2 << ecLevel;
+		return CreateBarcode(std::move(bits),
+							 ToDecoderResult(std::move(content), isText)
+								 .setEcLevel(std::to_string(numECCodewords * 100 / (matrix.rows() * matrix.columns())) + "%"),
+							 format);
+	}
+#endif
+#ifdef ZXING_WITH_QRCODE
+	case BarcodeFormat::QRCode: {
+		if (contents.empty())
+			throw std::invalid_argument("Found empty contents");
+
+		auto ecLevel = hasEccLevel ? static_cast<QRCode::ErrorCorrectionLevel>((eccLevel - 1) / 2) : QRCode::ErrorCorrectionLevel::Low;
+		auto code = QRCode::Encode(contents, ecLevel, encoding, 0, false);
+		int version = code.version->versionNumber();
+		return CreateBarcode(std::move(code.matrix),
+							 ToDecoderResult(std::move(code.content), isText)
+								 .setEcLevel(QRCode::ToString(code.ecLevel))
+								 .setVersionNumber(version)
+								 .addExtra(BarcodeExtra::DataMask, narrow_cast<uint8_t>(code.maskPattern), uint8_t(255))
+								 .addExtra(BarcodeExtra::Version, std::to_string(version)),
+							 format);
+	}
+#endif
+	default: break;
+	}
 
-	return CreateBarcode(writer.encode(std::string(contents), 0, IsLinearBarcode(opts.format()) ? 50 : 0), opts);
+	// DataMatrix and the linear formats come from their writers, the metadata follows from the input and the symbol size
+	auto bits = MultiFormatWriter(format)
+					.setMargin(0)
+					.setEncoding(encoding)
+					.setMinimalEncoding(opts.minimalEncoding().value_or(false))
+					.encode(contents, 0, IsLinearBarcode(format) ? 50 : 0);
+
+#ifdef ZXING_WITH_DATAMATRIX
+	if (format == BarcodeFormat::DataMatrix) {
+		auto version = DataMatrix::VersionForDimensionsOf(bits);
+		auto content = Content(ByteArray(TextEncoder::FromUnicode(contents, encoding)),
+							   {'d', narrow_cast<char>('1' + 6 * version->isDMRE()), 3});
+		return CreateBarcode(std::move(bits),
+							 ToDecoderResult(std::move(content), isText)
+								 .setVersionNumber(version->versionNumber)
+								 .addExtra(BarcodeExtra::Version,
+										   std::to_string(version->symbolHeight) + 'x' + std::to_string(version->symbolWidth)),
+							 format);
+	}
+#endif
+#ifdef ZXING_WITH_1D
+	return CreateBarcode(std::move(bits), LinearResult(format, contents), format);
+#else
+	return {}; // unreachable, MultiFormatWriter throws for unsupported formats
+#endif
+}
+
+static Barcode CreateBuiltinBarcode(const void* data, int size, bool isText, const CreatorOptions& opts)
+{
+	if (isText)
+		return CreateBuiltinBarcode(FromUtf8({static_cast<const char*>(data), narrow_cast<size_t>(size)}), true, opts);
+
+	std::wstring bytes;
+	for (uint8_t c : ByteView(data, size))
+		bytes.push_back(c);
+
+	return CreateBuiltinBarcode(bytes, false, opts);
+}
+
+} // namespace ZXing
+
+#endif // ZXING_USE_BUILTIN_WRITERS
+
+namespace ZXing {
+
+// Select the backend: in ZXING_WRITERS=BOTH builds the built-in writers are used if requested by the options
+static bool UseBuiltinWriter([[maybe_unused]] const CreatorOptions& opts)
+{
+#if defined(ZXING_USE_ZINT) && defined(ZXING_USE_BUILTIN_WRITERS)
+	return opts.builtinWriter().value_or(false);
+#elif defined(ZXING_USE_ZINT)
+	return false;
+#else
+	return true;
+#endif
+}
+
+static Barcode Encode(const void* data, int size, bool isText, const CreatorOptions& opts)
+{
+#ifdef ZXING_USE_BUILTIN_WRITERS
+	if (UseBuiltinWriter(opts))
+		return CreateBuiltinBarcode(data, size, isText, opts);
+#endif
+#ifdef ZXING_USE_ZINT
+	return CreateBarcode(data, size, isText ? UNICODE_MODE : DATA_MODE, opts);
+#else
+	return {}; // unreachable
+#endif
+}
+
+Barcode CreateBarcodeFromText(std::string_view contents, const CreatorOptions& opts)
+{
+	return Encode(contents.data(), Size(contents), true, opts);
 }
 
 #if __cplusplus > 201703L
 Barcode CreateBarcodeFromText(std::u8string_view contents, const CreatorOptions& opts)
 {
-	return CreateBarcodeFromText({reinterpret_cast<const char*>(contents.data()), contents.size()}, opts);
+	return Encode(contents.data(), Size(contents), true, opts);
 }
 #endif
 
 Barcode CreateBarcodeFromBytes(const void* data, int size, const CreatorOptions& opts)
 {
-	std::wstring bytes;
-	for (uint8_t c : ByteView(data, size))
-		bytes.push_back(c);
+	return Encode(data, size, false, opts);
+}
 
-	auto writer = MultiFormatWriter(opts.format()).setMargin(0);
-	if (!opts.ecLevel().empty())
-		writer.setEccLevel(std::stoi(opts.ecLevel()));
-	writer.setEncoding(CharacterSet::BINARY);
+// Encoder of a BarcodeFactory worker, the built-in writers have no per symbol setup worth sharing.
+class BatchEncoder
+{
+	const CreatorOptions& _opts;
+#ifdef ZXING_USE_ZINT
+	std::optional<ZintBatchEncoder> _zint;
+#endif
 
-	return CreateBarcode(writer.encode(bytes, 0, IsLinearBarcode(opts.format()) ? 50 : 0), opts);
-}
+public:
+	explicit BatchEncoder(const CreatorOptions& opts) : _opts(opts)
+	{
+#ifdef ZXING_USE_ZINT
+		if (!UseBuiltinWriter(opts))
+			_zint.emplace(opts);
+#endif
+	}
 
-} // namespace ZXing
+	Barcode operator()(const void* data, int size, bool isText)
+	{
+#ifdef ZXING_USE_ZINT
+		if (_zint)
+			return (*_zint)(data, size, isText);
+#endif
+		return Encode(data, size, isText, _opts);
+	}
+};
 
-#endif // ZXING_USE_ZINT
+} // namespace ZXing
 
 #else // ZXING_WRITERS
 
@@ -604,12 +1000,97 @@ Barcode CreateBarcodeFromBytes(const void*, int, const CreatorOptions&)
 	throw std::runtime_error("This build of zxing-cpp does not support creating barcodes.");
 }
 
+class BatchEncoder
+{
+public:
+	explicit BatchEncoder(const CreatorOptions&)
+	{
+		throw std::runtime_error("This build of zxing-cpp does not support creating barcodes.");
+	}
+
+	Barcode operator()(const void*, int, bool) { return {}; }
+};
+
 } // namespace ZXing
 
 #endif // ZXING_WRITERS
 
 namespace ZXing {
 
+struct BarcodeFactory::Data
+{
+	CreatorOptions options;
+	int numThreads;
+
+#ifndef __cpp_aggregate_paren_init
+	Data(CreatorOptions o, int n) : options(std::move(o)), numThreads(n) {}
+#endif
+};
+
+BarcodeFactory::BarcodeFactory(CreatorOptions options, int numThreads)
+	: d(std::make_unique<Data>(std::move(options), numThreads))
+{}
+BarcodeFactory::~BarcodeFactory() = default;
+BarcodeFactory::BarcodeFactory(BarcodeFactory&&) = default;
+BarcodeFactory& BarcodeFactory::operator=(BarcodeFactory&&) = default;
+
+const CreatorOptions& BarcodeFactory::options() const noexcept
+{
+	return d->options;
+}
+
+template <typename T>
+static void CreateBarcodesBatch(ArrayView<T> contents, bool isText, const CreatorOptions& opts, int numThreads,
+								std::vector<Barcode>& results)
+{
+	results.clear();
+	results.resize(contents.size());
+	if (contents.empty())
+		return;
+
+	if (numThreads <= 0)
+		numThreads = std::max(1, narrow_cast<int>(std::thread::hardware_concurrency()));
+	numThreads = std::min(numThreads, Size(contents));
+
+	std::atomic<size_t> next = 0;
+	std::exception_ptr error;
+	std::mutex errorMutex;
+
+	// each worker keeps its own encoder, the payloads are handed out one by one to balance the load
+	auto worker = [&] {
+		try {
+			BatchEncoder encoder(opts);
+			for (size_t i = next++; i < contents.size(); i = next++)
+				results[i] = encoder(contents[i].data(), Size(contents[i]), isText);
+		} catch (...) {
+			std::lock_guard<std::mutex> lock(errorMutex);
+			if (!error)
+				error = std::current_exception();
+			next = contents.size(); // stop the other workers
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (int i = 1; i < numThreads; ++i)
+		threads.emplace_back(worker);
+	worker();
+	for (auto& thread : threads)
+		thread.join();
+
+	if (error)
+		std::rethrow_exception(error);
+}
+
+void BarcodeFactory::createFromTexts(ArrayView<std::string_view> contents, std::vector<Barcode>& results) const
+{
+	CreateBarcodesBatch(contents, true, d->options, d->numThreads, results);
+}
+
+void BarcodeFactory::createFromBytes(ArrayView<ByteView> contents, std::vector<Barcode>& results) const
+{
+	CreateBarcodesBatch(contents, false, d->options, d->numThreads, results);
+}
+
 std::string WriteBarcodeToSVG(const Barcode& barcode, [[maybe_unused]] const WriterOptions& opts)
 {
 	auto zint = barcode.zint();
@@ -631,34 +1112,120 @@ std::string WriteBarcodeToSVG(const Barcode& barcode, [[maybe_unused]] const Wri
 #endif
 }
 
-Image WriteBarcodeToImage(const Barcode& barcode, [[maybe_unused]] const WriterOptions& opts)
+#if defined(ZXING_WRITERS) && defined(ZXING_USE_ZINT)
+// luminance of the pixel values zint writes with OUT_BUFFER_INTERMEDIATE: '0'/'1' for back-/foreground or one of the
+// colour letters "WCBMRYGK"
+static const std::array<uint8_t, 256> ZintLum = [] {
+	std::array<uint8_t, 256> res;
+	res.fill(0xff);
+	res['1'] = res['K'] = 0;
+	res['C'] = RGBToLum(0, 0xff, 0xff);
+	res['B'] = RGBToLum(0, 0, 0xff);
+	res['M'] = RGBToLum(0xff, 0, 0xff);
+	res['R'] = RGBToLum(0xff, 0, 0);
+	res['Y'] = RGBToLum(0xff, 0xff, 0);
+	res['G'] = RGBToLum(0, 0xff, 0);
+	return res;
+}();
+
+static void ConvertZintBitmap(const zint_symbol* zint, ImageFormat format, bool packedBits, uint8_t* dst, int rowStride)
+{
+	const auto* src = zint->bitmap;
+	const int width = zint->bitmap_width;
+	for (int y = 0; y < zint->bitmap_height; ++y, src += width) {
+		auto* row = dst + y * rowStride;
+		if (packedBits) {
+			std::memset(row, 0, RowBytes(format, packedBits, width));
+			for (int x = 0; x < width; ++x)
+				if (ZintLum[src[x]] < 0x80)
+					row[x / 8] |= 0x80 >> (x % 8);
+		} else if (format == ImageFormat::Lum) {
+			for (int x = 0; x < width; ++x)
+				row[x] = ZintLum[src[x]];
+		} else {
+			const int pixStride = PixStride(format);
+			for (int x = 0; x < width; ++x, row += pixStride)
+				std::memcpy(row, Pixel(format, ZintLum[src[x]]).data(), pixStride);
+		}
+	}
+}
+#endif
+
+// Renders the barcode in the given format into the memory returned by getBuffer(width, height) as pair of pointer and
+// row stride. If that pointer is nullptr, only the size is returned.
+template <typename GetBuffer>
+static PointI RenderBarcode(const Barcode& barcode, const WriterOptions& opts, ImageFormat format, bool packedBits,
+							GetBuffer getBuffer)
 {
+	if (!packedBits && (PixStride(format) < 1 || PixStride(format) > 4))
+		throw std::invalid_argument("Invalid image format for writing barcodes");
+
 	auto zint = barcode.zint();
 
-	if (!zint)
-		return ToImage(barcode._symbol->copy(), IsLinearBarcode(barcode.format()), opts);
+	if (!zint) {
+		auto symbol = barcode.symbol();
+		if (!symbol.data())
+			return {};
+
+		auto renderer = SymbolRenderer(symbol, IsLinearBarcode(barcode.format()), opts);
+		auto [dst, rowStride] = getBuffer(renderer.width, renderer.height);
+		if (dst)
+			renderer.render(format, packedBits, dst, rowStride);
+		return {renderer.width, renderer.height};
+	}
 
 #if defined(ZXING_WRITERS) && defined(ZXING_USE_ZINT)
 	auto resetOnExit = SetCommonWriterOptions(zint, opts);
 
+	// let zint write one byte per pixel instead of RGB values to save the colour conversion
+	zint->output_options |= OUT_BUFFER_INTERMEDIATE;
 	CHECK(ZBarcode_Buffer(zint, opts.rotate()));
 
 #ifdef PRINT_DEBUG
 	printf("write symbol with size: %dx%d\n", zint->bitmap_width, zint->bitmap_height);
 #endif
-	auto iv = Image(zint->bitmap_width, zint->bitmap_height);
-	auto* src = zint->bitmap;
-	auto* dst = const_cast<uint8_t*>(iv.data());
-	for(int y = 0; y < iv.height(); ++y)
-		for(int x = 0, w = iv.width(); x < w; ++x, src += 3)
-			*dst++ = RGBToLum(src[0], src[1], src[2]);
-
-	return iv;
+	auto [dst, rowStride] = getBuffer(zint->bitmap_width, zint->bitmap_height);
+	if (dst)
+		ConvertZintBitmap(zint, format, packedBits, dst, rowStride);
+	return {zint->bitmap_width, zint->bitmap_height};
 #else
 	return {}; // unreachable code
 #endif
 }
 
+Image WriteBarcodeToImage(const Barcode& barcode, const WriterOptions& opts)
+{
+	Image res;
+	RenderBarcode(barcode, opts, opts.imageFormat(), false, [&](int width, int height) {
+		res = Image(width, height, opts.imageFormat());
+		return std::pair(const_cast<uint8_t*>(res.data()), res.rowStride());
+	});
+	return res;
+}
+
+static PointI WriteBarcodeToBuffer(const Barcode& barcode, uint8_t* buffer, int size, int rowStride,
+								   const WriterOptions& opts, ImageFormat format, bool packedBits)
+{
+	return RenderBarcode(barcode, opts, format, packedBits, [&](int width, int height) {
+		const int rowBytes = RowBytes(format, packedBits, width);
+		if (rowStride == 0)
+			rowStride = rowBytes;
+		if (buffer && (rowStride < rowBytes || size < (height - 1) * rowStride + rowBytes))
+			throw std::invalid_argument("Buffer is too small for writing the barcode");
+		return std::pair(buffer, rowStride);
+	});
+}
+
+PointI WriteBarcodeToBuffer(const Barcode& barcode, uint8_t* buffer, int size, int rowStride, const WriterOptions& opts)
+{
+	return WriteBarcodeToBuffer(barcode, buffer, size, rowStride, opts, opts.imageFormat(), false);
+}
+
+PointI WriteBarcodeToBitmap(const Barcode& barcode, uint8_t* buffer, int size, int rowStride, const WriterOptions& opts)
+{
+	return WriteBarcodeToBuffer(barcode, buffer, size, rowStride, opts, ImageFormat::Lum, true);
+}
+
 std::string WriteBarcodeToUtf8(const Barcode& barcode, [[maybe_unused]] const WriterOptions& options)
 {
 	auto iv = barcode.symbol();
@@ -9,10 +9,12 @@
 
 #include "Barcode.h"
 #include "ImageView.h"
+#include "Range.h"
 
 #include <memory>
 #include <optional>
 #include <string_view>
+#include <vector>
 
 extern "C" struct zint_symbol;
 
@@ -56,6 +58,8 @@ public:
 	ZX_RO_PROPERTY(bool, forceSquare); // DataMatrix: only consider square symbol versions
 	ZX_RO_PROPERTY(int, version);      // most 2D symbologies: specify the version/size of the symbol
 	ZX_RO_PROPERTY(int, dataMask);     // QRCode/MicroQRCode: specify dataMask to use
+	ZX_RO_PROPERTY(bool, minimalEncoding); // DataMatrix: minimize the number of codewords (zint always does)
+	ZX_RO_PROPERTY(bool, builtinWriter);   // use the built-in encoders instead of zint (ZXING_WRITERS=BOTH only)
 #undef ZX_RO_PROPERTY
 };
 
@@ -95,6 +99,50 @@ Barcode CreateBarcodeFromBytes(const R& contents, const CreatorOptions& options)
 }
 #endif
 
+/**
+ * Generate many barcodes with the same CreatorOptions
+ *
+ * This is equivalent to calling CreateBarcodeFromText/Bytes for each payload but faster for large numbers of (small)
+ * symbols: the options are parsed only once and the payloads are distributed over a number of worker threads, each of
+ * which sets up its encoder (zint symbol) only once and reuses it for all of its payloads. The generated barcodes are
+ * not linked to a zint symbol, i.e. they are written based on their symbol() like the ones of the built-in writers.
+ */
+class BarcodeFactory
+{
+	struct Data;
+
+	std::unique_ptr<Data> d;
+
+public:
+	/**
+	 * @param options  CreatorOptions (including BarcodeFormat) used for all barcodes
+	 * @param numThreads  number of threads to use, 0 means std::thread::hardware_concurrency()
+	 */
+	explicit BarcodeFactory(CreatorOptions options, int numThreads = 0);
+
+	~BarcodeFactory();
+	BarcodeFactory(BarcodeFactory&&);
+	BarcodeFactory& operator=(BarcodeFactory&&);
+
+	const CreatorOptions& options() const noexcept;
+
+	/**
+	 * Generate barcodes from a list of unicode texts
+	 *
+	 * @param contents  list of UTF-8 strings to encode
+	 * @param results  receives one #Barcode for each payload in the same order, its capacity is reused between calls
+	 */
+	void createFromTexts(ArrayView<std::string_view> contents, std::vector<Barcode>& results) const;
+
+	/**
+	 * Generate barcodes from a list of raw binary data
+	 *
+	 * @param contents  list of byte arrays to encode
+	 * @param results  receives one #Barcode for each payload in the same order, its capacity is reused between calls
+	 */
+	void createFromBytes(ArrayView<ByteView> contents, std::vector<Barcode>& results) const;
+};
+
 // =================================================================================
 
 class WriterOptions
@@ -119,6 +167,7 @@ public:
 	ZX_PROPERTY(int, rotate)
 	ZX_PROPERTY(bool, withHRT)
 	ZX_PROPERTY(bool, withQuietZones)
+	ZX_PROPERTY(ImageFormat, imageFormat) ///< pixel format of WriteBarcodeToImage/Buffer, default is ImageFormat::Lum
 
 #undef ZX_PROPERTY
 };
@@ -151,6 +200,35 @@ std::string WriteBarcodeToUtf8(const Barcode& barcode, const WriterOptions& opti
  */
 Image WriteBarcodeToImage(const Barcode& barcode, const WriterOptions& options = {});
 
+/**
+ * Write barcode symbol into a caller-supplied buffer
+ *
+ * The symbol is rendered directly from its module matrix with integer scaling, in the pixel format given by
+ * WriterOptions::imageFormat(). Black modules are black (and opaque) pixels, everything else is white.
+ *
+ * @param barcode  Barcode to write
+ * @param buffer  memory to render into, if nullptr, only the size of the image is computed
+ * @param size  size of buffer in bytes
+ * @param rowStride  distance between the starts of two rows in bytes, 0 means width * PixStride(imageFormat)
+ * @param options  WriterOptions to parameterize rendering
+ * @return PointI  width and height of the image in pixels, {0, 0} if the barcode has no symbol
+ * @throw std::invalid_argument if buffer is too small
+ */
+PointI WriteBarcodeToBuffer(const Barcode& barcode, uint8_t* buffer, int size, int rowStride = 0,
+							const WriterOptions& options = {});
+
+/**
+ * Write barcode symbol into a caller-supplied buffer as bitmap with 1 bit per pixel
+ *
+ * Each row holds 8 pixels per byte, the leftmost pixel in the most significant bit, and set bits are black. This is
+ * the raster format of most thermal printers. WriterOptions::imageFormat() is ignored, everything else is the same as
+ * for WriteBarcodeToBuffer().
+ *
+ * @param rowStride  distance between the starts of two rows in bytes, 0 means (width + 7) / 8
+ */
+PointI WriteBarcodeToBitmap(const Barcode& barcode, uint8_t* buffer, int size, int rowStride = 0,
+							const WriterOptions& options = {});
+
 } // ZXing
 
 #endif // ZXING_EXPERIMENTAL_API
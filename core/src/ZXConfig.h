@@ -15,3 +15,8 @@
 // The Galoir Field abstractions used in Reed-Solomon error correction code can use more memory to eliminate a modulo
 // operation. This improves performance but might not be the best option if RAM is scarce. The effect is a few kB big.
 #define ZX_REED_SOLOMON_USE_MORE_MEMORY_FOR_SPEED
+
+// Reed-Solomon decoding in GF(256) (QRCode, DataMatrix, Aztec 8-bit) can use a dedicated Berlekamp-Massey decoder with
+// split-nibble multiplication tables that processes 16 codewords at a time (using SSSE3 or NEON if enabled at compile
+// time). Undefine this to always use the generic Euclidean decoder.
+#define ZX_REED_SOLOMON_GF256_FAST_PATH
@@ -15,11 +15,17 @@
 #define ZXING_VERSION_STR "undefined"
 #endif
 
+#if defined(ZXING_READERS) || defined(ZXING_USE_ZINT) || defined(ZXING_USE_BUILTIN_WRITERS)
+#include "HRI.h"
+#endif
+
 #include <cstdlib>
 #include <exception>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 using namespace ZXing;
 
@@ -259,6 +265,33 @@ ZXing_Barcode* ZXing_Barcodes_move(ZXing_Barcodes* barcodes, int i)
 	ZX_TRY(new Barcode(std::move((*barcodes)[i])));
 }
 
+int ZXing_ParseGS1(const char* gs1, int len, ZXing_GS1Element* elements, int maxElements)
+{
+	if (!gs1 || len < 0 || (maxElements > 0 && !elements)) {
+		lastErrorMsg = "Invalid GS1 string or elements param";
+		return -1;
+	}
+
+#if defined(ZXING_READERS) || defined(ZXING_USE_ZINT) || defined(ZXING_USE_BUILTIN_WRITERS)
+	try {
+		std::string_view str(gs1, len);
+		auto list = ParseGS1(str);
+		if (list.empty() && len) {
+			lastErrorMsg = "Invalid GS1 element string";
+			return -1;
+		}
+		for (int i = 0; i < std::min(Size(list), maxElements); ++i)
+			elements[i] = {narrow_cast<int>(list[i].ai.data() - gs1), Size(list[i].ai), narrow_cast<int>(list[i].value.data() - gs1),
+						   Size(list[i].value)};
+		return Size(list);
+	}
+	ZX_CATCH(-1)
+#else
+	lastErrorMsg = "GS1 parsing not supported in this build";
+	return -1;
+#endif
+}
+
 /*
  * ZXing/ReaderOptions.h
  */
@@ -325,6 +358,26 @@ ZXing_Barcodes* ZXing_ReadBarcodes(const ZXing_ImageView* iv, const ZXing_Reader
 	ZX_CATCH(NULL);
 }
 
+bool ZXing_ReadBarcodesBatch(const ZXing_ImageView* const* ivs, int count, const ZXing_ReaderOptions* opts, int numThreads,
+							 ZXing_Barcodes** results)
+{
+	ZX_CHECK(ivs && results, "ImageView list or results param is NULL")
+	ZX_CHECK(count >= 0, "Invalid count param")
+	try {
+		std::vector<ImageView> images;
+		images.reserve(count);
+		for (int i = 0; i < count; ++i) {
+			ZX_CHECK(ivs[i], "ImageView param is NULL")
+			images.push_back(*ivs[i]);
+		}
+		auto res = ReadBarcodesBatch(images, opts ? *opts : ReaderOptions{}, numThreads);
+		for (int i = 0; i < count; ++i)
+			results[i] = res[i].empty() ? &emptyBarcodes : new Barcodes(std::move(res[i]));
+		return true;
+	}
+	ZX_CATCH(false);
+}
+
 
 #ifdef ZXING_EXPERIMENTAL_API
 /*
@@ -393,6 +446,16 @@ ZX_PROPERTY(int, rotate, Rotate)
 ZX_PROPERTY(bool, withHRT, WithHRT)
 ZX_PROPERTY(bool, withQuietZones, WithQuietZones)
 
+void ZXing_WriterOptions_setImageFormat(ZXing_WriterOptions* opts, ZXing_ImageFormat format)
+{
+	opts->imageFormat(static_cast<ImageFormat>(format));
+}
+
+ZXing_ImageFormat ZXing_WriterOptions_getImageFormat(const ZXing_WriterOptions* opts)
+{
+	return static_cast<ZXing_ImageFormat>(opts->imageFormat());
+}
+
 #undef ZX_PROPERTY
 
 ZXing_Barcode* ZXing_CreateBarcodeFromText(const char* data, int size, const ZXing_CreatorOptions* opts)
@@ -407,6 +470,56 @@ ZXing_Barcode* ZXing_CreateBarcodeFromBytes(const void* data, int size, const ZX
 	ZX_TRY(new Barcode(CreateBarcodeFromBytes(data, size, *opts)))
 }
 
+// CreatorOptions is move-only, the BarcodeFactory gets its own copy of the settings
+static BarcodeFactory CreateBarcodeFactory(const ZXing_CreatorOptions& opts, int numThreads)
+{
+	return BarcodeFactory(CreatorOptions(opts.format(), opts.options())
+							  .readerInit(opts.readerInit())
+							  .forceSquareDataMatrix(opts.forceSquareDataMatrix())
+							  .ecLevel(opts.ecLevel()),
+						  numThreads);
+}
+
+ZXing_Barcodes* ZXing_CreateBarcodesFromTexts(const char* const* data, const int* sizes, int count,
+											  const ZXing_CreatorOptions* opts, int numThreads)
+{
+	ZX_CHECK(data && opts, "Data and/or options param in CreateBarcodesFromTexts is NULL")
+	ZX_CHECK(count >= 0, "Invalid count param")
+	try {
+		std::vector<std::string_view> texts;
+		texts.reserve(count);
+		for (int i = 0; i < count; ++i) {
+			ZX_CHECK(data[i], "Data param in CreateBarcodesFromTexts is NULL")
+			ZX_CHECK(!sizes || sizes[i] >= 0, "Size param in CreateBarcodesFromTexts is negative")
+			texts.emplace_back(data[i], sizes && sizes[i] ? static_cast<size_t>(sizes[i]) : strlen(data[i]));
+		}
+		auto res = std::make_unique<Barcodes>();
+		CreateBarcodeFactory(*opts, numThreads).createFromTexts(texts, *res);
+		return res.release();
+	}
+	ZX_CATCH(NULL)
+}
+
+ZXing_Barcodes* ZXing_CreateBarcodesFromBytes(const void* const* data, const int* sizes, int count,
+											  const ZXing_CreatorOptions* opts, int numThreads)
+{
+	ZX_CHECK(data && sizes && opts, "Data, sizes and/or options param in CreateBarcodesFromBytes is NULL")
+	ZX_CHECK(count >= 0, "Invalid count param")
+	try {
+		std::vector<ByteView> bytes;
+		bytes.reserve(count);
+		for (int i = 0; i < count; ++i) {
+			ZX_CHECK(data[i], "Data param in CreateBarcodesFromBytes is NULL")
+			ZX_CHECK(sizes[i] > 0, "Size param in CreateBarcodesFromBytes is not positive")
+			bytes.emplace_back(data[i], sizes[i]);
+		}
+		auto res = std::make_unique<Barcodes>();
+		CreateBarcodeFactory(*opts, numThreads).createFromBytes(bytes, *res);
+		return res.release();
+	}
+	ZX_CATCH(NULL)
+}
+
 char* ZXing_WriteBarcodeToSVG(const ZXing_Barcode* barcode, const ZXing_WriterOptions* opts)
 {
 	ZX_CHECK(barcode, "Barcode param in WriteBarcodeToSVG is NULL")
@@ -419,6 +532,34 @@ ZXing_Image* ZXing_WriteBarcodeToImage(const ZXing_Barcode* barcode, const ZXing
 	ZX_TRY(new Image(opts ? WriteBarcodeToImage(*barcode, *opts) : WriteBarcodeToImage(*barcode)))
 }
 
+static bool WriteBarcodeToBuffer(PointI (*write)(const Barcode&, uint8_t*, int, int, const WriterOptions&), const ZXing_Barcode* barcode, const ZXing_WriterOptions* opts, uint8_t* buffer,
+								 int size, int rowStride, int* width, int* height)
+{
+	ZX_CHECK(barcode, "Barcode param in WriteBarcodeToBuffer is NULL")
+	try {
+		const WriterOptions defaultOpts;
+		auto res = write(*barcode, buffer, size, rowStride, opts ? *opts : defaultOpts);
+		if (width)
+			*width = res.x;
+		if (height)
+			*height = res.y;
+		return true;
+	}
+	ZX_CATCH(false)
+}
+
+bool ZXing_WriteBarcodeToBuffer(const ZXing_Barcode* barcode, const ZXing_WriterOptions* opts, uint8_t* buffer, int size,
+								int rowStride, int* width, int* height)
+{
+	return WriteBarcodeToBuffer(ZXing::WriteBarcodeToBuffer, barcode, opts, buffer, size, rowStride, width, height);
+}
+
+bool ZXing_WriteBarcodeToBitmap(const ZXing_Barcode* barcode, const ZXing_WriterOptions* opts, uint8_t* buffer, int size,
+								int rowStride, int* width, int* height)
+{
+	return WriteBarcodeToBuffer(ZXing::WriteBarcodeToBitmap, barcode, opts, buffer, size, rowStride, width, height);
+}
+
 #endif
 
 /*
@@ -198,6 +198,18 @@ int ZXing_Barcodes_size(const ZXing_Barcodes* barcodes);
 const ZXing_Barcode* ZXing_Barcodes_at(const ZXing_Barcodes* barcodes, int i);
 ZXing_Barcode* ZXing_Barcodes_move(ZXing_Barcodes* barcodes, int i);
 
+typedef struct ZXing_GS1Element
+{
+	int aiPos, aiLen, valuePos, valueLen;
+} ZXing_GS1Element;
+
+/**
+ * Split the GS1 element string gs1 (e.g. the bytes of a barcode with content type ZXing_ContentType_GS1) into its
+ * Application Identifier / value pairs. Up to maxElements pairs are stored in elements as offsets into gs1.
+ * Returns the total number of pairs (which may be larger than maxElements) or -1 if gs1 is not a valid element string.
+ */
+int ZXing_ParseGS1(const char* gs1, int len, ZXing_GS1Element* elements, int maxElements);
+
 /*
  * ZXing/ReaderOptions.h
  */
@@ -268,6 +280,15 @@ int ZXing_ReaderOptions_getMaxNumberOfSymbols(const ZXing_ReaderOptions* opts);
 /** Note: opts is optional, i.e. it can be NULL, which will imply default settings. */
 ZXing_Barcodes* ZXing_ReadBarcodes(const ZXing_ImageView* iv, const ZXing_ReaderOptions* opts);
 
+/**
+ * Read barcodes from count images, distributed over numThreads threads (0 means the number of CPU cores).
+ * On success, results[i] receives the barcodes found in ivs[i], each one needs to be freed with ZXing_Barcodes_delete.
+ * Returns false on error, in which case results is left untouched.
+ * Note: opts is optional, i.e. it can be NULL, which will imply default settings.
+ */
+bool ZXing_ReadBarcodesBatch(const ZXing_ImageView* const* ivs, int count, const ZXing_ReaderOptions* opts, int numThreads,
+							 ZXing_Barcodes** results);
+
 #ifdef ZXING_EXPERIMENTAL_API
 
 /*
@@ -311,14 +332,38 @@ bool ZXing_WriterOptions_getWithHRT(const ZXing_WriterOptions* opts);
 void ZXing_WriterOptions_setWithQuietZones(ZXing_WriterOptions* opts, bool withQuietZones);
 bool ZXing_WriterOptions_getWithQuietZones(const ZXing_WriterOptions* opts);
 
+void ZXing_WriterOptions_setImageFormat(ZXing_WriterOptions* opts, ZXing_ImageFormat format);
+ZXing_ImageFormat ZXing_WriterOptions_getImageFormat(const ZXing_WriterOptions* opts);
+
 
 ZXing_Barcode* ZXing_CreateBarcodeFromText(const char* data, int size, const ZXing_CreatorOptions* opts);
 ZXing_Barcode* ZXing_CreateBarcodeFromBytes(const void* data, int size, const ZXing_CreatorOptions* opts);
 
+/**
+ * Create barcodes from count texts/byte arrays with the same options, distributed over numThreads threads (0 means the
+ * number of CPU cores). data[i] holds sizes[i] bytes, for texts sizes may be NULL and a size of 0 means strlen(data[i]),
+ * byte arrays must not be empty.
+ * Returns NULL on error, otherwise the barcodes in the same order as the input (see ZXing_Barcodes_at/_move).
+ */
+ZXing_Barcodes* ZXing_CreateBarcodesFromTexts(const char* const* data, const int* sizes, int count,
+											  const ZXing_CreatorOptions* opts, int numThreads);
+ZXing_Barcodes* ZXing_CreateBarcodesFromBytes(const void* const* data, const int* sizes, int count,
+											  const ZXing_CreatorOptions* opts, int numThreads);
+
 /** Note: opts is optional, i.e. it can be NULL, which will imply default settings. */
 char* ZXing_WriteBarcodeToSVG(const ZXing_Barcode* barcode, const ZXing_WriterOptions* opts);
 ZXing_Image* ZXing_WriteBarcodeToImage(const ZXing_Barcode* barcode, const ZXing_WriterOptions* opts);
 
+/**
+ * Render the barcode into the caller-supplied buffer of size bytes with rows rowStride bytes apart (0 means tightly
+ * packed), in the image format of opts (ToBuffer) or with 1 bit per pixel, most significant bit first and set bits for
+ * black (ToBitmap). If buffer is NULL, only width and height are returned. Returns false on error.
+ */
+bool ZXing_WriteBarcodeToBuffer(const ZXing_Barcode* barcode, const ZXing_WriterOptions* opts, uint8_t* buffer, int size,
+								int rowStride, int* width, int* height);
+bool ZXing_WriteBarcodeToBitmap(const ZXing_Barcode* barcode, const ZXing_WriterOptions* opts, uint8_t* buffer, int size,
+								int rowStride, int* width, int* height);
+
 #endif /* ZXING_EXPERIMENTAL_API */
 
 /* ZXing_LastErrorMsg() returns NULL in case there is no last error and a copy of the string otherwise. */
@@ -255,6 +255,8 @@ static void DecodeContent(const BitArray& bits, Content& res, bool &haveFNC1)
 
 	auto remBits = BitArrayView(bits);
 	haveFNC1 = false;
+	// the densest encoding are the 2 character entries of the PUNCT table (like ", "), 5 bits each
+	res.reserve(Size(bits) * 2 / 5 + 1);
 
 	while (remBits.size() >= (shiftTable == Table::DIGIT ? 4 : 5)) { // see ISO/IEC 24778:2008 7.3.1.2 regarding padding bits
 		if (shiftTable == Table::BINARY) {
@@ -33,8 +33,11 @@ static bool IsAztecCenterPattern(const PatternView& view)
 	for (int i = 1; i < Size(view) - 1; ++i) {
 		int v = view[i] + view[i + 1];
 		UpdateMinMax(m, M, v);
+		// m can only shrink and M only grow, so bail out as soon as the pairs are too different (the common case)
+		if (M > m * 4 / 3 + 1)
+			return false;
 	}
-	return M <= m * 4 / 3 + 1 && view[-1] >= view[Size(view) / 2] - 2 && view[Size(view)] >= view[Size(view) / 2] - 2;
+	return view[-1] >= view[Size(view) / 2] - 2 && view[Size(view)] >= view[Size(view) / 2] - 2;
 };
 
 // specialized version of FindLeftGuard to find the '1,1,1,1,1,1,1' pattern of a compact Aztec center pattern
@@ -92,14 +95,18 @@ static int CheckSymmetricAztecCenterPattern(BitMatrixCursorI& cur, int range, bo
 	return spread;
 }
 
-static std::optional<ConcentricPattern> LocateAztecCenter(const BitMatrix& image, PointF center, int spreadH)
+static std::optional<ConcentricPattern> LocateAztecCenter(const BitMatrix& image, PointF center, int spreadH,
+															 bool* failedVertically = nullptr)
 {
 	auto cur = BitMatrixCursor(image, PointI(center), {});
 	int minSpread = spreadH, maxSpread = 0;
 	for (auto d : {PointI{0, 1}, {1, 0}, {1, 1}, {1, -1}}) {
 		int spread = CheckSymmetricAztecCenterPattern(cur.setDirection(d), spreadH, d.x == 0);
-		if (!spread)
+		if (!spread) {
+			if (failedVertically)
+				*failedVertically = d.x == 0;
 			return {};
+		}
 		UpdateMinMax(minSpread, maxSpread, spread);
 	}
 
@@ -184,8 +191,27 @@ static std::vector<ConcentricPattern> FindFinderPatterns(const BitMatrix& image,
 
 	PatternRow row;
 
+	// Candidates that failed the vertical check of LocateAztecCenter in the previous row. That check only depends on the
+	// column, the vertical run the candidate lies in and the horizontal spread. The text and graphics around tickets and
+	// boarding passes produce the same false candidate in many subsequent rows, which can be skipped this way.
+	struct Rejected
+	{
+		int x, spread;
+		bool operator==(const Rejected& o) const { return x == o.x && spread == o.spread; }
+	};
+	std::vector<Rejected> rejected, lastRejected;
+	auto isInLastRun = [&](int x, int y) {
+		for (int i = 1; i <= skip; ++i)
+			if (image.get(x, y - i) != image.get(x, y))
+				return false;
+		return true;
+	};
+
 	for (int y = margin; y < image.height() - margin; y += skip)
 	{
+		std::swap(rejected, lastRejected);
+		rejected.clear();
+
 		GetPatternRow(image, y, row, false);
 		PatternView next = row;
 		next.shift(1); // the center pattern we are looking for starts with white and is 7 wide (compact code)
@@ -211,14 +237,23 @@ static std::vector<ConcentricPattern> FindFinderPatterns(const BitMatrix& image,
 			}
 
 			if (!found) {
-				++N;
-				log(p, 1);
-
-				auto pattern = LocateAztecCenter(image, p, next.sum());
-				if (pattern) {
-					log(*pattern, 3);
-					assert(image.get(*pattern));
-					res.push_back(*pattern);
+				Rejected candidate = {PointI(p).x, next.sum()};
+				bool failedVertically = false;
+				if (Contains(lastRejected, candidate) && isInLastRun(candidate.x, y)) {
+					rejected.push_back(candidate);
+				} else {
+					++N;
+					log(p, 1);
+
+					auto pattern = LocateAztecCenter(image, p, candidate.spread, &failedVertically);
+					// different candidates may lead to the same center, e.g. if the first one was off-center
+					if (pattern && FindIf(res, [&](const auto& old) { return distance(*pattern, old) < old.size / 2; }) == res.end()) {
+						log(*pattern, 3);
+						assert(image.get(*pattern));
+						res.push_back(*pattern);
+					} else if (failedVertically) {
+						rejected.push_back(candidate);
+					}
 				}
 			}
 
@@ -280,7 +280,9 @@ Encoder::Encode(const std::string& data, int minECCPercent, int userSpecifiedLay
 		}
 	}
 
-	EncodeResult output{compact, matrixSize, layers, messageSizeInWords, BitMatrix(matrixSize)};
+	int totalWords = layers ? totalBitsInLayer / wordSize : 0;
+	int eccPercent = totalWords ? (totalWords - messageSizeInWords) * 100 / totalWords : 0;
+	EncodeResult output{compact, matrixSize, layers, messageSizeInWords, BitMatrix(matrixSize), eccPercent};
 
 	BitMatrix& matrix = output.matrix;
 
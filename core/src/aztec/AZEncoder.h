@@ -24,6 +24,7 @@ struct EncodeResult
 	int layers;
 	int codeWords;
 	BitMatrix matrix;
+	int eccPercent; // share of error correction code words, as reported by the decoder
 };
 
 /**
@@ -12,18 +12,50 @@
 
 namespace ZXing::Aztec {
 
-class Token;
+/**
+* Storage for the tokens of all states created during the search. Every token is stored once, linked to the token
+* preceding it, so that a new state shares the tokens of the state it was derived from instead of copying them.
+*/
+class TokenArena
+{
+	struct Node
+	{
+		Token token;
+		int prev;
+	};
+	std::vector<Node> _nodes;
+
+public:
+	void reserve(size_t size) { _nodes.reserve(size); }
+
+	// Append token after the token with index last (-1 for none) and return the index of the new token.
+	int append(int last, Token token)
+	{
+		_nodes.push_back({token, last});
+		return static_cast<int>(_nodes.size()) - 1;
+	}
+
+	// Return the sequence of tokens ending with the token at index last.
+	std::vector<Token> tokens(int last) const
+	{
+		std::vector<Token> res;
+		for (; last >= 0; last = _nodes[last].prev)
+			res.push_back(_nodes[last].token);
+		return {res.rbegin(), res.rend()};
+	}
+};
 
 /**
 * State represents all information about a sequence necessary to generate the current output.
-* Note that a state is immutable.
+* Note that a state is immutable and cheap to copy, its tokens are kept in a TokenArena.
 */
 class EncodingState
 {
 public:
-	// The list of tokens that we output.  If we are in Binary Shift mode, this
-	// token list does *not* yet included the token for those bytes
-	std::vector<Token> tokens;
+	// The index of the last token that we output in the TokenArena (-1 if none).
+	// If we are in Binary Shift mode, this does *not* yet include the token for
+	// those bytes
+	int lastToken = -1;
 
 	// The current mode of the encoding (or the mode to which we'll return if
 	// we're in Binary Shift mode.
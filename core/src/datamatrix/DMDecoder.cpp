@@ -277,6 +277,8 @@ DecoderResult Decode(ByteArray&& bytes, const bool isDMRE)
 	Error error;
 	result.symbology = {'d', '1', 3}; // ECC 200 (ISO 16022:2006 Annex N Table N.1)
 	std::string resultTrailer;
+	// ASCII digit pairs are the densest encodation with 2 characters per code word, plus macro 05/06 header and trailer
+	result.reserve(2 * Size(bytes) + 9);
 
 	struct StructuredAppendInfo sai;
 	bool readerInit = false;
@@ -377,18 +379,8 @@ DecoderResult Decode(ByteArray&& bytes, const bool isDMRE)
 static bool
 CorrectErrors(ByteArray& codewordBytes, int numDataCodewords)
 {
-	// First read into an array of ints
-	std::vector<int> codewordsInts(codewordBytes.begin(), codewordBytes.end());
-	int numECCodewords = Size(codewordBytes) - numDataCodewords;
-
-	if (!ReedSolomonDecode(GenericGF::DataMatrixField256(), codewordsInts, numECCodewords))
-		return false;
-
-	// Copy back into array of bytes -- only need to worry about the bytes that were data
-	// We don't care about errors in the error-correction codewords
-	std::copy_n(codewordsInts.begin(), numDataCodewords, codewordBytes.begin());
-
-	return true;
+	// correct the codewords in-place, a clean block is verified by a syndrome check without any allocations
+	return ReedSolomonDecode(GenericGF::DataMatrixField256(), codewordBytes, Size(codewordBytes) - numDataCodewords);
 }
 
 static DecoderResult DoDecode(const BitMatrix& bits)
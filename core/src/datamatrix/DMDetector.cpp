@@ -9,7 +9,6 @@
 
 #include "BitMatrix.h"
 #include "BitMatrixCursor.h"
-#include "ByteMatrix.h"
 #include "DetectorResult.h"
 #include "GridSampler.h"
 #include "LogMatrix.h"
@@ -25,6 +24,8 @@
 #include <cmath>
 #include <cstdlib>
 #include <map>
+#include <memory>
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -515,6 +516,36 @@ public:
 	}
 };
 
+/**
+* A log of where the tracing already passed by to prevent a later trace from doing the same work twice. It stores 4 bits
+* per pixel (two pixels per byte): the scan direction and the trace state that last visited it. Including the scan
+* direction in the entry allows to share one log between all directions of a multi-line search without clearing it.
+* It also counts down the remaining number of trace steps the search may spend before it stops starting new lines.
+*/
+class TraceHistory
+{
+	int _width;
+	std::vector<uint8_t> _data;
+
+public:
+	int budget;
+
+	TraceHistory(int width, int height, int budget) : _width(width), _data((width * height + 1) / 2, 0), budget(budget) {}
+
+	int get(PointI p) const
+	{
+		auto i = p.y * _width + p.x;
+		return (_data[i / 2] >> (i & 1) * 4) & 0xF;
+	}
+
+	void set(PointI p, int value)
+	{
+		auto i = p.y * _width + p.x;
+		auto shift = (i & 1) * 4;
+		_data[i / 2] = narrow_cast<uint8_t>((_data[i / 2] & ~(0xF << shift)) | (value << shift));
+	}
+};
+
 class EdgeTracer : public BitMatrixCursorF
 {
 	enum class StepResult { FOUND, OPEN_END, CLOSED_END };
@@ -528,6 +559,9 @@ class EdgeTracer : public BitMatrixCursorF
 #endif
 	StepResult traceStep(PointF dEdge, int maxStepSize, bool goodDirection)
 	{
+		if (history)
+			--history->budget;
+
 		dEdge = mainDirection(dEdge);
 		for (int breadth = 1; breadth <= (maxStepSize == 1 ? 2 : (goodDirection ? 1 : 3)); ++breadth)
 			for (int step = 1; step <= maxStepSize; ++step)
@@ -546,9 +580,10 @@ class EdgeTracer : public BitMatrixCursorF
 							p = centered(pEdge);
 
 							if (history && maxStepSize == 1) {
-								if (history->get(PointI(p)) == state)
+								auto entry = scanDirection << 2 | state;
+								if (history->get(PointI(p)) == entry)
 									return StepResult::CLOSED_END;
-								history->set(PointI(p), state);
+								history->set(PointI(p), entry);
 							}
 
 							return StepResult::FOUND;
@@ -565,7 +600,8 @@ class EdgeTracer : public BitMatrixCursorF
 	}
 
 public:
-	ByteMatrix* history = nullptr;
+	TraceHistory* history = nullptr;
+	int scanDirection = 0; // index of the scan direction of the multi-line search, see SymbolSearch
 	int state = 0;
 
 	using BitMatrixCursorF::BitMatrixCursor;
@@ -858,115 +894,148 @@ static DetectorResult Scan(EdgeTracer& startTracer, std::array<DMRegressionLine,
 	return {};
 }
 
-static DetectorResults DetectNew(const BitMatrix& image, bool tryHarder, bool tryRotate)
+/**
+* The multi-line search of the 'new' detector: starting at the center line of the image, it scans lines in up to four
+* directions for the L-shape of a symbol (see Scan). With tryHarder it additionally scans parallel lines alternating
+* around the center line, which finds off-center and multiple symbols. The search is resumable: every call of next()
+* continues where the previous one returned, so callers only pay for the candidates they actually look at. Once the work
+* budget of trace steps is spent, no further off-center lines are started, which bounds the time spent on noisy images.
+*/
+class SymbolSearch
 {
-#ifdef PRINT_DEBUG
-	LogMatrixWriter lmw(log, image, 1, "dm-log.pnm");
-//	tryRotate = tryHarder = false;
-#endif
-
-	// disable expensive multi-line scan to detect off-center symbols for now
-#ifndef __cpp_impl_coroutine
-	tryHarder = false;
-#endif
-
-	// a history log to remember where the tracing already passed by to prevent a later trace from doing the same work twice
-	ByteMatrix history;
-	if (tryHarder)
-		history = ByteMatrix(image.width(), image.height());
+	static constexpr int minSymbolSize = 8 * 2; // minimum realistic size in pixel: 8 modules x 2 pixels per module
+	static constexpr int stepsPerPixel = 2; // work budget of the multi-line search (number of trace steps per pixel)
 
+	const BitMatrix& _image;
+	bool _tryHarder, _tryRotate;
+	std::optional<TraceHistory> _history;
 	// instantiate RegressionLine objects outside of Scan function to prevent repetitive std::vector allocations
-	std::array<DMRegressionLine, 4> lines;
-
-	constexpr int minSymbolSize = 8 * 2; // minimum realistic size in pixel: 8 modules x 2 pixels per module
+	std::array<DMRegressionLine, 4> _lines;
+	std::optional<EdgeTracer> _tracer;
+	int _dirIndex = 0;
+	int _lineIndex = 0;
 
-	for (auto dir : {PointF{-1, 0}, {1, 0}, {0, -1}, {0, 1}}) {
-		auto center = PointI(image.width() / 2, image.height() / 2);
-		auto startPos = centered(center - center * dir + minSymbolSize / 2 * dir);
+	bool nextStartLine()
+	{
+		static const std::array<PointF, 4> dirs = {PointF{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
 
-		history.clear();
+		while (_dirIndex < (_tryRotate ? Size(dirs) : 1)) {
+			auto dir = dirs[_dirIndex];
+			auto center = PointI(_image.width() / 2, _image.height() / 2);
+			auto startPos = centered(center - center * dir + minSymbolSize / 2 * dir);
 
-		for (int i = 1;; ++i) {
-			EdgeTracer tracer(image, startPos, dir);
+			int i = ++_lineIndex;
+			EdgeTracer tracer(_image, startPos, dir);
 			tracer.p += i / 2 * minSymbolSize * (i & 1 ? -1 : 1) * tracer.right();
-			if (tryHarder)
-				tracer.history = &history;
-
-			if (!tracer.isIn())
-				break;
 
-#ifdef __cpp_impl_coroutine
-			DetectorResult res;
-			while (res = Scan(tracer, lines), res.isValid())
-				co_yield std::move(res);
-#else
-			if (auto res = Scan(tracer, lines); res.isValid())
-				return res;
-#endif
+			// only test the center line if not tryHarder
+			if (tracer.isIn() && (i == 1 || (_tryHarder && _history->budget > 0))) {
+				if (_history)
+					tracer.history = &*_history;
+				tracer.scanDirection = _dirIndex;
+				_tracer = tracer;
+				return true;
+			}
 
-			if (!tryHarder)
-				break; // only test center lines
+			++_dirIndex;
+			_lineIndex = 0;
 		}
+		return false;
+	}
 
-		if (!tryRotate)
-			break; // only test left direction
+public:
+	SymbolSearch(const BitMatrix& image, bool tryHarder, bool tryRotate) : _image(image), _tryHarder(tryHarder), _tryRotate(tryRotate)
+	{
+		if (tryHarder)
+			_history.emplace(image.width(), image.height(), stepsPerPixel * image.width() * image.height());
 	}
 
-#ifndef __cpp_impl_coroutine
-	return {};
-#endif
-}
+	DetectorResult next()
+	{
+		while (_tracer || nextStartLine()) {
+			if (auto res = Scan(*_tracer, _lines); res.isValid())
+				return res;
+			_tracer.reset();
+		}
+		return {};
+	}
+};
 
 /**
 * This method detects a code in a "pure" image -- that is, pure monochrome image
-* which contains only an unrotated, unskewed, image of a code, with some optional white border
+* which contains only an unskewed image of a code, with some optional white border
 * around it. This is a specialized method that works exceptionally fast in this special
 * case.
+*
+* The symbol may be rotated by a multiple of 90 degrees (if tryRotate): the L-shaped finder is identified as the
+* two adjacent solid sides of the bounding box, the clock tracks on the opposite sides provide the dimension. The
+* bits are sampled such that the L ends up at the bottom-left. A mirrored symbol therefore ends up transposed, which
+* is handled by the decoder.
 */
-static DetectorResult DetectPure(const BitMatrix& image)
+static DetectorResult DetectPure(const BitMatrix& image, bool tryRotate)
 {
 	int left, top, width, height;
 	if (!image.findBoundingBox(left, top, width, height, 8))
 		return {};
 
-	BitMatrixCursorI cur(image, {left, top}, {0, 1});
-	if (cur.countEdges(height - 1) != 0)
-		return {};
-	cur.turnLeft();
-	if (cur.countEdges(width - 1) != 0)
+	int right  = left + width - 1;
+	int bottom = top + height - 1;
+
+	// the 4 sides of the bounding box, walked counterclockwise starting with the left side from top to bottom
+	const std::array<PointI, 4> corners = {PointI{left, top}, {left, bottom}, {right, bottom}, {right, top}};
+	const std::array<PointI, 4> dirs = {PointI{0, 1}, {1, 0}, {0, -1}, {-1, 0}};
+	const std::array<int, 4> lengths = {height, width, height, width};
+	std::array<int, 4> edges;
+	for (int i = 0; i < 4; ++i)
+		edges[i] = BitMatrixCursorI(image, corners[i], dirs[i]).countEdges(lengths[i] - 1);
+
+	// find the finder pattern: side i is the (solid) left side, side i + 1 the (solid) bottom side of the symbol
+	int i = 0;
+	while (i < (tryRotate ? 4 : 1) && (edges[i] != 0 || edges[(i + 1) % 4] != 0))
+		++i;
+	if (i == (tryRotate ? 4 : 1))
 		return {};
-	cur.turnLeft();
-	int dimR = cur.countEdges(height - 1) + 1;
-	cur.turnLeft();
-	int dimT = cur.countEdges(width - 1) + 1;
 
-	auto modSizeX = float(width) / dimT;
-	auto modSizeY = float(height) / dimR;
+	int dimR = edges[(i + 2) % 4] + 1;
+	int dimT = edges[(i + 3) % 4] + 1;
+
+	auto modSizeX = float(lengths[(i + 1) % 4]) / dimT;
+	auto modSizeY = float(lengths[i]) / dimR;
 	auto modSize = (modSizeX + modSizeY) / 2;
 
-	if (dimT % 2 != 0 || dimR % 2 != 0 || dimT < 10 || dimT > 144 || dimR < 8 || dimR > 144
-		|| std::abs(modSizeX - modSizeY) > 1
-		|| !image.isIn(PointF{left + modSizeX / 2 + (dimT - 1) * modSize, top + modSizeY / 2 + (dimR - 1) * modSize}))
-		return {};
+	// the origin of the symbol is the outer corner of the pixel at the start of its left side
+	auto dx = PointF(dirs[(i + 1) % 4]), dy = PointF(dirs[i]);
+	auto origin = PointF(corners[i]) + 0.5 * (PointF(1, 1) - dx - dy);
+	auto moduleCenter = [&](int x, int y) { return origin + (modSizeX / 2 + x * modSize) * dx + (modSizeY / 2 + y * modSize) * dy; };
 
-	int right  = left + width - 1;
-	int bottom = top + height - 1;
+	// rectangular symbols are wider than high, unless they are mirrored
+	if (dimT % 2 != 0 || dimR % 2 != 0 || std::min(dimT, dimR) < 8 || std::max(dimT, dimR) < 10 || dimT > 144 || dimR > 144
+		|| std::abs(modSizeX - modSizeY) > 1 || !image.isIn(moduleCenter(dimT - 1, dimR - 1)))
+		return {};
 
 	// Now just read off the bits (this is a crop + subsample)
-	return {Deflate(image, dimT, dimR, top + modSizeY / 2, left + modSizeX / 2, modSize),
-			{{left, top}, {right, top}, {right, bottom}, {left, bottom}}};
+	BitMatrix bits(dimT, dimR);
+	for (int y = 0; y < dimR; ++y)
+		for (int x = 0; x < dimT; ++x)
+			if (image.get(moduleCenter(x, y)))
+				bits.set(x, y);
+
+	return {std::move(bits), {corners[i], corners[(i + 3) % 4], corners[(i + 2) % 4], corners[(i + 1) % 4]}};
 }
 
 DetectorResults Detect(const BitMatrix& image, bool tryHarder, bool tryRotate, bool isPure)
 {
 #ifdef __cpp_impl_coroutine
+#ifdef PRINT_DEBUG
+	LogMatrixWriter lmw(log, image, 1, "dm-log.pnm");
+#endif
 	// First try the very fast DetectPure() path. Also because DetectNew() generally fails with pure module size 1 symbols
-	// TODO: implement a tryRotate version of DetectPure, see #590.
-	if (auto r = DetectPure(image); r.isValid())
+	if (auto r = DetectPure(image, tryRotate); r.isValid())
 		co_yield std::move(r);
 	else if (!isPure) { // If r.isValid() then there is no point in looking for more (no-pure) symbols
 		bool found = false;
-		for (auto&& r : DetectNew(image, tryHarder, tryRotate)) {
+		SymbolSearch search(image, tryHarder, tryRotate);
+		for (auto r = search.next(); r.isValid(); r = search.next()) {
 			found = true;
 			co_yield std::move(r);
 		}
@@ -976,12 +1045,34 @@ DetectorResults Detect(const BitMatrix& image, bool tryHarder, bool tryRotate, b
 		}
 	}
 #else
-	auto result = DetectPure(image);
-	if (!result.isValid() && !isPure)
-		result = DetectNew(image, tryHarder, tryRotate);
-	if (!result.isValid() && tryHarder && !isPure)
-		result = DetectOld(image);
-	return result;
+	// same sequence of candidates as above, produced on demand by a state machine instead of a coroutine
+	enum class Stage { Pure, New, Old, Done };
+	auto search = isPure ? nullptr : std::make_shared<SymbolSearch>(image, tryHarder, tryRotate);
+	return DetectorResults([&image, tryHarder, tryRotate, search, stage = Stage::Pure, found = false]() mutable -> DetectorResult {
+		switch (stage) {
+		case Stage::Pure:
+			if (auto r = DetectPure(image, tryRotate); r.isValid() || !search) {
+				stage = Stage::Done;
+				return r;
+			}
+			stage = Stage::New;
+			[[fallthrough]];
+		case Stage::New:
+			if (auto r = search->next(); r.isValid()) {
+				found = true;
+				return r;
+			}
+			stage = Stage::Old;
+			[[fallthrough]];
+		case Stage::Old:
+			stage = Stage::Done;
+			if (!found && tryHarder)
+				return DetectOld(image);
+			[[fallthrough]];
+		case Stage::Done: break;
+		}
+		return {};
+	});
 #endif
 }
 
@@ -6,22 +6,60 @@
 
 #pragma once
 
+#include <DetectorResult.h>
+
 #ifdef __cpp_impl_coroutine
 #include <Generator.h>
-#include <DetectorResult.h>
+#else
+#include <functional>
+#include <utility>
 #endif
 
 namespace ZXing {
 
 class BitMatrix;
-class DetectorResult;
 
 namespace DataMatrix {
 
 #ifdef __cpp_impl_coroutine
 using DetectorResults = Generator<DetectorResult>;
 #else
-using DetectorResults = DetectorResult;
+/**
+* Lazy sequence of DetectorResults for builds without coroutine support. Like the Generator it only supports a single
+* pass range-for loop. The next candidate is computed when the loop asks for it, so a caller that stops after the first
+* successfully decoded symbol does not pay for the rest of the search.
+*/
+class DetectorResults
+{
+	std::function<DetectorResult()> _next; // returns an invalid result when there are no more candidates
+	DetectorResult _current;
+
+public:
+	explicit DetectorResults(std::function<DetectorResult()> next) : _next(std::move(next)) {}
+
+	class Iterator
+	{
+		DetectorResults* _results;
+
+	public:
+		explicit Iterator(DetectorResults* results) : _results(results) {}
+
+		DetectorResult& operator*() const { return _results->_current; }
+		Iterator& operator++()
+		{
+			_results->_current = _results->_next();
+			return *this;
+		}
+		bool operator!=(const Iterator&) const { return _results->_current.isValid(); }
+	};
+
+	Iterator begin()
+	{
+		_current = _next();
+		return Iterator(this);
+	}
+	Iterator end() { return Iterator(this); }
+};
 #endif
 
 DetectorResults Detect(const BitMatrix& image, bool tryHarder, bool tryRotate, bool isPure);
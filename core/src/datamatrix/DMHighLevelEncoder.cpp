@@ -21,6 +21,8 @@
 #include <limits>
 #include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace ZXing::DataMatrix {
 
@@ -840,6 +842,372 @@ namespace Base256Encoder {
 
 } // Base256Encoder
 
+static void AddPadding(ByteArray& codewords, int capacity)
+{
+	if (Size(codewords) < capacity) {
+		codewords.push_back(PAD);
+	}
+	while (Size(codewords) < capacity) {
+		codewords.push_back(Randomize253State(PAD, Size(codewords) + 1));
+	}
+}
+
+namespace MinimalEncoder {
+
+	// The maximal data capacity of a symbol (144x144), longer messages can not be encoded even with 2 digits per codeword.
+	static const int MAX_CODEWORDS = 1558;
+	static const int MAX_BASE256_LENGTH = 1555;
+	static const int MODE_COUNT = 6;
+	static const int INF = std::numeric_limits<int>::max() / 2;
+
+	static int C40ValueCount(int c, int mode)
+	{
+		if (c >= 128)
+			return 2 + C40ValueCount(c - 128, mode);
+		return (mode == C40_ENCODATION ? IsNativeC40(c) : IsNativeText(c)) ? 1 : 2;
+	}
+
+	// Shortest path over the nodes (position, mode), where a node means: the characters before position are encoded and
+	// the encoder is latched into mode. An edge either switches the mode without consuming characters (latch/unlatch)
+	// or consumes the characters of one whole codeword group in the current mode, i.e. a C40/Text/X12 triplet or an
+	// EDIFACT quadruple, so that no group ever spans several edges. Each node only keeps its cost and predecessor, the
+	// table therefore needs (length + 1) * 6 small entries.
+	class Graph
+	{
+		struct Node
+		{
+			int cost = INF;
+			int prev = -1;		   // index of the predecessor node
+			int base256Length = 0; // number of characters in the current Base256 segment
+		};
+
+		const std::string& _msg;
+		int _begin, _end;
+		bool _withBase256;
+		std::vector<Node> _nodes;
+
+		Node& node(int pos, int mode) { return _nodes[(pos - _begin) * MODE_COUNT + mode]; }
+
+		void relax(int fromPos, int fromMode, int toPos, int toMode, int cost, int base256Length = 0)
+		{
+			auto& from = node(fromPos, fromMode);
+			auto& to = node(toPos, toMode);
+			if (from.cost + cost < to.cost) {
+				to.cost = from.cost + cost;
+				to.prev = (fromPos - _begin) * MODE_COUNT + fromMode;
+				to.base256Length = base256Length;
+			}
+		}
+
+		int charAt(int pos) const { return _msg[pos] & 0xff; }
+
+		template <typename P>
+		bool allOf(int pos, int count, P pred) const
+		{
+			return pos + count <= _end && std::all_of(_msg.begin() + pos, _msg.begin() + pos + count,
+													  [pred](char c) { return pred(c & 0xff); });
+		}
+
+		void relaxSwitches(int pos)
+		{
+			// unlatch first, so that a latch into another mode can follow at the same position
+			relax(pos, C40_ENCODATION, pos, ASCII_ENCODATION, 1);
+			relax(pos, TEXT_ENCODATION, pos, ASCII_ENCODATION, 1);
+			relax(pos, X12_ENCODATION, pos, ASCII_ENCODATION, 1);
+			relax(pos, EDIFACT_ENCODATION, pos, ASCII_ENCODATION, 1); // unlatch value in its own codeword
+			if (_withBase256)
+				relax(pos, BASE256_ENCODATION, pos, ASCII_ENCODATION, 0); // end of segment is given by its length
+
+			if (pos == _end)
+				return;
+			for (int mode : {C40_ENCODATION, TEXT_ENCODATION, X12_ENCODATION, EDIFACT_ENCODATION})
+				relax(pos, ASCII_ENCODATION, pos, mode, 1);
+			if (_withBase256)
+				relax(pos, ASCII_ENCODATION, pos, BASE256_ENCODATION, 2); // latch and length field
+		}
+
+		void relaxEdges(int pos)
+		{
+			int c = charAt(pos);
+
+			// ASCII
+			if (pos + 1 < _end && IsDigit(c) && IsDigit(charAt(pos + 1)))
+				relax(pos, ASCII_ENCODATION, pos + 2, ASCII_ENCODATION, 1);
+			else
+				relax(pos, ASCII_ENCODATION, pos + 1, ASCII_ENCODATION, IsExtendedASCII(c) ? 2 : 1);
+
+			// C40 and Text: take as many characters as needed to fill whole triplets, at the end of the message a
+			// triplet with 2 values gets padded
+			for (int mode : {C40_ENCODATION, TEXT_ENCODATION}) {
+				int values = 0, to = pos;
+				while (to < _end && (values == 0 || values % 3 != 0))
+					values += C40ValueCount(charAt(to++), mode);
+				if (values % 3 == 0 || (to == _end && values % 3 == 2))
+					relax(pos, mode, to, mode, (values + 2) / 3 * 2);
+			}
+
+			// X12
+			if (allOf(pos, 3, IsNativeX12))
+				relax(pos, X12_ENCODATION, pos + 3, X12_ENCODATION, 2);
+
+			// EDIFACT: 4 values in 3 codewords or the last 0-3 values followed by the unlatch value
+			if (allOf(pos, 4, IsNativeEDIFACT))
+				relax(pos, EDIFACT_ENCODATION, pos + 4, EDIFACT_ENCODATION, 3);
+			for (int k = 1; k <= 3 && allOf(pos, k, IsNativeEDIFACT); ++k)
+				relax(pos, EDIFACT_ENCODATION, pos + k, ASCII_ENCODATION, std::min(k + 1, 3));
+
+			// Base256: a second length byte is needed for more than 249 characters
+			if (_withBase256) {
+				int length = node(pos, BASE256_ENCODATION).base256Length + 1;
+				if (length <= MAX_BASE256_LENGTH)
+					relax(pos, BASE256_ENCODATION, pos + 1, BASE256_ENCODATION, length == 250 ? 2 : 1, length);
+			}
+		}
+
+	public:
+		struct Step
+		{
+			int pos, mode;
+		};
+
+		Graph(const std::string& msg, int begin, int end, bool withBase256)
+			: _msg(msg), _begin(begin), _end(end), _withBase256(withBase256), _nodes((end - begin + 1) * MODE_COUNT)
+		{
+			node(begin, ASCII_ENCODATION).cost = 0;
+			for (int pos = begin; pos <= end; ++pos) {
+				relaxSwitches(pos);
+				if (pos < end)
+					relaxEdges(pos);
+			}
+		}
+
+		int cost(int pos, int mode) const { return _nodes[(pos - _begin) * MODE_COUNT + mode].cost; }
+
+		std::vector<Step> shortestPath(int pos, int mode) const
+		{
+			std::vector<Step> res;
+			for (int i = (pos - _begin) * MODE_COUNT + mode; i >= 0; i = _nodes[i].prev)
+				res.push_back({_begin + i / MODE_COUNT, i % MODE_COUNT});
+			std::reverse(res.begin(), res.end());
+			return res;
+		}
+	};
+
+	static void AddTriplets(ByteArray& codewords, std::string& values)
+	{
+		while (values.size() % 3)
+			values.push_back('\0'); // Shift 1 as padding, see C40Encoder::HandleEOD()
+		for (size_t i = 0; i < values.size(); i += 3) {
+			int v = (1600 * values[i]) + (40 * values[i + 1]) + values[i + 2] + 1;
+			codewords.push_back(narrow_cast<uint8_t>(v / 256));
+			codewords.push_back(narrow_cast<uint8_t>(v % 256));
+		}
+		values.clear();
+	}
+
+	static void AddBase256(ByteArray& codewords, std::string_view data)
+	{
+		std::string buffer;
+		int dataCount = Size(data);
+		if (dataCount <= 249) {
+			buffer.push_back((char)dataCount);
+		} else {
+			buffer.push_back((char)((dataCount / 250) + 249));
+			buffer.push_back((char)(dataCount % 250));
+		}
+		buffer.append(data);
+		for (char c : buffer) {
+			codewords.push_back(narrow_cast<uint8_t>(Base256Encoder::Randomize255State(c & 0xff, Size(codewords) + 1)));
+		}
+	}
+
+	static void AddASCII(ByteArray& codewords, const std::string& msg, int begin, int end)
+	{
+		for (int pos = begin; pos < end; ++pos) {
+			int c = msg[pos] & 0xff;
+			if (pos + 1 < end && IsDigit(c) && IsDigit(msg[pos + 1])) {
+				codewords.push_back(ASCIIEncoder::EncodeASCIIDigits(c, msg[++pos]));
+			} else if (IsExtendedASCII(c)) {
+				codewords.push_back(UPPER_SHIFT);
+				codewords.push_back(narrow_cast<uint8_t>(c - 128 + 1));
+			} else {
+				codewords.push_back(narrow_cast<uint8_t>(c + 1));
+			}
+		}
+	}
+
+	// A segment in another mode costs at least 1 latch codeword plus 2/3 (C40/Text/X12) or 3/4 (EDIFACT) codewords per
+	// value, ASCII at most 1 codeword per character. Plain ASCII is therefore strictly shorter than any other path if no
+	// segment can earn back its latch: less than 3 more native than shifted C40/Text characters and less than 3 X12 or
+	// 4 EDIFACT characters in a row.
+	static bool IsASCIIOptimal(const std::string& msg, int begin, int end)
+	{
+		int c40 = 0, text = 0, x12 = 0, edifact = 0;
+		for (int pos = begin; pos < end; ++pos) {
+			int c = msg[pos] & 0xff;
+			if (IsExtendedASCII(c))
+				return false;
+			c40 = std::max(0, c40 + (IsNativeC40(c) ? 1 : -1));
+			text = std::max(0, text + (IsNativeText(c) ? 1 : -1));
+			x12 = IsNativeX12(c) ? x12 + 1 : 0;
+			edifact = IsNativeEDIFACT(c) ? edifact + 1 : 0;
+			if (c40 >= 3 || text >= 3 || x12 >= 3 || edifact >= 4)
+				return false;
+		}
+		return true;
+	}
+
+	static int ASCIICodewordCount(const std::string& msg, int begin, int end)
+	{
+		ByteArray codewords;
+		AddASCII(codewords, msg, begin, end);
+		return Size(codewords);
+	}
+
+	/**
+	* Generate the codewords along the path. If the path does not end in ASCII mode, no unlatch is written.
+	*
+	* @param asciiTailStep  index of a step that ends an EDIFACT segment within the last 2 codewords of the symbol, where
+	*                       the decoder implicitly returns to ASCII: the remaining characters are ASCII encoded instead
+	* @return the codeword position of the last EDIFACT unlatch group or -1
+	*/
+	static int AddCodewords(ByteArray& codewords, const std::string& msg, const std::vector<Graph::Step>& path,
+							size_t asciiTailStep)
+	{
+		std::string values;
+		int edifactTail = -1;
+		for (size_t i = 1; i < path.size(); ++i) {
+			auto [from, fromMode] = path[i - 1];
+			auto [to, toMode] = path[i];
+
+			if (fromMode == toMode) {
+				switch (toMode) {
+				case ASCII_ENCODATION:
+					AddASCII(codewords, msg, from, to);
+					break;
+				case C40_ENCODATION:
+				case TEXT_ENCODATION:
+				case X12_ENCODATION:
+					for (int p = from; p < to; ++p) {
+						int c = msg[p] & 0xff;
+						if (toMode == C40_ENCODATION)
+							C40Encoder::EncodeChar(c, values);
+						else if (toMode == TEXT_ENCODATION)
+							DMTextEncoder::EncodeChar(c, values);
+						else
+							X12Encoder::EncodeChar(c, values);
+					}
+					AddTriplets(codewords, values);
+					break;
+				case EDIFACT_ENCODATION:
+					for (int p = from; p < to; ++p)
+						EdifactEncoder::EncodeChar(msg[p] & 0xff, values);
+					codewords.append(EdifactEncoder::EncodeToCodewords(values, 0));
+					values.clear();
+					break;
+				case BASE256_ENCODATION:
+					values.append(msg, from, to - from); // written at the end of the segment
+					break;
+				}
+				continue;
+			}
+
+			switch (fromMode) {
+			case ASCII_ENCODATION:
+				codewords.push_back(LATCHES[toMode]);
+				break;
+			case C40_ENCODATION:
+			case TEXT_ENCODATION:
+			case X12_ENCODATION:
+				codewords.push_back(C40_UNLATCH);
+				break;
+			case EDIFACT_ENCODATION:
+				// the last 0-3 characters of the segment are written together with the unlatch value
+				edifactTail = Size(codewords);
+				if (i == asciiTailStep) {
+					for (int p = from; p < to; ++p)
+						codewords.push_back(narrow_cast<uint8_t>((msg[p] & 0xff) + 1));
+				} else {
+					for (int p = from; p < to; ++p)
+						EdifactEncoder::EncodeChar(msg[p] & 0xff, values);
+					values.push_back(31); // Unlatch
+					codewords.append(EdifactEncoder::EncodeToCodewords(values, 0));
+					values.clear();
+				}
+				break;
+			case BASE256_ENCODATION:
+				AddBase256(codewords, values);
+				values.clear();
+				break;
+			}
+		}
+		return edifactTail;
+	}
+
+	static ByteArray Encode(const std::string& msg, int begin, int end, ByteArray codewords, SymbolShape shape,
+							int minWidth, int minHeight, int maxWidth, int maxHeight)
+	{
+		auto lookup = [&](int len) { return SymbolInfo::Lookup(len, shape, minWidth, minHeight, maxWidth, maxHeight); };
+		auto capacity = [&](int len) {
+			auto symbolInfo = lookup(len);
+			if (symbolInfo == nullptr) {
+				throw std::invalid_argument("Can't find a symbol arrangement that matches the message. Data codewords: " + std::to_string(len));
+			}
+			return symbolInfo->dataCapacity();
+		};
+
+		// reject oversized messages before building the graph, at best 2 digits fit into one codeword
+		if (int minLength = Size(codewords) + (end - begin + 1) / 2; minLength > MAX_CODEWORDS)
+			capacity(minLength);
+
+		// ASCII digit pairs are optimal for numeric data, plain ASCII for data without runs worth a latch
+		if (std::all_of(msg.begin() + begin, msg.begin() + end, IsDigit) || IsASCIIOptimal(msg, begin, end)) {
+			AddASCII(codewords, msg, begin, end);
+			AddPadding(codewords, capacity(Size(codewords)));
+			return codewords;
+		}
+
+		// Base256 can not beat ASCII without extended characters
+		bool withBase256 = std::any_of(msg.begin() + begin, msg.begin() + end, [](char c) { return IsExtendedASCII(c & 0xff); });
+		Graph graph(msg, begin, end, withBase256);
+		int offset = Size(codewords);
+
+		// By default the message ends in ASCII mode. Close to the end of the symbol the decoder returns to ASCII on
+		// its own, though: in C40/Text/X12 mode if only 1 codeword is left, in EDIFACT mode if less than 3 are left.
+		// Ending the message in one of those modes followed by a few ASCII codewords may therefore be shorter.
+		struct { int pos, mode, len; } best = {end, ASCII_ENCODATION, offset + graph.cost(end, ASCII_ENCODATION)};
+		for (int mode : {C40_ENCODATION, TEXT_ENCODATION, X12_ENCODATION, EDIFACT_ENCODATION}) {
+			int maxLeft = mode == EDIFACT_ENCODATION ? 2 : 1;
+			for (int pos = end; pos >= std::max(begin, end - 2 * maxLeft); --pos) {
+				int asciiCount = ASCIICodewordCount(msg, pos, end);
+				int len = offset + graph.cost(pos, mode);
+				if (asciiCount > maxLeft || len + asciiCount >= best.len)
+					continue;
+				if (auto symbolInfo = lookup(len + asciiCount); symbolInfo && symbolInfo->dataCapacity() - len <= maxLeft)
+					best = {pos, mode, len + asciiCount};
+			}
+		}
+
+		auto path = graph.shortestPath(best.pos, best.mode);
+		auto res = codewords;
+		int edifactTail = AddCodewords(res, msg, path, 0);
+		AddASCII(res, msg, best.pos, end);
+
+		// the decoder only reads EDIFACT groups if at least 3 codewords are left in the symbol
+		if (best.mode == ASCII_ENCODATION && edifactTail >= 0 && capacity(Size(res)) - edifactTail < 3) {
+			size_t asciiTailStep = path.size() - 1;
+			while (!(path[asciiTailStep - 1].mode == EDIFACT_ENCODATION && path[asciiTailStep].mode == ASCII_ENCODATION))
+				--asciiTailStep;
+			res = std::move(codewords);
+			AddCodewords(res, msg, path, asciiTailStep);
+		}
+
+		AddPadding(res, capacity(Size(res)));
+		return res;
+	}
+
+} // MinimalEncoder
+
 //TODO: c++20
 static bool StartsWith(std::wstring_view s, std::wstring_view ss)
 {
@@ -851,6 +1219,10 @@ static bool EndsWith(std::wstring_view s, std::wstring_view ss)
 	return s.length() > ss.length() && s.compare(s.length() - ss.length(), ss.length(), ss) == 0;
 }
 
+static constexpr std::wstring_view MACRO_05_HEADER = L"[)>\x1E""05\x1D";
+static constexpr std::wstring_view MACRO_06_HEADER = L"[)>\x1E""06\x1D";
+static constexpr std::wstring_view MACRO_TRAILER = L"\x1E\x04";
+
 ByteArray Encode(const std::wstring& msg)
 {
 	return Encode(msg, CharacterSet::ISO8859_1, SymbolShape::NONE, -1, -1, -1, -1);
@@ -883,10 +1255,6 @@ ByteArray Encode(const std::wstring& msg, CharacterSet charset, SymbolShape shap
 	context.setSymbolShape(shape);
 	context.setSizeConstraints(minWidth, minHeight, maxWidth, maxHeight);
 
-	constexpr std::wstring_view MACRO_05_HEADER = L"[)>\x1E""05\x1D";
-	constexpr std::wstring_view MACRO_06_HEADER = L"[)>\x1E""06\x1D";
-	constexpr std::wstring_view MACRO_TRAILER = L"\x1E\x04";
-
 	if (StartsWith(msg, MACRO_05_HEADER) && EndsWith(msg, MACRO_TRAILER)) {
 		context.addCodeword(MACRO_05);
 		context.setSkipAtEnd(2);
@@ -922,14 +1290,32 @@ ByteArray Encode(const std::wstring& msg, CharacterSet charset, SymbolShape shap
 		}
 	}
 	//Padding
-	if (context.codewordCount() < capacity) {
-		context.addCodeword(PAD);
+	ByteArray codewords = context.codewords();
+	AddPadding(codewords, capacity);
+	return codewords;
+}
+
+ByteArray EncodeMinimal(const std::wstring& msg, CharacterSet charset, SymbolShape shape, int minWidth, int minHeight,
+						int maxWidth, int maxHeight)
+{
+	if (charset == CharacterSet::Unknown) {
+		charset = CharacterSet::ISO8859_1;
 	}
-	while (context.codewordCount() < capacity) {
-		context.addCodeword(Randomize253State(PAD, context.codewordCount() + 1));
+
+	std::string bytes = TextEncoder::FromUnicode(msg, charset);
+	int begin = 0, end = Size(bytes);
+	ByteArray codewords;
+
+	for (auto [header, macro] : {std::pair{MACRO_05_HEADER, MACRO_05}, std::pair{MACRO_06_HEADER, MACRO_06}}) {
+		if (StartsWith(msg, header) && EndsWith(msg, MACRO_TRAILER)) {
+			codewords.push_back(macro);
+			begin = Size(header);
+			end -= Size(MACRO_TRAILER);
+			break;
+		}
 	}
 
-	return context.codewords();
+	return MinimalEncoder::Encode(bytes, begin, end, std::move(codewords), shape, minWidth, minHeight, maxWidth, maxHeight);
 }
 
 } // namespace ZXing::DataMatrix
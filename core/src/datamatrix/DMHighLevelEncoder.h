@@ -25,5 +25,12 @@ enum class SymbolShape;
 ByteArray Encode(const std::wstring& msg);
 ByteArray Encode(const std::wstring& msg, CharacterSet encoding, SymbolShape shape, int minWidth, int minHeight, int maxWidth, int maxHeight);
 
+/**
+* DataMatrix ECC 200 data encoder choosing the encodation modes such that the number of data codewords is minimal,
+* instead of following the look-ahead heuristic of annex S.
+*/
+ByteArray EncodeMinimal(const std::wstring& msg, CharacterSet encoding, SymbolShape shape, int minWidth, int minHeight,
+						int maxWidth, int maxHeight);
+
 } // DataMatrix
 } // ZXing
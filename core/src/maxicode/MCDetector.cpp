@@ -0,0 +1,488 @@
+/*
+* Copyright 2026 ZXing authors
+*/
+// SPDX-License-Identifier: Apache-2.0
+
+#include "MCDetector.h"
+
+#include "BitMatrix.h"
+#include "BitMatrixCursor.h"
+#include "ConcentricFinder.h"
+#include "DetectorResult.h"
+#include "MCBitMatrixParser.h"
+#include "Pattern.h"
+#include "PerspectiveTransform.h"
+#include "ZXAlgorithms.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <optional>
+#include <vector>
+
+namespace ZXing::MaxiCode {
+
+DetectorResult DetectPure(const BitMatrix& image)
+{
+	int left, top, width, height;
+	if (!image.findBoundingBox(left, top, width, height, BitMatrixParser::MATRIX_WIDTH))
+		return {};
+
+	// Now just read off the bits
+	BitMatrix bits(BitMatrixParser::MATRIX_WIDTH, BitMatrixParser::MATRIX_HEIGHT);
+	for (int y = 0; y < BitMatrixParser::MATRIX_HEIGHT; y++) {
+		int iy = top + (y * height + height / 2) / BitMatrixParser::MATRIX_HEIGHT;
+		for (int x = 0; x < BitMatrixParser::MATRIX_WIDTH; x++) {
+			int ix = left + (x * width + width / 2 + (y & 0x01) *  width / 2) / BitMatrixParser::MATRIX_WIDTH;
+			if (image.get(ix, iy)) {
+				bits.set(x, y);
+			}
+		}
+	}
+
+	int right  = left + width - 1;
+	int bottom = top + height - 1;
+
+	return {std::move(bits), {{left, top}, {right, top}, {right, bottom}, {left, bottom}}};
+}
+
+// The hexagonal module grid: odd rows are shifted right by half a module and the row pitch is sqrt(3)/2 of the column
+// pitch. The bullseye is centered on module (14, 16). All module space coordinates below are relative to that center in
+// units of the column pitch.
+constexpr double ROW_PITCH = 0.8660254037844386;
+constexpr int CENTER_X = 14;
+constexpr int CENTER_Y = 16;
+
+// Radius of the outer edge of the bullseye in module space. ISO/IEC 16023 specifies it only approximately and printers
+// differ slightly, the samples we have are between 4.42 and 4.53.
+constexpr double BULLSEYE_RADIUS = 4.48;
+
+static PointF ModuleCenter(int x, int y)
+{
+	return {x + 0.5 * (y & 1) - CENTER_X, (y - CENTER_Y) * ROW_PITCH};
+}
+
+// The 3 orientation modules in each of the 6 clusters around the bullseye (ISO/IEC 16023:2000 Figure 5), one cluster is
+// all black, one all white, the other 4 have a single white module.
+struct OrientationModule
+{
+	int x, y;
+	bool black;
+};
+
+constexpr OrientationModule ORIENTATION_MODULES[] = {
+	{10, 9, true}, {11, 9, true}, {11, 10, true},     // top left
+	{17, 9, false}, {17, 10, false}, {18, 10, false}, // top right
+	{7, 15, true}, {7, 16, false}, {8, 16, true},     // left
+	{20, 16, true}, {21, 16, false}, {20, 17, true},  // right
+	{10, 22, true}, {11, 22, false}, {10, 23, true},  // bottom left
+	{17, 22, true}, {16, 23, false}, {17, 23, true},  // bottom right
+};
+
+static bool IsBullseyePattern(const PatternView& view)
+{
+	// The 5 rings on either side of the white center all have (about) the same width, so all black/white pairs have to
+	// be close together. The outer black ring may touch neighboring modules, so it is not part of the comparison.
+	auto m = view[1] + view[2];
+	auto M = m;
+	for (int i : {2, 3, 6, 7, 8}) {
+		int v = view[i] + view[i + 1];
+		UpdateMinMax(m, M, v);
+		if (M > m * 3 / 2 + 1)
+			return false;
+	}
+	// depending on the printer, the center is between about 1 and 4 times as wide as a ring
+	int rings = view.sum() - view[0] - view[5] - view[10];
+	return view[0] * 8 * 2 >= rings && view[10] * 8 * 2 >= rings && view[5] * 8 * 3 >= rings * 2 && view[5] * 8 <= rings * 5;
+}
+
+static int CheckSymmetricBullseyePattern(BitMatrixCursorI& cur, int range, bool updatePosition)
+{
+	range *= 2; // tilted symbols may have a larger vertical than horizontal range
+
+	FastEdgeToEdgeCounter curFwd(cur), curBwd(cur.turnedBack());
+
+	int centerFwd = curFwd.stepToNextEdge(range / 3);
+	if (!centerFwd)
+		return 0;
+	int centerBwd = curBwd.stepToNextEdge(range / 3);
+	if (!centerBwd)
+		return 0;
+	int center = centerFwd + centerBwd - 1; // -1 because the starting pixel is counted twice
+
+	int spread = center;
+	int m = 0;
+	int M = 0;
+	int rings = 0;
+	for (auto c : {&curFwd, &curBwd}) {
+		int lastS = 0;
+		for (int i = 0; i < 4; ++i) {
+			int s = c->stepToNextEdge(range - spread);
+			if (s == 0)
+				return 0;
+			spread += s;
+			rings += s;
+			if (lastS) {
+				int v = s + lastS;
+				if (m == 0)
+					m = M = v;
+				else
+					UpdateMinMax(m, M, v);
+				if (M > m * 3 / 2 + 1)
+					return 0;
+			}
+			lastS = s;
+		}
+		// the outer black ring may touch neighboring modules (see IsBullseyePattern)
+		int s = c->stepToNextEdge(range - spread);
+		if (s * 8 * 2 < m * 4)
+			return 0;
+		spread += s;
+	}
+
+	if (center * 8 * 3 < rings * 2 || center * 8 > rings * 5)
+		return 0;
+
+	if (updatePosition)
+		cur.step((centerFwd - centerBwd) / 2);
+
+	return spread;
+}
+
+static std::optional<ConcentricPattern> LocateBullseye(const BitMatrix& image, PointF center, int spreadH)
+{
+	auto cur = BitMatrixCursor(image, PointI(center), {});
+	int minSpread = spreadH, maxSpread = 0;
+	for (auto d : {PointI{0, 1}, {1, 0}, {1, 1}, {1, -1}}) {
+		int spread = CheckSymmetricBullseyePattern(cur.setDirection(d), spreadH, d.x == 0 || d.y == 0);
+		if (!spread)
+			return {};
+		UpdateMinMax(minSpread, maxSpread, spread);
+	}
+
+	// average the centers of the inner 4 ring edges
+	PointF sum = {};
+	int n = 0;
+	for (int i = 1; i <= 4; ++i)
+		if (auto c = CenterOfRing(image, cur.p, maxSpread, i); c && distance(*c, centered(cur.p)) < minSpread / 10.) {
+			sum += *c;
+			++n;
+		}
+
+	return ConcentricPattern{n ? sum / n : centered(cur.p), (maxSpread + minSpread) / 2};
+}
+
+static std::vector<ConcentricPattern> FindBullseyes(const BitMatrix& image, bool tryHarder)
+{
+	std::vector<ConcentricPattern> res;
+
+	int skip = tryHarder ? 1 : std::clamp(image.height() / 2 / 100, 1, 5);
+	int margin = 5;
+
+	PatternRow row;
+	for (int y = margin; y < image.height() - margin; y += skip) {
+		GetPatternRow(image, y, row, false);
+		// the pattern we are looking for starts with the outer black ring and is 11 wide
+		for (auto window = PatternView(row).subView(0, 11); window.isValid(); window.skipPair()) {
+			if (!IsBullseyePattern(window))
+				continue;
+
+			PointF p(window.pixelsInFront() + window.sum(5) + window[5] / 2.0, y + 0.5);
+
+			// make sure p is not 'inside' an already found pattern area
+			if (FindIf(res, [p](const auto& old) { return distance(p, old) < old.size / 2; }) != res.end())
+				continue;
+
+			if (auto pattern = LocateBullseye(image, p, window.sum()))
+				if (FindIf(res, [&](const auto& old) { return distance(*pattern, old) < old.size / 2; }) == res.end())
+					res.push_back(*pattern);
+		}
+	}
+
+	return res;
+}
+
+// The affine map from module space to the image, i.e. p = center + x * ex + y * ey
+struct ModuleToPixel
+{
+	PointF center, ex, ey;
+	PointF operator()(PointF m) const { return center + m.x * ex + m.y * ey; }
+};
+
+/**
+* Fit an ellipse to the outer edge of the bullseye. Returns the map from the unit circle to that ellipse, leaving the
+* rotation undetermined.
+*/
+static std::optional<ModuleToPixel> FitBullseyeEllipse(const BitMatrix& image, const ConcentricPattern& bullseye)
+{
+	constexpr int N = 32;
+	constexpr double PI = 3.14159265358979323846;
+
+	// the outer edge may be touched by neighboring black modules, so also measure the width of the outer ring to be
+	// able to discard those samples
+	std::array<PointF, N> edges;
+	std::array<int, N> widths;
+	int n = 0;
+	for (int i = 0; i < N; ++i) {
+		BitMatrixCursorF cur(image, bullseye, {std::cos(2 * PI * i / N), std::sin(2 * PI * i / N)});
+		int inner = cur.stepToEdge(5, bullseye.size);
+		int width = inner ? cur.stepToEdge(1, bullseye.size) : 0;
+		if (!width)
+			continue;
+		edges[n] = (inner + width - 0.5) * cur.d; // the cursor stops on the first pixel behind the edge
+		widths[n++] = width;
+	}
+	if (n < N / 2)
+		return {};
+
+	auto sorted = widths;
+	std::nth_element(sorted.begin(), sorted.begin() + n / 2, sorted.begin() + n);
+	int maxWidth = sorted[n / 2] * 3 / 2 + 1;
+
+	// least squares fit of a * x^2 + 2 * b * x * y + c * y^2 = 1
+	double s[3][3] = {}, r[3] = {};
+	int used = 0;
+	for (int i = 0; i < n; ++i) {
+		if (widths[i] > maxWidth)
+			continue;
+		double f[3] = {edges[i].x * edges[i].x, 2 * edges[i].x * edges[i].y, edges[i].y * edges[i].y};
+		for (int j = 0; j < 3; ++j) {
+			for (int k = 0; k < 3; ++k)
+				s[j][k] += f[j] * f[k];
+			r[j] += f[j];
+		}
+		++used;
+	}
+	if (used < N / 2)
+		return {};
+
+	auto det3 = [](double a[3][3]) {
+		return a[0][0] * (a[1][1] * a[2][2] - a[1][2] * a[2][1]) - a[0][1] * (a[1][0] * a[2][2] - a[1][2] * a[2][0])
+			   + a[0][2] * (a[1][0] * a[2][1] - a[1][1] * a[2][0]);
+	};
+	double det = det3(s);
+	if (det == 0)
+		return {};
+	double abc[3];
+	for (int j = 0; j < 3; ++j) { // Cramer's rule
+		double t[3][3];
+		for (int k = 0; k < 3; ++k)
+			for (int l = 0; l < 3; ++l)
+				t[k][l] = l == j ? r[k] : s[k][l];
+		abc[j] = det3(t) / det;
+	}
+	auto [a, b, c] = abc;
+	if (a <= 0 || a * c - b * b <= 0)
+		return {};
+
+	// the map from the unit circle to the ellipse is the inverse square root of the matrix [a b; b c]
+	double root = std::sqrt((a - c) * (a - c) / 4 + b * b);
+	double l1 = (a + c) / 2 + root, l2 = (a + c) / 2 - root;
+	double angle = std::atan2(l1 - a, b);
+	if (b == 0)
+		angle = a >= c ? 0 : PI / 2;
+	double co = std::cos(angle), si = std::sin(angle), s1 = 1 / std::sqrt(l1), s2 = 1 / std::sqrt(l2);
+	double m01 = (s1 - s2) * co * si;
+
+	return ModuleToPixel{bullseye, {s1 * co * co + s2 * si * si, m01}, {m01, s1 * si * si + s2 * co * co}};
+}
+
+static ModuleToPixel Rotated(const ModuleToPixel& m, double angle, double scale)
+{
+	double co = std::cos(angle) * scale, si = std::sin(angle) * scale;
+	return {m.center, co * m.ex + si * m.ey, co * m.ey - si * m.ex};
+}
+
+/**
+* Find the rotation of the module space around the bullseye that best matches the 18 orientation modules. Returns the
+* middle of the range of the best matching angles.
+*/
+static std::optional<double> FindRotation(const BitMatrix& image, const ModuleToPixel& ellipse)
+{
+	constexpr int N = 360;
+	constexpr double PI = 3.14159265358979323846;
+
+	std::array<int, N> scores = {};
+	for (int i = 0; i < N; ++i) {
+		auto mod2Pix = Rotated(ellipse, 2 * PI * i / N, 1 / BULLSEYE_RADIUS);
+		for (auto [x, y, black] : ORIENTATION_MODULES) {
+			auto p = mod2Pix(ModuleCenter(x, y));
+			scores[i] += image.isIn(p) && image.get(p) == black;
+		}
+	}
+
+	int best = *std::max_element(scores.begin(), scores.end());
+	if (best < Size(ORIENTATION_MODULES) - 2)
+		return {};
+
+	// find the start of a range of best scores and its length (wrapping around)
+	int start = 0;
+	while (start < N && !(scores[start] == best && scores[(start + N - 1) % N] != best))
+		++start;
+	if (start == N)
+		return {};
+	int length = 1;
+	while (length < N && scores[(start + length) % N] == best)
+		++length;
+
+	return 2 * PI * (start + (length - 1) / 2.0) / N;
+}
+
+// an arbitrary square in module space used to define a PerspectiveTransform via the image of its corners
+static const QuadrilateralF MODULE_SPACE_SQUARE = {PointF{-10, -10}, {10, -10}, {10, 10}, {-10, 10}};
+
+static PerspectiveTransform ToPerspectiveTransform(const ModuleToPixel& mod2Pix)
+{
+	return {MODULE_SPACE_SQUARE, {mod2Pix(MODULE_SPACE_SQUARE[0]), mod2Pix(MODULE_SPACE_SQUARE[1]),
+								  mod2Pix(MODULE_SPACE_SQUARE[2]), mod2Pix(MODULE_SPACE_SQUARE[3])}};
+}
+
+/**
+* Least squares fit of the perspective transform that maps the module space points src onto the image points dst. The
+* image points are normalized by origin and scale to keep the equation system well conditioned.
+*/
+static PerspectiveTransform FitPerspectiveTransform(const std::vector<PointF>& src, const std::vector<PointF>& dst, PointF origin,
+													double scale)
+{
+	// x' = (h0 * x + h1 * y + h2) / (h6 * x + h7 * y + 1), y' = (h3 * x + h4 * y + h5) / (h6 * x + h7 * y + 1)
+	double a[8][9] = {}; // normal equations, right hand side in the last column
+	for (int i = 0; i < Size(src); ++i) {
+		auto [x, y] = src[i];
+		auto [u, v] = (dst[i] - origin) / scale;
+		double rows[2][9] = {{x, y, 1, 0, 0, 0, -x * u, -y * u, u}, {0, 0, 0, x, y, 1, -x * v, -y * v, v}};
+		for (auto& r : rows)
+			for (int j = 0; j < 8; ++j)
+				for (int k = 0; k < 9; ++k)
+					a[j][k] += r[j] * r[k];
+	}
+
+	// Gauss-Jordan elimination with partial pivoting
+	for (int c = 0; c < 8; ++c) {
+		int pivot = c;
+		for (int r = c + 1; r < 8; ++r)
+			if (std::abs(a[r][c]) > std::abs(a[pivot][c]))
+				pivot = r;
+		if (std::abs(a[pivot][c]) < 1e-9)
+			return {};
+		std::swap(a[c], a[pivot]);
+		for (int r = 0; r < 8; ++r)
+			if (r != c) {
+				double f = a[r][c] / a[c][c];
+				for (int k = c; k < 9; ++k)
+					a[r][k] -= f * a[c][k];
+			}
+	}
+	double h[8];
+	for (int j = 0; j < 8; ++j)
+		h[j] = a[j][8] / a[j][j];
+
+	auto project = [&](PointF p) {
+		double w = h[6] * p.x + h[7] * p.y + 1;
+		return origin + scale * PointF((h[0] * p.x + h[1] * p.y + h[2]) / w, (h[3] * p.x + h[4] * p.y + h[5]) / w);
+	};
+	return {MODULE_SPACE_SQUARE, {project(MODULE_SPACE_SQUARE[0]), project(MODULE_SPACE_SQUARE[1]),
+								  project(MODULE_SPACE_SQUARE[2]), project(MODULE_SPACE_SQUARE[3])}};
+}
+
+static std::optional<PointF> CenterOfBlackPixels(const BitMatrix& image, PointF p, int radius)
+{
+	PointF sum = {};
+	int n = 0;
+	for (int y = int(p.y) - radius; y <= int(p.y) + radius; ++y)
+		for (int x = int(p.x) - radius; x <= int(p.x) + radius; ++x)
+			if (image.isIn(PointI{x, y}) && image.get(x, y)) {
+				sum += centered(PointI{x, y});
+				++n;
+			}
+
+	if (n * 4 < (2 * radius + 1) * (2 * radius + 1))
+		return {};
+
+	return sum / n;
+}
+
+/**
+* Refine the mapping from module space into the image by matching it with the actual positions of the black modules.
+* The considered area grows from the bullseye outwards, which allows to correct for errors in the initial estimate of the
+* scale and rotation as well as for perspective distortion.
+*/
+static PerspectiveTransform RefineModuleGrid(const BitMatrix& image, PerspectiveTransform mod2Pix, PointF center, double pitch)
+{
+	int radius = std::max(1, static_cast<int>(pitch * 0.4));
+	std::vector<PointF> src, dst;
+	for (double maxDist : {8.0, 12.0, 16.0, 24.0}) {
+		src.clear();
+		dst.clear();
+		for (int y = 0; y < BitMatrixParser::MATRIX_HEIGHT; ++y)
+			for (int x = 0; x < BitMatrixParser::MATRIX_WIDTH; ++x) {
+				auto m = ModuleCenter(x, y);
+				// the area around the bullseye up to a radius of about 5.3 contains no modules
+				if (auto d = length(m); d > maxDist || d < 5.5)
+					continue;
+				auto p = mod2Pix(m);
+				if (!image.isIn(p) || !image.get(p))
+					continue;
+				if (auto c = CenterOfBlackPixels(image, p, radius)) {
+					src.push_back(m);
+					dst.push_back(*c);
+				}
+			}
+
+		if (Size(src) < 16)
+			break;
+		auto refined = FitPerspectiveTransform(src, dst, center, pitch);
+		if (!refined.isValid())
+			break;
+		mod2Pix = refined;
+	}
+	return mod2Pix;
+}
+
+static DetectorResult SampleHexGrid(const BitMatrix& image, const PerspectiveTransform& mod2Pix)
+{
+	constexpr int W = BitMatrixParser::MATRIX_WIDTH;
+	constexpr int H = BitMatrixParser::MATRIX_HEIGHT;
+
+	// map the grid coordinates (in units of the column and row pitch, relative to the top left) into the image
+	auto grid2Pix = [&](double x, double y) { return mod2Pix({x - CENTER_X - 0.5, (y - CENTER_Y - 0.5) * ROW_PITCH}); };
+	QuadrilateralF position = {grid2Pix(0, 0), grid2Pix(W, 0), grid2Pix(W, H), grid2Pix(0, H)};
+
+	BitMatrix bits(W, H);
+	for (int y = 0; y < H; ++y)
+		for (int x = 0; x < W; ++x) {
+			auto p = mod2Pix(ModuleCenter(x, y));
+			if (!image.isIn(p))
+				return {};
+			if (image.get(p))
+				bits.set(x, y);
+		}
+
+	return {std::move(bits), {PointI(position[0]), PointI(position[1]), PointI(position[2]), PointI(position[3])}};
+}
+
+DetectorResults Detect(const BitMatrix& image, bool tryHarder)
+{
+	DetectorResults res;
+	for (const auto& bullseye : FindBullseyes(image, tryHarder)) {
+		auto ellipse = FitBullseyeEllipse(image, bullseye);
+		if (!ellipse)
+			continue;
+		auto angle = FindRotation(image, *ellipse);
+		if (!angle)
+			continue;
+
+		auto mod2Pix = Rotated(*ellipse, *angle, 1 / BULLSEYE_RADIUS);
+		auto pitch = std::sqrt(std::abs(cross(mod2Pix.ex, mod2Pix.ey)));
+		auto refined = RefineModuleGrid(image, ToPerspectiveTransform(mod2Pix), bullseye, pitch);
+
+		for (const auto& t : {refined, ToPerspectiveTransform(mod2Pix)}) {
+			auto detRes = SampleHexGrid(image, t);
+			if (detRes.isValid())
+				res.push_back(std::move(detRes));
+		}
+	}
+
+	return res;
+}
+
+} // namespace ZXing::MaxiCode
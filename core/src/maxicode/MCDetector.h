@@ -0,0 +1,36 @@
+/*
+* Copyright 2026 ZXing authors
+*/
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <vector>
+
+namespace ZXing {
+
+class BitMatrix;
+class DetectorResult;
+
+namespace MaxiCode {
+
+/**
+* Sample a "pure" image -- that is, pure monochrome image which contains only an unrotated, unskewed, image of a
+* symbol, with some white border around it. This is a specialized method that works exceptionally fast in this special
+* case.
+*/
+DetectorResult DetectPure(const BitMatrix& image);
+
+using DetectorResults = std::vector<DetectorResult>;
+
+/**
+* Locate MaxiCode symbols by their bullseye finder pattern and sample the hexagonal module grid around it.
+*
+* The scale and rotation are derived from the bullseye and the orientation modules surrounding it. As these estimates
+* are not exact for photographed symbols, a few slightly different samplings are returned per symbol, the most likely
+* one first. The caller is supposed to decode them in order until one succeeds.
+*/
+DetectorResults Detect(const BitMatrix& image, bool tryHarder);
+
+} // MaxiCode
+} // ZXing
@@ -12,6 +12,7 @@
 #include <array>
 #include <cstdint>
 #include <limits>
+#include <vector>
 
 namespace ZXing {
 namespace Pdf417 {
@@ -503,8 +504,7 @@ static int GetClosestDecodedValue(const ModuleBitCountType& moduleBitCount)
 	return bestMatch;
 }
 
-int
-CodewordDecoder::GetDecodedValue(const std::array<int, BARS_IN_MODULE>& moduleBitCount)
+static int GetDecodedValueUncached(const ModuleBitCountType& moduleBitCount)
 {
 	int decodedValue = GetDecodedCodewordValue(SampleBitCounts(moduleBitCount));
 	if (decodedValue != -1) {
@@ -513,6 +513,35 @@ CodewordDecoder::GetDecodedValue(const std::array<int, BARS_IN_MODULE>& moduleBi
 	return GetClosestDecodedValue(moduleBitCount);
 }
 
+int
+CodewordDecoder::GetDecodedValue(const std::array<int, BARS_IN_MODULE>& moduleBitCount)
+{
+	// The codewords of one symbol are sampled many times with the same pixel widths, so the result for each module
+	// bit count is remembered in a small direct mapped cache. The 8 bar widths are packed into a 64-bit key.
+	// The cache has to persist between calls and must not be shared between threads, hence plain thread_local
+	// instead of ZX_THREAD_LOCAL, which may be configured as nothing or static.
+	struct CacheEntry
+	{
+		uint64_t key = 0;
+		int value = -1;
+	};
+	thread_local std::array<CacheEntry, 1024> cache = {};
+
+	uint64_t key = 0;
+	for (int width : moduleBitCount) {
+		if (width < 0 || width > 0xFF)
+			return GetDecodedValueUncached(moduleBitCount);
+		key = (key << 8) | width;
+	}
+	if (key == 0)
+		return GetDecodedValueUncached(moduleBitCount);
+
+	auto& entry = cache[(key * 0x9E3779B97F4A7C15ull) >> 54];
+	if (entry.key != key)
+		entry = {key, GetDecodedValueUncached(moduleBitCount)};
+	return entry.value;
+}
+
 /**
 * @param symbol encoded symbol to translate to a codeword
 * @return the codeword corresponding to the symbol.
@@ -522,12 +551,16 @@ CodewordDecoder::GetCodeword(int symbol)
 {
 	if ((symbol & 0xFFFF0000) != 0x10000)
 		return -1;
-	symbol &= 0xFFFF;
-	auto it = std::lower_bound(SYMBOL_TABLE.begin(), SYMBOL_TABLE.end(), symbol);
-	if (it != SYMBOL_TABLE.end() && *it == symbol) {
-		return (CODEWORD_TABLE[it - SYMBOL_TABLE.begin()] - 1) % NUMBER_OF_CODEWORDS;
-	}
-	return -1;
+
+	// all symbols start with a 1-bit, so the lower 16 bits are a perfect hash into a direct lookup table (128kB on heap)
+	static const auto codewordTable = []() {
+		auto table = std::vector<int16_t>(0x10000, -1);
+		for (int i = 0; i < SYMBOL_COUNT; i++)
+			table[SYMBOL_TABLE[i]] = (CODEWORD_TABLE[i] - 1) % NUMBER_OF_CODEWORDS;
+		return table;
+	}();
+
+	return codewordTable[symbol & 0xFFFF];
 }
 
 } // Pdf417
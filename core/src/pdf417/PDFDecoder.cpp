@@ -632,6 +632,8 @@ DecoderResult Decode(const std::vector<int>& codewords)
 {
 	Content result;
 	result.symbology = {'L', '2', char(-1)};
+	// numeric compaction is the densest mode with 44 digits per 15 code words
+	result.reserve(3 * Size(codewords));
 
 	bool readerInit = false;
 	auto customData = std::make_shared<PDF417CustomData>();
@@ -95,6 +95,14 @@ public:
 		_matrix[y].set(x, value);
 	}
 
+	int rows() const {
+		return Size(_matrix);
+	}
+
+	int columns() const { // number of data columns
+		return _width / 17;
+	}
+
 	void startRow() {
 		++_currentRow;
 	}
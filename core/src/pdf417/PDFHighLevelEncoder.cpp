@@ -10,13 +10,16 @@
 #include "CharacterSet.h"
 #include "ECI.h"
 #include "TextEncoder.h"
-#include "ZXBigInteger.h"
 #include "ZXAlgorithms.h"
 
-#include <cstdint>
 #include <algorithm>
-#include <string>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <limits>
 #include <stdexcept>
+#include <string>
 
 namespace ZXing {
 namespace Pdf417 {
@@ -195,11 +198,6 @@ static bool IsPunctuation(int ch)
 	return (ch & 0x7f) == ch && PUNCTUATION[ch] != -1;
 }
 
-static bool IsText(int ch)
-{
-	return ch == '\t' || ch == '\n' || ch == '\r' || (ch >= 32 && ch <= 126);
-}
-
 
 /**
 * Encode parts of the message using Text Compaction as described in ISO/IEC 15438:2001(E),
@@ -362,131 +360,357 @@ static void EncodeBinary(const std::string& bytes, int startpos, int count, int
 }
 
 
+/**
+* Encode parts of the message using Numeric Compaction as described in ISO/IEC 15438:2001(E),
+* chapter 4.4.4. Each group of up to 44 digits is prefixed with a '1' and converted to base 900.
+*
+* The number of up to 45 decimal digits is kept in fixed-width base 10^9 limbs, so that every
+* step of the long division by 900 fits into 64 bits.
+*/
 static void EncodeNumeric(const std::wstring& msg, int startpos, int count, std::vector<int>& output)
 {
-	int idx = 0;
-	std::vector<int> tmp;
-	tmp.reserve(count / 3 + 1);
-	BigInteger num900(900);
-	while (idx < count) {
-		tmp.clear();
+	constexpr uint64_t LIMB_BASE = 1000000000;
+	for (int idx = 0; idx < count;) {
 		int len = std::min(44, count - idx);
-		auto part = L"1" + msg.substr(startpos + idx, len);
+		int digits = len + 1;
+		int numLimbs = (digits + 8) / 9;
+		int offset = numLimbs * 9 - digits;
+		std::array<uint64_t, 5> limbs = {}; // most significant first
+		for (int i = 0; i < digits; ++i) {
+			auto& limb = limbs[(i + offset) / 9];
+			limb = limb * 10 + (i == 0 ? 1 : msg[startpos + idx + i - 1] - '0');
+		}
 
-		BigInteger bigint, r;
-		BigInteger::TryParse(part, bigint);
-		do {
-			BigInteger::Divide(bigint, num900, bigint, r);
-			tmp.push_back(r.toInt());
-		} while (!bigint.isZero());
+		std::array<int, 15> tmp;
+		int n = 0;
+		for (int first = 0; first < numLimbs;) {
+			uint64_t rem = 0;
+			for (int i = first; i < numLimbs; ++i) {
+				uint64_t cur = rem * LIMB_BASE + limbs[i];
+				limbs[i] = cur / 900;
+				rem = cur % 900;
+			}
+			tmp[n++] = static_cast<int>(rem);
+			while (first < numLimbs && limbs[first] == 0)
+				++first;
+		}
 
-		//Reverse temporary string
-		output.insert(output.end(), tmp.rbegin(), tmp.rend());
+		output.insert(output.end(), std::make_reverse_iterator(tmp.begin() + n), tmp.rend());
 		idx += len;
 	}
 }
 
-
 /**
-* Determines the number of consecutive characters that are encodable using numeric compaction.
+* Finds the sequence of compaction modes and Text Compaction sub-modes that encodes the message in
+* the smallest number of codewords, instead of switching modes based on the fixed look-ahead rules
+* of annex P.
 *
-* @param msg      the message
-* @param startpos the start position within the message
-* @return the requested character count
+* This is a shortest path search over the positions in the message, the nodes being the states the
+* encoder can be in after encoding the characters up to that position: a Text Compaction sub-mode
+* (together with the parity of the number of text values so far, as two of them make a codeword),
+* the number of bytes in the last incomplete group of six in Byte Compaction, or the number of
+* digits in the current group of 44 in Numeric Compaction. Costs are counted in half codewords.
 */
-static int DetermineConsecutiveDigitCount(const std::wstring& msg, int startpos)
+class CompactionPlanner
 {
-	int count = 0;
-	size_t len = msg.length();
-	size_t idx = startpos;
-	if (idx < len) {
-		int ch = msg[idx];
-		while (IsDigit(ch) && idx < len) {
-			count++;
-			idx++;
-			if (idx < len) {
-				ch = msg[idx];
-			}
+	enum StepKind : uint8_t { LATCH, CHAR, SHIFT_BYTE };
+
+	static constexpr int BYTE_STATE = 8; // 4 sub-modes x 2 parities before, number of bytes modulo 6 after
+	static constexpr int NUMERIC_STATE = BYTE_STATE + 6; // + number of digits in the current group (0..44)
+	static constexpr int NUM_STATES = NUMERIC_STATE + 45;
+	static constexpr int INF = std::numeric_limits<int>::max() / 2;
+
+	// Text Compaction values to switch from one sub-mode to another (-1 terminated)
+	static constexpr int8_t LATCHES[4][4][3] = {
+		{{-1}, {27, -1}, {28, -1}, {28, 25, -1}},     // from ALPHA
+		{{28, 28, -1}, {-1}, {28, -1}, {28, 25, -1}}, // from LOWER
+		{{28, -1}, {27, -1}, {-1}, {25, -1}},         // from MIXED
+		{{29, -1}, {29, 27, -1}, {29, 28, -1}, {-1}}, // from PUNCTUATION
+	};
+	static constexpr int8_t LATCH_LENGTHS[4][4] = {{0, 1, 1, 2}, {2, 0, 1, 2}, {1, 1, 0, 1}, {1, 2, 2, 0}};
+	// Text Compaction value to shift from one sub-mode to another for a single character (-1 if not possible)
+	static constexpr int8_t SHIFTS[4][4] = {{-1, -1, -1, 29}, {27, -1, -1, 29}, {-1, -1, -1, 29}, {-1, -1, -1, -1}};
+
+	static constexpr int TextState(int submode, int parity) { return submode * 2 + parity; }
+	static constexpr bool IsTextState(int state) { return state < BYTE_STATE; }
+	static constexpr bool IsByteState(int state) { return state >= BYTE_STATE && state < NUMERIC_STATE; }
+
+	const std::wstring& _msg;
+	std::vector<std::string> _bytes; // encoding of the character starting at each position (empty inside surrogate pairs)
+	std::vector<uint8_t> _links;     // for each position and state: predecessor state << 2 | StepKind
+
+	// Value of ch in the given Text Compaction sub-mode or -1 if it is not available there
+	static int TextValue(int submode, int ch)
+	{
+		switch (submode) {
+		case SUBMODE_ALPHA: return ch == ' ' ? 26 : ch >= 'A' && ch <= 'Z' ? ch - 'A' : -1;
+		case SUBMODE_LOWER: return ch == ' ' ? 26 : ch >= 'a' && ch <= 'z' ? ch - 'a' : -1;
+		case SUBMODE_MIXED: return IsMixed(ch) ? MIXED[ch] : -1;
+		default: return IsPunctuation(ch) ? PUNCTUATION[ch] : -1;
 		}
 	}
-	return count;
-}
 
-/**
-* Determines the number of consecutive characters that are encodable using text compaction.
-*
-* @param msg      the message
-* @param startpos the start position within the message
-* @return the requested character count
-*/
-static int DetermineConsecutiveTextCount(const std::wstring& msg, int startpos)
-{
-	size_t len = msg.length();
-	size_t idx = startpos;
-	while (idx < len) {
-		int ch = msg[idx];
-		int numericCount = 0;
-		while (numericCount < 13 && IsDigit(ch) && idx < len) {
-			numericCount++;
-			idx++;
-			if (idx < len) {
-				ch = msg[idx];
+	struct NumericCosts
+	{
+		// additional half codewords for the next digit, given the number of digits in the current group
+		std::array<int, 45> deltas;
+		// maximum additional cost state g1 can have over state g2 for any number of following digits. If
+		// cost(g1) + dominance[g1][g2] <= cost(g2), state g2 does not need to be considered any further.
+		std::array<std::array<int, 45>, 45> dominance;
+	};
+
+	static const NumericCosts& NumericCompactionCosts()
+	{
+		static const auto costs = [] {
+			auto codewords = [](int digits) { return digits ? static_cast<int>(digits / std::log10(900.0)) + 1 : 0; };
+			NumericCosts res;
+			for (int g = 0; g < 44; ++g)
+				res.deltas[g] = 2 * (codewords(g + 1) - codewords(g));
+			res.deltas[44] = 2 * codewords(1); // the group is full, start a new one
+			for (int g1 = 0; g1 <= 44; ++g1)
+				for (int g2 = 0; g2 <= 44; ++g2) {
+					int diff = 0, max = 0;
+					for (int k = 0, s1 = g1, s2 = g2; k < 2 * 44; ++k) {
+						diff += res.deltas[s1] - res.deltas[s2];
+						max = std::max(max, diff);
+						s1 = s1 == 44 ? 1 : s1 + 1;
+						s2 = s2 == 44 ? 1 : s2 + 1;
+					}
+					res.dominance[g1][g2] = max;
+				}
+			return res;
+		}();
+		return costs;
+	}
+
+	int prevPos(int pos, StepKind kind) const
+	{
+		if (kind == LATCH)
+			return pos;
+		return pos >= 2 && _bytes[pos - 1].empty() ? pos - 2 : pos - 1;
+	}
+
+public:
+	CompactionPlanner(const std::wstring& msg, CharacterSet encoding) : _msg(msg), _bytes(msg.size())
+	{
+		int len = Size(msg);
+		std::array<std::string, 128> ascii; // cache for the common case
+		for (int i = 0; i < len;) {
+			int n = (msg[i] & 0xfc00) == 0xd800 && i + 1 < len && (msg[i + 1] & 0xfc00) == 0xdc00 ? 2 : 1;
+			if (msg[i] < 128) {
+				auto& bytes = ascii[msg[i]];
+				if (bytes.empty())
+					bytes = TextEncoder::FromUnicode(msg.substr(i, 1), encoding);
+				_bytes[i] = bytes;
+			} else {
+				_bytes[i] = TextEncoder::FromUnicode(msg.substr(i, n), encoding);
 			}
+			i += n;
 		}
-		if (numericCount >= 13) {
-			return static_cast<int>(idx - startpos - numericCount);
-		}
-		if (numericCount > 0) {
-			//Heuristic: All text-encodable chars or digits are binary encodable
-			continue;
-		}
-		ch = msg[idx];
 
-		//Check if character is encodable
-		if (!IsText(ch)) {
-			break;
+		// Costs in half codewords, only the rows for the current position and the (at most) two following ones are kept.
+		_links.resize((len + 1) * NUM_STATES);
+		std::array<std::array<int, NUM_STATES>, 3> rows;
+		for (auto& row : rows)
+			row.fill(INF);
+		rows[0][TextState(SUBMODE_ALPHA, 0)] = 0;
+		const auto& numeric = NumericCompactionCosts();
+		std::array<int, 45> numericStates; // the Numeric Compaction states worth considering at pos
+		int numNumericStates = 0;
+
+		for (int pos = 0; pos <= len; ++pos) {
+			auto& cost = rows[pos % 3];
+			auto relax = [&](std::array<int, NUM_STATES>& row, int to, int toState, int fromState, int delta, StepKind kind) {
+				if (cost[fromState] + delta < row[toState]) {
+					row[toState] = cost[fromState] + delta;
+					_links[to * NUM_STATES + toState] = static_cast<uint8_t>(fromState << 2 | kind);
+				}
+			};
+
+			// In a long run of digits almost all group sizes are reachable, most of them at an unnecessarily high cost.
+			for (int i = 0; i < numNumericStates; ++i) {
+				int g2 = numericStates[i];
+				for (int j = 0; j < numNumericStates; ++j) {
+					int g1 = numericStates[j];
+					if (j != i && cost[NUMERIC_STATE + g1] != INF
+						&& cost[NUMERIC_STATE + g1] + numeric.dominance[g1][g2] <= cost[NUMERIC_STATE + g2]) {
+						cost[NUMERIC_STATE + g2] = INF;
+						break;
+					}
+				}
+			}
+			numNumericStates = static_cast<int>(std::remove_if(numericStates.begin(), numericStates.begin() + numNumericStates,
+															   [&](int g) { return cost[NUMERIC_STATE + g] == INF; })
+												- numericStates.begin());
+
+			// mode latches: 900 to Text Compaction (always to sub-mode Alpha), 901/924 to Byte and 902 to Numeric
+			// Compaction. An odd number of text values has to be padded before a latch.
+			for (int state = BYTE_STATE; state < NUMERIC_STATE; ++state)
+				if (cost[state] != INF)
+					relax(cost, pos, TextState(SUBMODE_ALPHA, 0), state, 2, LATCH);
+			for (int i = 0; i < numNumericStates; ++i)
+				relax(cost, pos, TextState(SUBMODE_ALPHA, 0), NUMERIC_STATE + numericStates[i], 2, LATCH);
+			bool digitFollows = pos < len && IsDigit(msg[pos]);
+			for (int state = 0; state < BYTE_STATE; ++state)
+				if (cost[state] != INF) {
+					relax(cost, pos, BYTE_STATE, state, 2 + state % 2, LATCH);
+					if (digitFollows)
+						relax(cost, pos, NUMERIC_STATE, state, 2 + state % 2, LATCH);
+				}
+			if (digitFollows)
+				for (int state = BYTE_STATE; state < NUMERIC_STATE; ++state)
+					if (cost[state] != INF)
+						relax(cost, pos, NUMERIC_STATE, state, 2, LATCH);
+			for (int i = 0; i < numNumericStates; ++i)
+				relax(cost, pos, BYTE_STATE, NUMERIC_STATE + numericStates[i], 2, LATCH);
+
+			if (pos == len)
+				break;
+			rows[(pos + 2) % 3].fill(INF);
+			if (_bytes[pos].empty())
+				continue; // second half of a surrogate pair
+
+			int ch = msg[pos];
+			int numBytes = Size(_bytes[pos]);
+			int next = pos + (pos + 1 < len && _bytes[pos + 1].empty() ? 2 : 1);
+			auto& nextCost = rows[next % 3];
+			int values[4];
+			for (int submode = SUBMODE_ALPHA; submode <= SUBMODE_PUNCTUATION; ++submode)
+				values[submode] = TextValue(submode, ch);
+
+			for (int state = 0; state < BYTE_STATE; ++state) {
+				if (cost[state] == INF)
+					continue;
+				int submode = state / 2, parity = state % 2;
+				for (int to = SUBMODE_ALPHA; to <= SUBMODE_PUNCTUATION; ++to) {
+					if (values[to] == -1)
+						continue;
+					int n = LATCH_LENGTHS[submode][to] + 1;
+					relax(nextCost, next, TextState(to, (parity + n) % 2), state, n, CHAR);
+					if (values[submode] == -1 && SHIFTS[submode][to] != -1)
+						relax(nextCost, next, state, state, 2, CHAR);
+				}
+				// 913 followed by one byte, for each byte of the character. The padding value 29 is a latch to
+				// Alpha in the Punctuation sub-mode (see 5.4.2.4 (b) (2)).
+				int after = parity && submode == SUBMODE_PUNCTUATION ? SUBMODE_ALPHA : submode;
+				relax(nextCost, next, TextState(after, 0), state, parity + 4 * numBytes, SHIFT_BYTE);
+			}
+
+			for (int r = 0; r < 6; ++r) {
+				if (cost[BYTE_STATE + r] == INF)
+					continue;
+				// Byte Compaction packs 6 bytes into 5 codewords, the remaining bytes take one codeword each
+				int delta = 0, to = r;
+				for (int i = 0; i < numBytes; ++i) {
+					delta += to == 5 ? 0 : 2;
+					to = (to + 1) % 6;
+				}
+				relax(nextCost, next, BYTE_STATE + to, BYTE_STATE + r, delta, CHAR);
+			}
+
+			int numNextStates = 0;
+			if (IsDigit(ch)) {
+				if (cost[NUMERIC_STATE] != INF)
+					numericStates[numNumericStates++] = 0;
+				for (int i = 0; i < numNumericStates; ++i) {
+					int g = numericStates[i], to = g == 44 ? 1 : g + 1;
+					if (nextCost[NUMERIC_STATE + to] == INF)
+						numericStates[numNextStates++] = to;
+					relax(nextCost, next, NUMERIC_STATE + to, NUMERIC_STATE + g, numeric.deltas[g], CHAR);
+				}
+			}
+			numNumericStates = numNextStates;
 		}
-		idx++;
+
+		const auto& cost = rows[len % 3];
+		_end = 0;
+		for (int state = 1; state < NUM_STATES; ++state)
+			if (cost[state] + IsTextState(state) * (state % 2) < cost[_end] + IsTextState(_end) * (_end % 2))
+				_end = state;
 	}
-	return static_cast<int>(idx - startpos);
-}
 
-/**
-* Determines the number of consecutive characters that are encodable using binary compaction.
-*
-* @param msg      the message
-* @param startpos the start position within the message
-* @return the requested character count
-*/
-static int DetermineConsecutiveBinaryCount(const std::wstring& msg, int startpos)
-{
-	size_t len = msg.length();
-	size_t idx = startpos;
-	while (idx < len) {
-		int ch = msg[idx];
-		int numericCount = 0;
-
-		while (numericCount < 13 && IsDigit(ch)) {
-			numericCount++;
-			//textCount++;
-			size_t i = idx + numericCount;
-			if (i >= len) {
+	void encode(std::vector<int>& output) const
+	{
+		struct Step
+		{
+			int pos, state;
+			StepKind kind; // kind of the step to the next one
+		};
+		int len = Size(_msg);
+		std::vector<Step> path = {{len, _end, LATCH}};
+		while (path.back().pos != 0 || path.back().state != TextState(SUBMODE_ALPHA, 0)) {
+			int link = _links[path.back().pos * NUM_STATES + path.back().state];
+			auto kind = static_cast<StepKind>(link & 3);
+			path.push_back({prevPos(path.back().pos, kind), link >> 2, kind});
+		}
+		std::reverse(path.begin(), path.end());
+
+		std::vector<int> textValues;
+		std::string bytes;
+		int numericStart = 0;
+
+		auto flush = [&](int state, int pos) {
+			if (IsTextState(state)) {
+				if (textValues.size() % 2)
+					textValues.push_back(29); // ps
+				for (size_t i = 0; i < textValues.size(); i += 2)
+					output.push_back(textValues[i] * 30 + textValues[i + 1]);
+				textValues.clear();
+			} else if (IsByteState(state)) {
+				EncodeBinary(bytes, 0, Size(bytes), BYTE_COMPACTION, output);
+				bytes.clear();
+			} else {
+				EncodeNumeric(_msg, numericStart, pos - numericStart, output);
+			}
+		};
+
+		for (size_t i = 1; i < path.size(); ++i) {
+			int from = path[i - 1].state, to = path[i].state, pos = path[i - 1].pos;
+			switch (path[i - 1].kind) {
+			case LATCH:
+				flush(from, pos);
+				if (IsTextState(to))
+					output.push_back(LATCH_TO_TEXT);
+				else if (!IsByteState(to)) {
+					output.push_back(LATCH_TO_NUMERIC);
+					numericStart = pos;
+				}
+				break;
+			case SHIFT_BYTE:
+				flush(from, pos);
+				for (char b : _bytes[pos])
+					EncodeBinary(std::string(1, b), 0, 1, TEXT_COMPACTION, output);
+				break;
+			case CHAR:
+				if (IsTextState(to)) {
+					int submode = from / 2, target = to / 2, ch = _msg[pos];
+					if (target == submode && TextValue(submode, ch) == -1) {
+						target = SHIFTS[submode][SUBMODE_PUNCTUATION] != -1 && TextValue(SUBMODE_PUNCTUATION, ch) != -1
+									 ? SUBMODE_PUNCTUATION
+									 : SUBMODE_ALPHA;
+						textValues.push_back(SHIFTS[submode][target]);
+					} else {
+						for (int n = 0; n < LATCH_LENGTHS[submode][target]; ++n)
+							textValues.push_back(LATCHES[submode][target][n]);
+					}
+					textValues.push_back(TextValue(target, ch));
+				} else if (IsByteState(to)) {
+					bytes += _bytes[pos];
+				}
 				break;
 			}
-			ch = msg[i];
-		}
-		if (numericCount >= 13) {
-			return static_cast<int>(idx - startpos);
 		}
-		idx++;
+		flush(_end, len);
 	}
-	return static_cast<int>(idx - startpos);
-}
+
+private:
+	int _end; // state after the last character of the cheapest path
+};
 
 /**
-* Performs high-level encoding of a PDF417 message using the algorithm described in annex P
-* of ISO/IEC 15438:2001(E). If byte compaction has been selected, then only byte compaction
-* is used.
+* Performs high-level encoding of a PDF417 message. With Compaction::AUTO, the compaction modes
+* are chosen such that the number of codewords is minimal (see CompactionPlanner), otherwise only
+* the selected compaction mode is used.
 *
 * @param msg the message
 * @param compaction compaction mode to use
@@ -524,47 +748,7 @@ HighLevelEncoder::EncodeHighLevel(const std::wstring& msg, Compaction compaction
 
 	}
 	else {
-		int encodingMode = TEXT_COMPACTION; //Default mode, see 4.4.2.1
-		while (p < len) {
-			int n = DetermineConsecutiveDigitCount(msg, p);
-			if (n >= 13) {
-				highLevel.push_back(LATCH_TO_NUMERIC);
-				encodingMode = NUMERIC_COMPACTION;
-				textSubMode = SUBMODE_ALPHA; //Reset after latch
-				EncodeNumeric(msg, p, n, highLevel);
-				p += n;
-			}
-			else {
-				int t = DetermineConsecutiveTextCount(msg, p);
-				if (t >= 5 || n == len) {
-					if (encodingMode != TEXT_COMPACTION) {
-						highLevel.push_back(LATCH_TO_TEXT);
-						encodingMode = TEXT_COMPACTION;
-						textSubMode = SUBMODE_ALPHA; //start with submode alpha after latch
-					}
-					textSubMode = EncodeText(msg, p, t, textSubMode, highLevel);
-					p += t;
-				}
-				else {
-					int b = DetermineConsecutiveBinaryCount(msg, p);
-					if (b == 0) {
-						b = 1;
-					}
-					std::string bytes = TextEncoder::FromUnicode(msg.substr(p, b), encoding);
-					if (bytes.length() == 1 && encodingMode == TEXT_COMPACTION) {
-						//Switch for one byte (instead of latch)
-						EncodeBinary(bytes, 0, 1, TEXT_COMPACTION, highLevel);
-					}
-					else {
-						//Mode latch performed by encodeBinary()
-						EncodeBinary(bytes, 0, Size(bytes), encodingMode, highLevel);
-						encodingMode = BYTE_COMPACTION;
-						textSubMode = SUBMODE_ALPHA; //Reset after latch
-					}
-					p += b;
-				}
-			}
-		}
+		CompactionPlanner(msg, encoding).encode(highLevel);
 	}
 	return highLevel;
 }
@@ -19,8 +19,8 @@ namespace Pdf417 {
 enum class Compaction;
 
 /**
-* PDF417 high-level encoder following the algorithm described in ISO/IEC 15438:2001(E) in
-* annex P.
+* PDF417 high-level encoder (see ISO/IEC 15438:2001(E)). Instead of the look-ahead rules of annex P,
+* the compaction modes are chosen to minimize the number of codewords.
 */
 class HighLevelEncoder
 {
@@ -14,11 +14,12 @@
 #include "PDFDetectionResult.h"
 #include "PDFDecoder.h"
 #include "PDFCustomData.h"
-#include "PDFModulusGF.h"
 #include "ZXAlgorithms.h"
 #include "ZXTestSupport.h"
 
+#include <algorithm>
 #include <cmath>
+#include <numeric>
 
 namespace ZXing {
 namespace Pdf417 {
@@ -357,160 +358,215 @@ static bool AdjustCodewordCount(const DetectionResult& detectionResult, std::vec
 }
 // +++++++++++++++++++++++++++++++++++ Error Correction
 
-static const ModulusGF& GetModulusGF()
-{
-	static const ModulusGF field(CodewordDecoder::NUMBER_OF_CODEWORDS, 3);
-	return field;
-}
-
-static bool RunEuclideanAlgorithm(ModulusPoly a, ModulusPoly b, int R, ModulusPoly& sigma, ModulusPoly& omega)
+/**
+* Log and antilog tables of GF(929) with the generator 3, computed at compile time. The exp table is doubled so the
+* sum of two logarithms can be looked up without a modulo operation.
+*/
+struct ModulusGF929
 {
-	const ModulusGF& field = GetModulusGF();
-
-	// Assume a's degree is >= b's
-	if (a.degree() < b.degree()) {
-		swap(a, b);
+	static constexpr int MOD = CodewordDecoder::NUMBER_OF_CODEWORDS;
+	std::array<short, 2 * (MOD - 1)> exp = {};
+	std::array<short, MOD> log = {};
+
+	constexpr ModulusGF929()
+	{
+		int x = 1;
+		for (int i = 0; i < MOD - 1; ++i) {
+			exp[i] = exp[i + MOD - 1] = static_cast<short>(x);
+			log[x] = static_cast<short>(i);
+			x = (x * 3) % MOD;
+		}
+		// log[0] == 0 but this should never be used
 	}
 
-	ModulusPoly rLast = a;
-	ModulusPoly r = b;
-	ModulusPoly tLast = field.zero();
-	ModulusPoly t = field.one();
-
-	// Run Euclidean algorithm until r's degree is less than R/2
-	while (r.degree() >= R / 2) {
-		ModulusPoly rLastLast = rLast;
-		ModulusPoly tLastLast = tLast;
-		rLast = r;
-		tLast = t;
+	constexpr int multiply(int a, int b) const { return a && b ? exp[log[a] + log[b]] : 0; }
+	constexpr int inverse(int a) const { return exp[MOD - 1 - log[a]]; }
+	constexpr int subtract(int a, int b) const { return (MOD + a - b) % MOD; }
+};
 
-		// Divide rLastLast by rLast, with quotient in q and remainder in r
-		if (rLast.isZero()) {
-			// Oops, Euclidean algorithm already terminated?
-			return false;
-		}
-		r = rLastLast;
-		ModulusPoly q = field.zero();
-		int denominatorLeadingTerm = rLast.coefficient(rLast.degree());
-		int dltInverse = field.inverse(denominatorLeadingTerm);
-		while (r.degree() >= rLast.degree() && !r.isZero()) {
-			int degreeDiff = r.degree() - rLast.degree();
-			int scale = field.multiply(r.coefficient(r.degree()), dltInverse);
-			q = q.add(field.buildMonomial(degreeDiff, scale));
-			r = r.subtract(rLast.multiplyByMonomial(degreeDiff, scale));
-		}
+static constexpr ModulusGF929 GF929;
 
-		t = q.multiply(tLast).subtract(tLastLast).negative();
-	}
+// all polynomials below are stored lowest power first in fixed size buffers, the error correction does not allocate
+using ECPoly = std::array<int, MAX_EC_CODEWORDS + 1>;
 
-	int sigmaTildeAtZero = t.coefficient(0);
-	if (sigmaTildeAtZero == 0) {
-		return false;
-	}
+/**
+* Evaluate the received codewords (highest power first) at a^1..a^R. Each syndrome is one independent lane of the
+* Horner scheme, which lets the compiler vectorize the inner loop.
+*/
+static bool ComputeSyndromes(const std::vector<int>& received, int R, ECPoly& S)
+{
+	constexpr uint32_t MOD = ModulusGF929::MOD;
+	std::array<uint32_t, MAX_EC_CODEWORDS> acc = {}, x;
+	for (int j = 0; j < R; ++j)
+		x[j] = GF929.exp[j + 1];
+	for (int c : received)
+		for (int j = 0; j < R; ++j)
+			acc[j] = (acc[j] * x[j] + c) % MOD;
+
+	uint32_t any = 0;
+	for (int j = 0; j < R; ++j) {
+		S[j] = acc[j];
+		any |= acc[j];
+	}
+	return any != 0;
+}
 
-	int inverse = field.inverse(sigmaTildeAtZero);
-	sigma = t.multiply(inverse);
-	omega = r.multiply(inverse);
-	return true;
+static int EvaluateAt(const ECPoly& poly, int degree, int x)
+{
+	int res = 0;
+	for (int i = degree; i >= 0; --i)
+		res = (GF929.multiply(res, x) + poly[i]) % ModulusGF929::MOD;
+	return res;
 }
 
-static bool FindErrorLocations(const ModulusPoly& errorLocator, std::vector<int>& result)
-{
-	const ModulusGF& field = GetModulusGF();
-	// This is a direct application of Chien's search
-	int numErrors = errorLocator.degree();
-	result.resize(numErrors);
-	int e = 0;
-	for (int i = 1; i < field.size() && e < numErrors; i++) {
-		if (errorLocator.evaluateAt(i) == 0) {
-			result[e] = field.inverse(i);
-			e++;
+/**
+* Berlekamp-Massey for errors and erasures: starting with the erasure locator, the combined errata locator sigma
+* is found from the syndromes S (modified by the erasures implicitly via the start values).
+* @return the degree of sigma, i.e. the number of errata
+*/
+static int RunBerlekampMassey(const ECPoly& S, int R, int E, ECPoly& sigma)
+{
+	ECPoly B = sigma, T;
+	int L = E;
+	for (int r = E; r < R; ++r) {
+		int delta = 0;
+		for (int i = 0; i <= L; ++i)
+			delta = (delta + GF929.multiply(sigma[i], S[r - i])) % ModulusGF929::MOD;
+
+		// B = x * B
+		std::copy_backward(B.begin(), B.begin() + R, B.begin() + R + 1);
+		B[0] = 0;
+
+		if (delta == 0)
+			continue;
+
+		T = sigma;
+		for (int i = 0; i <= R; ++i)
+			sigma[i] = GF929.subtract(sigma[i], GF929.multiply(delta, B[i]));
+
+		if (2 * L <= r + E) {
+			L = r + 1 + E - L;
+			int deltaInv = GF929.inverse(delta);
+			for (int i = 0; i <= R; ++i)
+				B[i] = GF929.multiply(T[i], deltaInv);
 		}
 	}
-	return e == numErrors;
+
+	int degree = R;
+	while (degree > 0 && sigma[degree] == 0)
+		--degree;
+	// more errata than the EC capacity allows (2 * errors + erasures > R) can not be corrected reliably
+	return degree == L && 2 * L - E <= R ? L : -1;
 }
 
-static std::vector<int> FindErrorMagnitudes(const ModulusPoly& errorEvaluator, const ModulusPoly& errorLocator, const std::vector<int>& errorLocations)
+/**
+* Chien search over the n possible positions: lane k evaluates sigma at a^-k. All lanes share the same Horner steps,
+* which lets the compiler vectorize the inner loop.
+* @return number of roots found, positions holds the corresponding k values
+*/
+static int FindErrorLocations(const ECPoly& sigma, int degree, int n, std::array<int, CodewordDecoder::MAX_CODEWORDS_IN_BARCODE>& positions)
 {
-	const ModulusGF& field = GetModulusGF();
-	int errorLocatorDegree = errorLocator.degree();
-	std::vector<int> formalDerivativeCoefficients(errorLocatorDegree);
-	for (int i = 1; i <= errorLocatorDegree; i++) {
-		formalDerivativeCoefficients[errorLocatorDegree - i] = field.multiply(i, errorLocator.coefficient(i));
-	}
-
-	ModulusPoly formalDerivative(field, formalDerivativeCoefficients);
-	// This is directly applying Forney's Formula
-	std::vector<int> result(errorLocations.size());
-	for (size_t i = 0; i < result.size(); i++) {
-		int xiInverse = field.inverse(errorLocations[i]);
-		int numerator = field.subtract(0, errorEvaluator.evaluateAt(xiInverse));
-		int denominator = field.inverse(formalDerivative.evaluateAt(xiInverse));
-		result[i] = field.multiply(numerator, denominator);
-	}
-	return result;
+	constexpr uint32_t MOD = ModulusGF929::MOD;
+	std::array<uint32_t, CodewordDecoder::MAX_CODEWORDS_IN_BARCODE> acc, x;
+	for (int k = 0; k < n; ++k) {
+		x[k] = GF929.exp[(MOD - 1 - k) % (MOD - 1)];
+		acc[k] = sigma[degree];
+	}
+	for (int i = degree - 1; i >= 0; --i) {
+		uint32_t c = sigma[i];
+		for (int k = 0; k < n; ++k)
+			acc[k] = (acc[k] * x[k] + c) % MOD;
+	}
+
+	int numRoots = 0;
+	for (int k = 0; k < n; ++k)
+		if (acc[k] == 0)
+			positions[numRoots++] = k;
+	return numRoots;
 }
 
 /**
 * @param received received codewords
 * @param numECCodewords number of those codewords used for EC
 * @param erasures location of erasures
+* @param nbErrors number of corrected codewords (errors and erasures)
 * @return false if errors cannot be corrected, maybe because of too many errors
 */
 ZXING_EXPORT_TEST_ONLY
-bool DecodeErrorCorrection(std::vector<int>& received, int numECCodewords, const std::vector<int>& erasures [[maybe_unused]], int& nbErrors)
-{
-	const ModulusGF& field = GetModulusGF();
-	ModulusPoly poly(field, received);
-	std::vector<int> S(numECCodewords);
-	bool error = false;
-	for (int i = numECCodewords; i > 0; i--) {
-		int eval = poly.evaluateAt(field.exp(i));
-		S[numECCodewords - i] = eval;
-		if (eval != 0) {
-			error = true;
-		}
-	}
+bool DecodeErrorCorrection(std::vector<int>& received, int numECCodewords, const std::vector<int>& erasures, int& nbErrors)
+{
+	const int n = Size(received);
+	const int R = numECCodewords;
+	if (R < 0 || R > MAX_EC_CODEWORDS || n > CodewordDecoder::MAX_CODEWORDS_IN_BARCODE)
+		return false;
 
-	if (!error) {
+	ECPoly S;
+	if (!ComputeSyndromes(received, R, S)) {
 		nbErrors = 0;
 		return true;
 	}
 
-//	ModulusPoly knownErrors = field.one();
-//	for (int erasure : erasures) {
-//		int b = field.exp(Size(received) - 1 - erasure);
-//		// Add (1 - bx) term:
-//		ModulusPoly term(field, { field.subtract(0, b), 1 });
-//		knownErrors = knownErrors.multiply(term);
-//	}
-
-	ModulusPoly syndrome(field, S);
-//	syndrome = syndrome.multiply(knownErrors);
-
-	ModulusPoly sigma, omega;
-	if (!RunEuclideanAlgorithm(field.buildMonomial(numECCodewords, 1), syndrome, numECCodewords, sigma, omega)) {
+	const int E = Size(erasures);
+	if (E > R)
 		return false;
+
+	// erasure locator: product of the (1 - bx) terms
+	ECPoly sigma = {};
+	sigma[0] = 1;
+	for (int e = 0; e < E; ++e) {
+		int erasure = erasures[e];
+		if (erasure < 0 || erasure >= n)
+			return false;
+		int b = GF929.exp[n - 1 - erasure];
+		for (int i = e + 1; i > 0; --i)
+			sigma[i] = GF929.subtract(sigma[i], GF929.multiply(b, sigma[i - 1]));
 	}
 
-//	sigma = sigma.multiply(knownErrors);
+	int numErrata = RunBerlekampMassey(S, R, E, sigma);
+	if (numErrata <= 0)
+		return false;
 
-	std::vector<int> errorLocations;
-	if (!FindErrorLocations(sigma, errorLocations)) {
+	std::array<int, CodewordDecoder::MAX_CODEWORDS_IN_BARCODE> positions;
+	if (FindErrorLocations(sigma, numErrata, n, positions) != numErrata)
 		return false;
-	}
 
-	std::vector<int> errorMagnitudes = FindErrorMagnitudes(omega, sigma, errorLocations);
+	// error evaluator omega = S * sigma mod x^R
+	ECPoly omega = {};
+	for (int i = 0; i < R; ++i)
+		for (int j = 0; j <= std::min(i, numErrata); ++j)
+			omega[i] = (omega[i] + GF929.multiply(S[i - j], sigma[j])) % ModulusGF929::MOD;
+
+	// formal derivative of sigma
+	ECPoly sigmaPrime = {};
+	for (int i = 1; i <= numErrata; ++i)
+		sigmaPrime[i - 1] = GF929.multiply(i, sigma[i]);
 
-	int receivedSize = Size(received);
-	for (size_t i = 0; i < errorLocations.size(); i++) {
-		int position = receivedSize - 1 - field.log(errorLocations[i]);
-		if (position < 0) {
+	// This is directly applying Forney's Formula
+	std::array<int, MAX_EC_CODEWORDS> magnitudes;
+	for (int e = 0; e < numErrata; ++e) {
+		int xiInverse = GF929.exp[(ModulusGF929::MOD - 1 - positions[e]) % (ModulusGF929::MOD - 1)];
+		int numerator = GF929.subtract(0, EvaluateAt(omega, R - 1, xiInverse));
+		int denominator = EvaluateAt(sigmaPrime, numErrata - 1, xiInverse);
+		if (denominator == 0)
 			return false;
+		magnitudes[e] = GF929.multiply(numerator, GF929.inverse(denominator));
+	}
+
+	for (int e = 0; e < numErrata; ++e) {
+		int& c = received[n - 1 - positions[e]];
+		c = GF929.subtract(c, magnitudes[e]);
+	}
+
+	// a valid correction results in a codeword, otherwise restore the received codewords
+	if (ComputeSyndromes(received, R, S)) {
+		for (int e = 0; e < numErrata; ++e) {
+			int& c = received[n - 1 - positions[e]];
+			c = (c + magnitudes[e]) % ModulusGF929::MOD;
 		}
-		received[position] = field.subtract(received[position], errorMagnitudes[i]);
+		return false;
 	}
-	nbErrors = Size(errorLocations);
+
+	nbErrors = numErrata;
 	return true;
 }
 
@@ -567,15 +623,34 @@ static bool VerifyCodewordCount(std::vector<int>& codewords, int numECCodewords)
 	return true;
 }
 
-static DecoderResult DecodeCodewords(std::vector<int>& codewords, int numECCodewords, const std::vector<int>& erasures)
+/**
+* @param maxErrata limit for 2 * errors + erasures, a correction that needs more of the EC capacity is rejected
+*/
+static DecoderResult DecodeCodewords(std::vector<int>& codewords, int numECCodewords, const std::vector<int>& erasures,
+									 int maxErrata = MAX_EC_CODEWORDS)
 {
 	if (codewords.empty())
 		return FormatError();
 
+	// Erasures extend the correction capacity, but a solution that uses up all EC codewords can not be verified
+	// anymore. Accept it only with two EC codewords to spare or if it would also be found treating erasures as errors.
+	// The received codewords are restored otherwise, so the next attempt with other ambiguous values starts clean.
+	int numErasures = Size(erasures);
+	std::vector<int> received;
+	if (numErasures > 0 || maxErrata < numECCodewords)
+		received = codewords;
+
 	int correctedErrorsCount = 0;
 	if (!CorrectErrors(codewords, erasures, numECCodewords, correctedErrorsCount))
 		return ChecksumError();
 
+	int usedCapacity = 2 * correctedErrorsCount - numErasures; // correctedErrorsCount includes the erasures
+	if (usedCapacity > maxErrata ||
+		(numErasures > 0 && usedCapacity > numECCodewords - 2 && 2 * correctedErrorsCount > numECCodewords)) {
+		codewords = std::move(received);
+		return ChecksumError();
+	}
+
 	if (!VerifyCodewordCount(codewords, numECCodewords))
 		return FormatError();
 
@@ -588,15 +663,15 @@ DecoderResult DecodeCodewords(std::vector<int>& codewords, int numECCodeWords)
 	for (auto& cw : codewords)
 		cw = std::clamp(cw, 0, CodewordDecoder::MAX_CODEWORDS_IN_BARCODE);
 
-	// erasures array has never been actually used inside the error correction code
+	// no information about unreadable codewords available here, so there are no known erasures
 	return DecodeCodewords(codewords, numECCodeWords, {});
 }
 
 
 /**
-* This method deals with the fact, that the decoding process doesn't always yield a single most likely value. The
-* current error correction implementation doesn't deal with erasures very well, so it's better to provide a value
-* for these ambiguous codewords instead of treating it as an erasure. The problem is that we don't know which of
+* This method deals with the fact, that the decoding process doesn't always yield a single most likely value. Treating
+* an ambiguous codeword as an erasure would waste error correction capacity if one of the values is correct, so
+* it's better to provide a value for these ambiguous codewords instead. The problem is that we don't know which of
 * the ambiguous values to choose. We try decode using the first value, and if that fails, we use another of the
 * ambiguous values and try to decode again. This usually only happens on very hard to read and decode barcodes,
 * so decoding the normal barcodes is not affected by this.
@@ -608,7 +683,7 @@ DecoderResult DecodeCodewords(std::vector<int>& codewords, int numECCodeWords)
 */
 static DecoderResult CreateDecoderResultFromAmbiguousValues(int ecLevel, std::vector<int>& codewords,
 	const std::vector<int>& erasureArray, const std::vector<int>& ambiguousIndexes,
-	const std::vector<std::vector<int>>& ambiguousIndexValues)
+	const std::vector<std::vector<int>>& ambiguousIndexValues, int maxErrata)
 {
 	std::vector<int> ambiguousIndexCount(ambiguousIndexes.size(), 0);
 
@@ -617,7 +692,7 @@ static DecoderResult CreateDecoderResultFromAmbiguousValues(int ecLevel, std::ve
 		for (size_t i = 0; i < ambiguousIndexCount.size(); i++) {
 			codewords[ambiguousIndexes[i]] = ambiguousIndexValues[i][ambiguousIndexCount[i]];
 		}
-		auto result = DecodeCodewords(codewords, NumECCodeWords(ecLevel), erasureArray);
+		auto result = DecodeCodewords(codewords, NumECCodeWords(ecLevel), erasureArray, maxErrata);
 		if (result.error() != Error::Checksum) {
 			return result;
 		}
@@ -642,7 +717,7 @@ static DecoderResult CreateDecoderResultFromAmbiguousValues(int ecLevel, std::ve
 }
 
 
-static DecoderResult CreateDecoderResult(DetectionResult& detectionResult)
+static DecoderResult CreateDecoderResult(DetectionResult& detectionResult, int maxErrata = MAX_EC_CODEWORDS)
 {
 	auto barcodeMatrix = CreateBarcodeMatrix(detectionResult);
 	if (!AdjustCodewordCount(detectionResult, barcodeMatrix)) {
@@ -669,7 +744,71 @@ static DecoderResult CreateDecoderResult(DetectionResult& detectionResult)
 		}
 	}
 	return CreateDecoderResultFromAmbiguousValues(detectionResult.barcodeECLevel(), codewords, erasures,
-												  ambiguousIndexesList, ambiguousIndexValues);
+												  ambiguousIndexesList, ambiguousIndexValues, maxErrata);
+}
+
+/**
+* Detect the codewords of all data columns in the given image rows. The row indicator columns have to be set already.
+*/
+static void DetectDataColumns(const BitMatrix& image, DetectionResult& detectionResult, const BoundingBox& boundingBox,
+							  const std::vector<int>& imageRows, bool leftToRight, int& minCodewordWidth, int& maxCodewordWidth)
+{
+	int maxBarcodeColumn = detectionResult.barcodeColumnCount() + 1;
+	for (int barcodeColumnCount = 1; barcodeColumnCount <= maxBarcodeColumn; barcodeColumnCount++) {
+		int barcodeColumn = leftToRight ? barcodeColumnCount : maxBarcodeColumn - barcodeColumnCount;
+		if (detectionResult.column(barcodeColumn) != nullptr) {
+			// This will be the case for the opposite row indicator column, which doesn't need to be decoded again.
+			continue;
+		}
+		DetectionResultColumn::RowIndicator rowIndicator = barcodeColumn == 0 ? DetectionResultColumn::RowIndicator::Left : (barcodeColumn == maxBarcodeColumn ? DetectionResultColumn::RowIndicator::Right : DetectionResultColumn::RowIndicator::None);
+		detectionResult.setColumn(barcodeColumn, DetectionResultColumn(boundingBox, rowIndicator));
+		int startColumn = -1;
+		int previousStartColumn = startColumn;
+		for (int imageRow : imageRows) {
+			startColumn = GetStartColumn(detectionResult, barcodeColumn, imageRow, leftToRight);
+			if (startColumn < 0 || startColumn > boundingBox.maxX()) {
+				if (previousStartColumn == -1) {
+					continue;
+				}
+				startColumn = previousStartColumn;
+			}
+			Nullable<Codeword> codeword = DetectCodeword(image, boundingBox.minX(), boundingBox.maxX(), leftToRight, startColumn, imageRow, minCodewordWidth, maxCodewordWidth);
+			if (codeword != nullptr) {
+				detectionResult.column(barcodeColumn).value().setCodeword(imageRow, codeword);
+				previousStartColumn = startColumn;
+				UpdateMinMax(minCodewordWidth, maxCodewordWidth, codeword.value().width());
+			}
+		}
+	}
+}
+
+/**
+* Select one image row per symbol row: the median of all image rows in which a row indicator codeword of that symbol
+* row was found. Symbol rows without any row indicator codeword are skipped.
+*/
+static std::vector<int> GetRowLines(const DetectionResult& detectionResult, const BoundingBox& boundingBox)
+{
+	std::vector<std::vector<int>> imageRowsPerSymbolRow(detectionResult.barcodeRowCount());
+	for (int imageRow = boundingBox.minY(); imageRow <= boundingBox.maxY(); imageRow++) {
+		for (int barcodeColumn : {0, detectionResult.barcodeColumnCount() + 1}) {
+			auto& column = detectionResult.column(barcodeColumn);
+			if (column == nullptr)
+				continue;
+			auto codeword = column.value().codeword(imageRow);
+			if (codeword != nullptr && codeword.value().hasValidRowNumber() &&
+				codeword.value().rowNumber() < Size(imageRowsPerSymbolRow)) {
+				imageRowsPerSymbolRow[codeword.value().rowNumber()].push_back(imageRow);
+				break;
+			}
+		}
+	}
+
+	std::vector<int> rowLines;
+	rowLines.reserve(imageRowsPerSymbolRow.size());
+	for (auto& imageRows : imageRowsPerSymbolRow)
+		if (!imageRows.empty())
+			rowLines.push_back(imageRows[imageRows.size() / 2]);
+	return rowLines;
 }
 
 
@@ -713,33 +852,27 @@ ScanningDecoder::Decode(const BitMatrix& image, const Nullable<ResultPoint>& ima
 	detectionResult.setColumn(maxBarcodeColumn, rightRowIndicatorColumn);
 
 	bool leftToRight = leftRowIndicatorColumn != nullptr;
-	for (int barcodeColumnCount = 1; barcodeColumnCount <= maxBarcodeColumn; barcodeColumnCount++) {
-		int barcodeColumn = leftToRight ? barcodeColumnCount : maxBarcodeColumn - barcodeColumnCount;
-		if (detectionResult.column(barcodeColumn) != nullptr) {
-			// This will be the case for the opposite row indicator column, which doesn't need to be decoded again.
-			continue;
-		}
-		DetectionResultColumn::RowIndicator rowIndicator = barcodeColumn == 0 ? DetectionResultColumn::RowIndicator::Left : (barcodeColumn == maxBarcodeColumn ? DetectionResultColumn::RowIndicator::Right : DetectionResultColumn::RowIndicator::None);
-		detectionResult.setColumn(barcodeColumn, DetectionResultColumn(boundingBox, rowIndicator));
-		int startColumn = -1;
-		int previousStartColumn = startColumn;
-		// TODO start at a row for which we know the start position, then detect upwards and downwards from there.
-		for (int imageRow = boundingBox.minY(); imageRow <= boundingBox.maxY(); imageRow++) {
-			startColumn = GetStartColumn(detectionResult, barcodeColumn, imageRow, leftToRight);
-			if (startColumn < 0 || startColumn > boundingBox.maxX()) {
-				if (previousStartColumn == -1) {
-					continue;
-				}
-				startColumn = previousStartColumn;
-			}
-			Nullable<Codeword> codeword = DetectCodeword(image, boundingBox.minX(), boundingBox.maxX(), leftToRight, startColumn, imageRow, minCodewordWidth, maxCodewordWidth);
-			if (codeword != nullptr) {
-				detectionResult.column(barcodeColumn).value().setCodeword(imageRow, codeword);
-				previousStartColumn = startColumn;
-				UpdateMinMax(minCodewordWidth, maxCodewordWidth, codeword.value().width());
-			}
+
+	// Fast path: sample every data codeword only once, along the center line of each symbol row as given by the row
+	// indicator columns. Without repeated samples there are no votes to resolve misread codewords, so the result is
+	// only accepted if the error correction used at most half of its capacity. Otherwise scan all image rows below.
+	{
+		DetectionResult sparseResult = detectionResult;
+		int minWidth = minCodewordWidth, maxWidth = maxCodewordWidth;
+		DetectDataColumns(image, sparseResult, boundingBox, GetRowLines(detectionResult, boundingBox), leftToRight, minWidth, maxWidth);
+		auto res = CreateDecoderResult(sparseResult, NumECCodeWords(sparseResult.barcodeECLevel()) / 2);
+		if (res.isValid()) {
+			if (auto customData = std::static_pointer_cast<PDF417CustomData>(res.customData()))
+				customData->approxSymbolWidth = (sparseResult.barcodeColumnCount() + 2) * (minWidth + maxWidth) / 2;
+			return res;
 		}
 	}
+
+	// TODO start at a row for which we know the start position, then detect upwards and downwards from there.
+	std::vector<int> imageRows(boundingBox.maxY() - boundingBox.minY() + 1);
+	std::iota(imageRows.begin(), imageRows.end(), boundingBox.minY());
+	DetectDataColumns(image, detectionResult, boundingBox, imageRows, leftToRight, minCodewordWidth, maxCodewordWidth);
+
 	auto res = CreateDecoderResult(detectionResult);
 	auto customData = std::static_pointer_cast<PDF417CustomData>(res.customData());
 	if (customData)
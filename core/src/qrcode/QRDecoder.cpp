@@ -25,6 +25,7 @@
 #include "ZXTestSupport.h"
 
 #include <algorithm>
+#include <array>
 #include <stdexcept>
 #include <utility>
 #include <vector>
@@ -41,17 +42,8 @@ namespace ZXing::QRCode {
 */
 static bool CorrectErrors(ByteArray& codewordBytes, int numDataCodewords)
 {
-	// First read into an array of ints
-	std::vector<int> codewordsInts(codewordBytes.begin(), codewordBytes.end());
-
-	int numECCodewords = Size(codewordBytes) - numDataCodewords;
-	if (!ReedSolomonDecode(GenericGF::QRCodeField256(), codewordsInts, numECCodewords))
-		return false;
-
-	// Copy back into array of bytes -- only need to worry about the bytes that were data
-	// We don't care about errors in the error-correction codewords
-	std::copy_n(codewordsInts.begin(), numDataCodewords, codewordBytes.begin());
-	return true;
+	// correct the codewords in-place, a clean block is verified by a syndrome check without any allocations
+	return ReedSolomonDecode(GenericGF::QRCodeField256(), codewordBytes, Size(codewordBytes) - numDataCodewords);
 }
 
 
@@ -109,10 +101,7 @@ static void DecodeKanjiSegment(BitSource& bits, int count, Content& result)
 static void DecodeByteSegment(BitSource& bits, int count, Content& result)
 {
 	result.switchEncoding(CharacterSet::Unknown);
-	result.reserve(count);
-
-	for (int i = 0; i < count; i++)
-		result.push_back(bits.readBits(8));
+	bits.readBytes(count, result.bytes);
 }
 
 static char ToAlphaNumericChar(int value)
@@ -132,47 +121,63 @@ static char ToAlphaNumericChar(int value)
 
 static void DecodeAlphanumericSegment(BitSource& bits, int count, Content& result)
 {
+	result.switchEncoding(CharacterSet::ISO8859_1);
+	result.reserve(count);
+	const size_t begin = result.bytes.size();
+
 	// Read two characters at a time
-	std::string buffer;
 	while (count > 1) {
 		int nextTwoCharsBits = bits.readBits(11);
-		buffer += ToAlphaNumericChar(nextTwoCharsBits / 45);
-		buffer += ToAlphaNumericChar(nextTwoCharsBits % 45);
+		result.push_back(ToAlphaNumericChar(nextTwoCharsBits / 45));
+		result.push_back(ToAlphaNumericChar(nextTwoCharsBits % 45));
 		count -= 2;
 	}
 	if (count == 1) {
 		// special case: one character left
-		buffer += ToAlphaNumericChar(bits.readBits(6));
+		result.push_back(ToAlphaNumericChar(bits.readBits(6)));
 	}
 	// See section 6.4.8.1, 6.4.8.2
 	if (result.symbology.aiFlag != AIFlag::None) {
-		// We need to massage the result a bit if in an FNC1 mode:
-		for (auto i = buffer.begin(); i != buffer.end(); i++) {
-			if (*i == '%') {
-				if (i + 1 != buffer.end() && *(i + 1) == '%') {
-					// %% is rendered as %
-					i = buffer.erase(i);
-				} else {
-					// In alpha mode, % should be converted to FNC1 separator 0x1D
-					*i = static_cast<char>(0x1D);
-				}
+		// We need to massage the result a bit if in an FNC1 mode, done in-place on the segment just appended:
+		auto& bytes = result.bytes;
+		size_t j = begin;
+		for (size_t i = begin; i < bytes.size(); ++i, ++j) {
+			if (bytes[i] == '%') {
+				if (i + 1 < bytes.size() && bytes[i + 1] == '%')
+					bytes[j] = bytes[++i]; // %% is rendered as %
+				else
+					bytes[j] = 0x1D; // In alpha mode, % should be converted to FNC1 separator 0x1D
+			} else {
+				bytes[j] = bytes[i];
 			}
 		}
+		bytes.resize(j);
 	}
-
-	result.switchEncoding(CharacterSet::ISO8859_1);
-	result.append(buffer);
 }
 
 static void DecodeNumericSegment(BitSource& bits, int count, Content& result)
 {
+	// "000" to "999", the last n characters of entry v are the n-digit representation of v
+	static constexpr auto DIGITS = [] {
+		std::array<char, 3 * 1000> res = {};
+		for (int i = 0; i < 1000; ++i) {
+			res[3 * i + 0] = '0' + i / 100;
+			res[3 * i + 1] = '0' + i / 10 % 10;
+			res[3 * i + 2] = '0' + i % 10;
+		}
+		return res;
+	}();
+	constexpr int POW10[] = {1, 10, 100, 1000};
+
 	result.switchEncoding(CharacterSet::ISO8859_1);
 	result.reserve(count);
 
 	while (count) {
 		int n = std::min(count, 3);
 		int nDigits = bits.readBits(1 + 3 * n); // read 4, 7 or 10 bits into 1, 2 or 3 digits
-		result.append(ZXing::ToString(nDigits, n));
+		if (nDigits >= POW10[n])
+			throw FormatError("Invalid value");
+		result.append(std::string_view(DIGITS.data() + 3 * nDigits + 3 - n, n));
 		count -= n;
 	}
 }
@@ -234,6 +239,8 @@ DecoderResult DecodeBitStream(ByteArray&& bytes, const Version& version, ErrorCo
 	Content result;
 	Error error;
 	result.symbology = {'Q', version.isModel1() ? '0' : '1', 1};
+	// numeric mode is the densest one with 3 digits per 10 bits, so this is enough for any content (without ECI)
+	result.reserve(Size(bytes) * 8 * 3 / 10 + 3);
 	StructuredAppendInfo structuredAppend;
 	const int modeBitLength = CodecModeBitsLength(version);
 
@@ -8,6 +8,7 @@
 
 #include "BitMatrix.h"
 #include "ByteArray.h"
+#include "Content.h"
 #include "QRCodecMode.h"
 #include "QRVersion.h"
 
@@ -24,10 +25,11 @@ class EncodeResult
 {
 public:
 	ErrorCorrectionLevel ecLevel = ErrorCorrectionLevel::Invalid;
-	CodecMode mode = CodecMode::TERMINATOR;
+	CodecMode mode = CodecMode::TERMINATOR; // mode of the first data segment
 	const Version* version = nullptr;
 	int maskPattern = -1;
 	BitMatrix matrix;
+	Content content; // content of the symbol as reported by the decoder
 };
 
 } // namespace ZXing::QRCode
@@ -11,7 +11,6 @@
 #include "GenericGF.h"
 #include "QREncodeResult.h"
 #include "QRErrorCorrectionLevel.h"
-#include "QRMaskUtil.h"
 #include "QRMatrixUtil.h"
 #include "ReedSolomonEncoder.h"
 #include "TextEncoder.h"
@@ -20,7 +19,10 @@
 #include <algorithm>
 #include <array>
 #include <limits>
+#include <numeric>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 namespace ZXing::QRCode {
 
@@ -36,22 +38,6 @@ static const std::array<int, 16 * 6> ALPHANUMERIC_TABLE = {
 	25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, -1, -1, -1, -1, -1,  // 0x50-0x5f
 };
 
-static bool IsOnlyDoubleByteKanji(const std::wstring& content)
-{
-	std::string bytes = TextEncoder::FromUnicode(content, CharacterSet::Shift_JIS);
-	size_t length = bytes.length();
-	if (length % 2 != 0) {
-		return false;
-	}
-	for (size_t i = 0; i < length; i += 2) {
-		int byte1 = bytes[i] & 0xff;
-		if ((byte1 < 0x81 || byte1 > 0x9F) && (byte1 < 0xE0 || byte1 > 0xEB)) {
-			return false;
-		}
-	}
-	return true;
-}
-
 /**
 * @return the code point of the table used in alphanumeric mode or
 *  -1 if there is no corresponding code in the table.
@@ -65,39 +51,6 @@ int GetAlphanumericCode(int code)
 	return -1;
 }
 
-/**
-* Choose the best mode by examining the content. Note that 'encoding' is used as a hint;
-* if it is Shift_JIS, and the input is only double-byte Kanji, then we return {@link Mode#KANJI}.
-*/
-ZXING_EXPORT_TEST_ONLY
-CodecMode ChooseMode(const std::wstring& content, CharacterSet encoding)
-{
-	if (encoding == CharacterSet::Shift_JIS && IsOnlyDoubleByteKanji(content)) {
-		// Choose Kanji mode if all input are double-byte characters
-		return CodecMode::KANJI;
-	}
-	bool hasNumeric = false;
-	bool hasAlphanumeric = false;
-	for (wchar_t c : content) {
-		if (c >= '0' && c <= '9') {
-			hasNumeric = true;
-		}
-		else if (GetAlphanumericCode(c) != -1) {
-			hasAlphanumeric = true;
-		}
-		else {
-			return CodecMode::BYTE;
-		}
-	}
-	if (hasAlphanumeric) {
-		return CodecMode::ALPHANUMERIC;
-	}
-	if (hasNumeric) {
-		return CodecMode::NUMERIC;
-	}
-	return CodecMode::BYTE;
-}
-
 /*
 * See ISO/IEC 18004:2015 Table 4
 */
@@ -264,17 +217,6 @@ static bool WillFit(int numInputBits, const Version& version, ErrorCorrectionLev
 	return numDataBytes >= totalInputBytes;
 }
 
-static const Version& ChooseVersion(int numInputBits, ErrorCorrectionLevel ecLevel)
-{
-	for (int versionNum = 1; versionNum <= 40; versionNum++) {
-		const Version* version = Version::Model2(versionNum);
-		if (WillFit(numInputBits, *version, ecLevel)) {
-			return *version;
-		}
-	}
-	throw std::invalid_argument("Data too big");
-}
-
 /**
 * Terminate bits as described in 8.4.8 and 8.4.9 of JISX0510:2004 (p.24).
 */
@@ -442,104 +384,259 @@ BitArray InterleaveWithECBytes(const BitArray& bits, int numTotalBytes, int numD
 }
 
 
-static int ChooseMaskPattern(const BitArray& bits, ErrorCorrectionLevel ecLevel, const Version& version, TritMatrix& matrix)
-{
-	int minPenalty = std::numeric_limits<int>::max();  // Lower penalty is better.
-	int bestMaskPattern = -1;
-	// We try all mask patterns to choose the best one.
-	for (int maskPattern = 0; maskPattern < NUM_MASK_PATTERNS; maskPattern++) {
-		BuildMatrix(bits, ecLevel, version, maskPattern, matrix);
-		int penalty = MaskUtil::CalculateMaskPenalty(matrix);
-		if (penalty < minPenalty) {
-			minPenalty = penalty;
-			bestMaskPattern = maskPattern;
-		}
-	}
-	return bestMaskPattern;
-}
-
-static int CalculateBitsNeeded(CodecMode mode, const BitArray& headerBits, const BitArray& dataBits, const Version& version)
+struct Segment
 {
-	return headerBits.size() + CharacterCountBits(mode, version) + dataBits.size();
-}
+	CodecMode mode;
+	int begin, end; // character range in the content
+};
 
 /**
-* Decides the smallest version of QR code that will contain all of the provided data.
-* @throws WriterException if the data cannot fit in any version
+* Splits the content into numeric, alphanumeric, byte and Kanji mode segments such that the number of bits is
+* minimal, see ISO/IEC 18004:2015 Annex J.2. The optimum depends on the size of the character count indicators,
+* which only changes between the version ranges 1-9, 10-26 and 27-40.
 */
-static const Version& RecommendVersion(ErrorCorrectionLevel ecLevel, CodecMode mode, const BitArray& headerBits, const BitArray& dataBits)
+class Segmentation
 {
-	// Hard part: need to know version to know how many bits length takes. But need to know how many
-	// bits it takes to know version. First we take a guess at version by assuming version will be
-	// the minimum, 1:
-	int provisionalBitsNeeded = CalculateBitsNeeded(mode, headerBits, dataBits, *Version::Model2(1));
-	const Version& provisionalVersion = ChooseVersion(provisionalBitsNeeded, ecLevel);
-
-	// Use that guess to calculate the right version. I am still not sure this works in 100% of cases.
-	int bitsNeeded = CalculateBitsNeeded(mode, headerBits, dataBits, provisionalVersion);
-	return ChooseVersion(bitsNeeded, ecLevel);
-}
+	static constexpr CodecMode MODES[] = {CodecMode::NUMERIC, CodecMode::ALPHANUMERIC, CodecMode::BYTE, CodecMode::KANJI};
+	static constexpr int MODE_COUNT = 4;
+
+	const std::wstring& _content;
+	CharacterSet _charset;
+	// the decoder interprets numeric and alphanumeric segments in the ECI charset, so they need an ASCII compatible one
+	bool _asciiCompatible;
+	std::vector<int> _byteCount; // number of bytes per character in byte mode, 0 for the 2nd half of a surrogate pair
+	std::vector<bool> _isKanji;
+
+	// bits needed to encode the character at pos in the given mode, in 1/6 bits, or -1 if not possible
+	int charCost(int m, int pos) const
+	{
+		wchar_t c = _content[pos];
+		switch (MODES[m]) {
+		case CodecMode::NUMERIC: return _asciiCompatible && c >= '0' && c <= '9' ? 20 : -1;
+		case CodecMode::ALPHANUMERIC: return _asciiCompatible && GetAlphanumericCode(c) != -1 ? 33 : -1;
+		case CodecMode::BYTE: return _byteCount[pos] * 8 * 6;
+		case CodecMode::KANJI: return _isKanji[pos] ? 13 * 6 : -1;
+		default: return -1;
+		}
+	}
 
-EncodeResult Encode(const std::wstring& content, ErrorCorrectionLevel ecLevel, CharacterSet charset, int versionNumber,
-					bool useGs1Format, int maskPattern)
-{
-	if (charset == CharacterSet::Unknown) {
-		charset = DEFAULT_BYTE_MODE_ENCODING;
+public:
+	Segmentation(const std::wstring& content, CharacterSet charset)
+		: _content(content),
+		  _charset(charset),
+		  _asciiCompatible(charset != CharacterSet::UTF16BE && charset != CharacterSet::UTF16LE && charset != CharacterSet::UTF32BE
+						   && charset != CharacterSet::UTF32LE)
+	{
+		// even ASCII characters are not necessarily single bytes (e.g. '\\' is 0x815F in Shift_JIS), so each one is looked up
+		// once in the charset
+		std::array<int, 0x80> asciiByteCount;
+		asciiByteCount.fill(-1);
+		_byteCount.resize(content.size());
+		_isKanji.resize(content.size());
+		for (size_t i = 0; i < content.size(); ++i) {
+			if (static_cast<uint32_t>(content[i]) < 0x80) {
+				auto& count = asciiByteCount[content[i]];
+				if (count < 0)
+					count = Size(TextEncoder::FromUnicode(content.substr(i, 1), charset));
+				_byteCount[i] = count;
+				continue;
+			}
+			bool isSurrogatePair = sizeof(wchar_t) == 2 && i + 1 < content.size() && (content[i] & 0xfc00) == 0xd800
+								   && (content[i + 1] & 0xfc00) == 0xdc00;
+			std::string bytes = TextEncoder::FromUnicode(content.substr(i, isSurrogatePair ? 2 : 1), charset);
+			_byteCount[i] = Size(bytes);
+			if (isSurrogatePair)
+				++i;
+			else if (charset == CharacterSet::Shift_JIS && bytes.size() == 2) {
+				int code = (bytes[0] & 0xff) << 8 | (bytes[1] & 0xff);
+				_isKanji[i] = (code >= 0x8140 && code <= 0x9ffc) || (code >= 0xe040 && code <= 0xebbf);
+			}
+		}
 	}
 
-	bool charsetIsDefault = (charset == DEFAULT_BYTE_MODE_ENCODING);
+	std::vector<Segment> optimal(const Version& version, bool withByteMode = true) const
+	{
+		constexpr int INF = std::numeric_limits<int>::max() / 2;
+		int length = Size(_content);
+		if (length == 0)
+			return {{CodecMode::BYTE, 0, 0}};
+
+		std::array<int, MODE_COUNT> header;
+		for (int m = 0; m < MODE_COUNT; ++m)
+			header[m] = (4 + CharacterCountBits(MODES[m], version)) * 6;
+
+		// cost[m]: cost of the characters so far, if the last one is encoded in mode m
+		// prev[i][m]: mode of character i - 1, if character i is encoded in mode m
+		std::array<int, MODE_COUNT> cost;
+		cost.fill(INF);
+		std::vector<std::array<int8_t, MODE_COUNT>> prev(length);
+		for (int i = 0; i < length; ++i) {
+			std::array<int, MODE_COUNT> next;
+			next.fill(INF);
+			for (int m = 0; m < MODE_COUNT; ++m) {
+				int cc = charCost(m, i);
+				if (cc < 0 || (MODES[m] == CodecMode::BYTE && !withByteMode))
+					continue;
+				// start a new segment, the open one ends with a full number of bits
+				if (i == 0) {
+					next[m] = header[m] + cc;
+					prev[i][m] = -1;
+				}
+				for (int from = 0; from < MODE_COUNT; ++from) {
+					if (cost[from] == INF)
+						continue;
+					int c = (from == m ? cost[from] : (cost[from] + 5) / 6 * 6 + header[m]) + cc;
+					if (c < next[m]) {
+						next[m] = c;
+						prev[i][m] = narrow_cast<int8_t>(from);
+					}
+				}
+			}
+			cost = next;
+		}
 
-	// Pick an encoding mode appropriate for the content. Note that this will not attempt to use
-	// multiple modes / segments even if that were more efficient. Twould be nice.
-	CodecMode mode = ChooseMode(content, charset);
+		int m = narrow_cast<int>(std::min_element(cost.begin(), cost.end()) - cost.begin());
+		if (cost[m] == INF)
+			return {};
 
-	// This will store the header information, like mode and
-	// length, as well as "header" segments like an ECI segment.
-	BitArray headerBits;
+		std::vector<Segment> res;
+		for (int i = length - 1; i >= 0; m = prev[i--][m]) {
+			if (res.empty() || res.back().mode != MODES[m])
+				res.push_back({MODES[m], i, i + 1});
+			else
+				res.back().begin = i;
+		}
+		std::reverse(res.begin(), res.end());
+		return res;
+	}
+
+	int bitCount(const std::vector<Segment>& segments, const Version& version) const
+	{
+		int bits = 0;
+		for (auto& s : segments) {
+			int n = s.end - s.begin;
+			bits += 4 + CharacterCountBits(s.mode, version);
+			switch (s.mode) {
+			case CodecMode::NUMERIC: bits += (n * 10 + 2) / 3; break;
+			case CodecMode::ALPHANUMERIC: bits += (n * 11 + 1) / 2; break;
+			case CodecMode::BYTE: bits += 8 * std::accumulate(&_byteCount[s.begin], &_byteCount[s.end], 0); break;
+			case CodecMode::KANJI: bits += 13 * n; break;
+			default: break;
+			}
+		}
+		return bits;
+	}
+
+	void appendBits(const std::vector<Segment>& segments, const Version& version, BitArray& bits) const
+	{
+		for (auto& s : segments) {
+			BitArray dataBits;
+			auto content = _content.substr(s.begin, s.end - s.begin);
+			AppendBytes(content, s.mode, _charset, dataBits);
+			AppendModeInfo(s.mode, bits);
+			AppendLengthInfo(s.mode == CodecMode::BYTE ? dataBits.sizeInBytes() : Size(content), version, s.mode, bits);
+			bits.appendBitArray(dataBits);
+		}
+	}
 
-	// Append ECI segment if applicable
-	if (mode == CodecMode::BYTE && !charsetIsDefault) {
-		AppendECI(charset, headerBits);
+	// append the text of the segments to content the way DecodeBitStream() reports it
+	void appendContent(const std::vector<Segment>& segments, Content& content) const
+	{
+		for (auto& s : segments) {
+			auto text = _content.substr(s.begin, s.end - s.begin);
+			switch (s.mode) {
+			case CodecMode::BYTE:
+				content.switchEncoding(CharacterSet::Unknown);
+				content.append(TextEncoder::FromUnicode(text, _charset));
+				break;
+			case CodecMode::KANJI:
+				content.switchEncoding(CharacterSet::Shift_JIS);
+				content.append(TextEncoder::FromUnicode(text, CharacterSet::Shift_JIS));
+				break;
+			default: // numeric and alphanumeric segments only contain ASCII characters
+				content.switchEncoding(CharacterSet::ISO8859_1);
+				content.append(TextEncoder::FromUnicode(text, CharacterSet::ISO8859_1));
+			}
+		}
 	}
 
-	// Append the FNC1 mode header for GS1 formatted data if applicable
-	if (useGs1Format) {
-		// GS1 formatted codes are prefixed with a FNC1 in first position mode header
-		AppendModeInfo(CodecMode::FNC1_FIRST_POSITION, headerBits);
+	static bool HasByteSegment(const std::vector<Segment>& segments)
+	{
+		return std::any_of(segments.begin(), segments.end(), [](auto& s) { return s.mode == CodecMode::BYTE; });
 	}
+};
 
-	// (With ECI in place,) Write the mode marker
-	AppendModeInfo(mode, headerBits);
+EncodeResult Encode(const std::wstring& content, ErrorCorrectionLevel ecLevel, CharacterSet charset, int versionNumber,
+					bool useGs1Format, int maskPattern)
+{
+	if (charset == CharacterSet::Unknown) {
+		charset = DEFAULT_BYTE_MODE_ENCODING;
+	}
 
-	// Collect data within the main segment, separately, to count its size if needed. Don't add it to
-	// main payload yet.
-	BitArray dataBits;
-	AppendBytes(content, mode, charset, dataBits);
+	bool charsetIsDefault = (charset == DEFAULT_BYTE_MODE_ENCODING);
 
-	const Version* version;
-	if (versionNumber > 0) {
-		version = Version::Model2(versionNumber);
-		if (version != nullptr) {
-			int bitsNeeded = CalculateBitsNeeded(mode, headerBits, dataBits, *version);
-			if (!WillFit(bitsNeeded, *version, ecLevel)) {
-				throw std::invalid_argument("Data too big for requested version");
+	// The ECI segment is only needed if there is a byte mode segment
+	BitArray eciBits;
+	if (!charsetIsDefault) {
+		AppendECI(charset, eciBits);
+	}
+
+	Segmentation segmentation(content, charset);
+
+	// Pick the segments with the least number of bits for the given version and return the total number of bits.
+	std::vector<Segment> segments;
+	auto chooseSegments = [&](const Version& version) {
+		segments = segmentation.optimal(version);
+		int bits = segmentation.bitCount(segments, version);
+		if (Segmentation::HasByteSegment(segments) && eciBits.size() > 0) {
+			bits += eciBits.size();
+			// the ECI segment might tip the balance towards avoiding byte mode altogether
+			if (auto segs = segmentation.optimal(version, false); !segs.empty() && segmentation.bitCount(segs, version) <= bits) {
+				segments = std::move(segs);
+				bits = segmentation.bitCount(segments, version);
 			}
 		}
-		else {
-			version = &RecommendVersion(ecLevel, mode, headerBits, dataBits);
+		return bits + (useGs1Format ? 4 : 0);
+	};
+
+	const Version* version = versionNumber > 0 ? Version::Model2(versionNumber) : nullptr;
+	if (version != nullptr) {
+		if (!WillFit(chooseSegments(*version), *version, ecLevel)) {
+			throw std::invalid_argument("Data too big for requested version");
 		}
 	}
 	else {
-		version = &RecommendVersion(ecLevel, mode, headerBits, dataBits);
+		// the size of the character count indicators only changes between the version ranges 1-9, 10-26 and 27-40
+		for (auto [first, last] : {std::pair{1, 9}, std::pair{10, 26}, std::pair{27, 40}}) {
+			int bitsNeeded = chooseSegments(*Version::Model2(first));
+			for (int versionNum = first; versionNum <= last && version == nullptr; ++versionNum) {
+				if (WillFit(bitsNeeded, *Version::Model2(versionNum), ecLevel)) {
+					version = Version::Model2(versionNum);
+				}
+			}
+			if (version != nullptr)
+				break;
+		}
+		if (version == nullptr) {
+			throw std::invalid_argument("Data too big");
+		}
 	}
 
 	BitArray headerAndDataBits;
-	headerAndDataBits.appendBitArray(headerBits);
-	// Find "length" of main segment and write it
-	int numLetters = mode == CodecMode::BYTE ? dataBits.sizeInBytes() : Size(content);
-	AppendLengthInfo(numLetters, *version, mode, headerAndDataBits);
-	// Put data together into the overall payload
-	headerAndDataBits.appendBitArray(dataBits);
+
+	// Append ECI segment if applicable
+	if (Segmentation::HasByteSegment(segments)) {
+		headerAndDataBits.appendBitArray(eciBits);
+	}
+
+	// Append the FNC1 mode header for GS1 formatted data if applicable
+	if (useGs1Format) {
+		// GS1 formatted codes are prefixed with a FNC1 in first position mode header
+		AppendModeInfo(CodecMode::FNC1_FIRST_POSITION, headerAndDataBits);
+	}
+
+	// Write the mode marker, length and data of each segment
+	segmentation.appendBits(segments, *version, headerAndDataBits);
 
 	auto& ecBlocks = version->ecBlocksForLevel(ecLevel);
 	int numDataBytes = version->totalCodewords() - ecBlocks.totalCodewords();
@@ -553,9 +650,19 @@ EncodeResult Encode(const std::wstring& content, ErrorCorrectionLevel ecLevel, C
 
 	EncodeResult output;
 	output.ecLevel = ecLevel;
-	output.mode = mode;
+	output.mode = segments.front().mode;
 	output.version = version;
 
+	// the content as a decoder reports it, so the caller does not need to read the symbol back
+	output.content.symbology = {'Q', '1', 1};
+	if (useGs1Format) {
+		output.content.symbology.modifier = '3';
+		output.content.symbology.aiFlag = AIFlag::GS1;
+	}
+	if (Segmentation::HasByteSegment(segments) && eciBits.size() > 0)
+		output.content.switchEncoding(ToECI(charset));
+	segmentation.appendContent(segments, output.content);
+
 	//  Choose the mask pattern and set to "qrCode".
 	int dimension = version->dimension();
 	TritMatrix matrix(dimension, dimension);
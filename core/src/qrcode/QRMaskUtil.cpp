@@ -7,10 +7,10 @@
 #include "QRMaskUtil.h"
 
 #include <algorithm>
-#include <array>
-#include <cassert>
+#include <cstdint>
 #include <cstdlib>
-#include <utility>
+#include <numeric>
+#include <vector>
 
 namespace ZXing::QRCode::MaskUtil {
 
@@ -21,134 +21,110 @@ static const int N3 = 40;
 static const int N4 = 10;
 
 /**
-* Helper function for applyMaskPenaltyRule1. We need this for doing this calculation in both
-* vertical and horizontal orders respectively.
+* Apply mask penalty rule 1 and 3 to one row or column and return the rule 1 penalty, the number of rule 3 patterns is
+* added to numFinderPatterns.
+*
+* Rule 1: Find repetitive cells with the same color and give penalty to them. Example: 00000 or 11111.
+*
+* Rule 3: Find consecutive runs of 1:1:3:1:1:4 starting with black, or 4:1:1:3:1:1 starting with white. If we find
+* patterns like 000010111010000, we give penalty once. Cells outside the symbol count as white.
 */
-static int ApplyMaskPenaltyRule1Internal(const TritMatrix& matrix, bool isHorizontal)
+static int ApplyMaskPenaltyRule1And3(const uint8_t* line, int size, int& numFinderPatterns)
 {
+	// Both rules are evaluated without data dependent branches, as the cells of a masked symbol are basically random.
+	// A run of n >= 5 cells gets a penalty of N1 + (n - 5) = 3 + (n - 5): 2 + 1 when reaching the 5th cell and 1 for
+	// every further cell.
+	static_assert(N1 == 3, "the branch free rule 1 evaluation below depends on N1 == 3");
 	int penalty = 0;
-	int width = matrix.width();
-	int height = matrix.height();
-	int iLimit = isHorizontal ? height : width;
-	int jLimit = isHorizontal ? width : height;
-	for (int i = 0; i < iLimit; i++) {
-		int numSameBitCells = 0;
-		int prevBit = -1;
-		for (int j = 0; j < jLimit; j++) {
-			int bit = isHorizontal ? matrix.get(j, i) : matrix.get(i, j);
-			if (bit == prevBit) {
-				numSameBitCells++;
-			}
-			else {
-				if (numSameBitCells >= 5) {
-					penalty += N1 + (numSameBitCells - 5);
-				}
-				numSameBitCells = 1;  // Include the cell itself.
-				prevBit = bit;
-			}
-		}
-		if (numSameBitCells >= 5) {
-			penalty += N1 + (numSameBitCells - 5);
-		}
-	}
-	return penalty;
-}
+	int numSameBitCells = 1;
 
-/**
-* Apply mask penalty rule 1 and return the penalty. Find repetitive cells with the same color and
-* give penalty to them. Example: 00000 or 11111.
-*/
-static int ApplyMaskPenaltyRule1(const TritMatrix& matrix)
-{
-	return ApplyMaskPenaltyRule1Internal(matrix, true) + ApplyMaskPenaltyRule1Internal(matrix, false);
-}
+	// Slide a 15 cell window (4 white + 1011101 + 4 white) over the line, padded with 4 white cells on each side.
+	// The most recent cell is in bit 0, so the finder pattern candidate is in bits 10..4.
+	unsigned window = line[0];
+	auto checkWindow = [&] {
+		numFinderPatterns += (((window >> 4) & 0x7F) == 0b1011101) & (((window >> 11) == 0) | ((window & 0xF) == 0));
+	};
 
-/**
-* Apply mask penalty rule 2 and return the penalty. Find 2x2 blocks with the same color and give
-* penalty to them. This is actually equivalent to the spec's rule, which is to find MxN blocks and give a
-* penalty proportional to (M-1)x(N-1), because this is the number of 2x2 blocks inside such a block.
-*/
-static int ApplyMaskPenaltyRule2(const TritMatrix& matrix)
-{
-	int penalty = 0;
-	for (int y = 0; y < matrix.height() - 1; y++) {
-		for (int x = 0; x < matrix.width() - 1; x++) {
-			auto value = matrix.get(x, y);
-			if (value == matrix.get(x+1, y) && value == matrix.get(x, y+1) && value == matrix.get(x+1, y+1)) {
-				penalty++;
-			}
-		}
+	for (int i = 1; i < size; i++) {
+		numSameBitCells = numSameBitCells * (line[i] == line[i - 1]) + 1;
+		penalty += (numSameBitCells >= 5) + 2 * (numSameBitCells == 5);
+
+		window = ((window << 1) | line[i]) & 0x7FFF;
+		if (i >= 10)
+			checkWindow();
+	}
+	for (int i = 0; i < 4; i++) {
+		window = (window << 1) & 0x7FFF;
+		if (size + i >= 10)
+			checkWindow();
 	}
-	return N2 * penalty;
-}
 
-template <size_t N>
-static bool HasPatternAt(const std::array<bool, N>& pattern, const Trit* begin, int count, int stride)
-{
-	assert(std::abs(count) <= (int)N);
-	auto end = begin + count * stride;
-	if (count < 0)
-		std::swap(begin, end);
-	auto a = begin;
-	for (auto b = pattern.begin(); a < end && b != pattern.end(); a += stride, ++b)
-		if (*a != *b)
-			return false;
-	return true;
+	return penalty;
 }
 
 /**
-* Apply mask penalty rule 3 and return the penalty. Find consecutive runs of 1:1:3:1:1:4
-* starting with black, or 4:1:1:3:1:1 starting with white, and give penalty to them.  If we
-* find patterns like 000010111010000, we give penalty once.
+* Apply mask penalty rule 2 to two neighboring rows and return the number of 2x2 blocks with the same color. This is
+* actually equivalent to the spec's rule, which is to find MxN blocks and give a penalty proportional to (M-1)x(N-1),
+* because this is the number of 2x2 blocks inside such a block.
 */
-static int ApplyMaskPenaltyRule3(const TritMatrix& matrix)
+static int ApplyMaskPenaltyRule2(const uint8_t* row0, const uint8_t* row1, int width)
 {
-	const std::array<bool, 4> white = {0, 0, 0, 0};
-	const std::array<bool, 7> finder = {1, 0, 1, 1, 1, 0, 1};
-	const int whiteSize = Size(white);
-	const int finderSize = Size(finder);
-
-	int numPenalties = 0;
-	int width = matrix.width();
-	int height = matrix.height();
-	for (int y = 0; y < height; y++) {
-		for (int x = 0; x < width; x++) {
-			auto i = &matrix.get(x, y);
-			if (x <= width - finderSize && HasPatternAt(finder, i, finderSize, 1)
-				&& (HasPatternAt(white, i, -std::min(x, whiteSize), 1)
-					|| HasPatternAt(white, i + finderSize, std::min(width - x - finderSize, whiteSize), 1))) {
-				numPenalties++;
-			}
-			if (y <= height - finderSize && HasPatternAt(finder, i, finderSize, width)
-				&& (HasPatternAt(white, i, -std::min(y, whiteSize), width)
-					|| HasPatternAt(white, i + finderSize * width, std::min(height - y - finderSize, whiteSize), width))) {
-				numPenalties++;
-			}
-		}
+	int count = 0;
+	for (int x = 0; x < width - 1; x++) {
+		int sum = row0[x] + row0[x + 1] + row1[x] + row1[x + 1];
+		count += (sum == 0) | (sum == 4);
 	}
-	return numPenalties * N3;
+	return count;
 }
 
 /**
 * Apply mask penalty rule 4 and return the penalty. Calculate the ratio of dark cells and give
 * penalty if the ratio is far from 50%. It gives 10 penalty for 5% distance.
 */
-static int ApplyMaskPenaltyRule4(const TritMatrix& matrix)
+static int ApplyMaskPenaltyRule4(int numDarkCells, int numTotalCells)
 {
-	auto numDarkCells = std::count_if(matrix.begin(), matrix.end(), [](Trit cell) { return cell; });
-	auto numTotalCells = matrix.size();
 	auto fivePercentVariances = std::abs(numDarkCells * 2 - numTotalCells) * 10 / numTotalCells;
-	return narrow_cast<int>(fivePercentVariances * N4);
+	return fivePercentVariances * N4;
 }
 
 // The mask penalty calculation is complicated.  See Table 21 of JISX0510:2004 (p.45) for details.
-// Basically it applies four rules and summate all penalties.
+// Basically it applies four rules and summate all penalties. All rules are evaluated together in one pass over the
+// rows and one pass over the columns (rows of the transposed matrix).
+int CalculateMaskPenalty(const Matrix<uint8_t>& matrix)
+{
+	const int width = matrix.width();
+	const int height = matrix.height();
+	if (width == 0 || height == 0)
+		return 0;
+
+	int penalty = 0;
+	int numBlocks = 0;
+	int numFinderPatterns = 0;
+	int numDarkCells = 0;
+	std::vector<uint8_t> column(height);
+
+	for (int y = 0; y < height; y++) {
+		const uint8_t* row = matrix.begin() + y * width;
+		penalty += ApplyMaskPenaltyRule1And3(row, width, numFinderPatterns);
+		if (y < height - 1)
+			numBlocks += ApplyMaskPenaltyRule2(row, row + width, width);
+		numDarkCells += std::accumulate(row, row + width, 0);
+	}
+
+	for (int x = 0; x < width; x++) {
+		for (int y = 0; y < height; y++)
+			column[y] = matrix.begin()[y * width + x];
+		penalty += ApplyMaskPenaltyRule1And3(column.data(), height, numFinderPatterns);
+	}
+
+	return penalty + N2 * numBlocks + N3 * numFinderPatterns + ApplyMaskPenaltyRule4(numDarkCells, width * height);
+}
+
 int CalculateMaskPenalty(const TritMatrix& matrix)
 {
-	return MaskUtil::ApplyMaskPenaltyRule1(matrix)
-		   + MaskUtil::ApplyMaskPenaltyRule2(matrix)
-		   + MaskUtil::ApplyMaskPenaltyRule3(matrix)
-		   + MaskUtil::ApplyMaskPenaltyRule4(matrix);
+	Matrix<uint8_t> bits(matrix.width(), matrix.height());
+	std::transform(matrix.begin(), matrix.end(), bits.begin(), [](Trit cell) { return uint8_t(bool(cell)); });
+	return CalculateMaskPenalty(bits);
 }
 
 } // namespace ZXing::QRCode::MaskUtil
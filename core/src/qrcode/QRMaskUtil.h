@@ -8,8 +8,11 @@
 
 #include "TritMatrix.h"
 
+#include <cstdint>
+
 namespace ZXing::QRCode::MaskUtil {
 
 int CalculateMaskPenalty(const TritMatrix& matrix);
+int CalculateMaskPenalty(const Matrix<uint8_t>& matrix); // matrix of 0/1 values
 
 } // namespace ZXing::QRCode::MaskUtil
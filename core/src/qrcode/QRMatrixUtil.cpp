@@ -10,10 +10,15 @@
 #include "BitHacks.h"
 #include "QRDataMask.h"
 #include "QRErrorCorrectionLevel.h"
+#include "QRMaskUtil.h"
 #include "QRVersion.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <limits>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 namespace ZXing::QRCode {
 
@@ -294,11 +299,9 @@ static void EmbedDataBits(const BitArray& dataBits, int maskPattern, TritMatrix&
 	}
 }
 
-// Build 2D matrix of QR Code from "dataBits" with "ecLevel", "version" and "getMaskPattern". On
-// success, store the result in "matrix" and return true.
-void BuildMatrix(const BitArray& dataBits, ErrorCorrectionLevel ecLevel, const Version& version, int maskPattern, TritMatrix& matrix)
+// Embed the function patterns that do not depend on the data, the ec level or the mask pattern.
+static void EmbedBasicPatterns(const Version& version, TritMatrix& matrix)
 {
-	matrix.clear();
 	// Let's get started with embedding big squares at corners.
 	EmbedPositionDetectionPatternsAndSeparators(matrix);
 	// Then, embed the dark dot at the left bottom corner.
@@ -307,6 +310,14 @@ void BuildMatrix(const BitArray& dataBits, ErrorCorrectionLevel ecLevel, const V
 	EmbedPositionAdjustmentPatterns(version, matrix);
 	// Timing patterns should be embedded after position adj. patterns.
 	EmbedTimingPatterns(matrix);
+}
+
+// Build 2D matrix of QR Code from "dataBits" with "ecLevel", "version" and "getMaskPattern". On
+// success, store the result in "matrix" and return true.
+void BuildMatrix(const BitArray& dataBits, ErrorCorrectionLevel ecLevel, const Version& version, int maskPattern, TritMatrix& matrix)
+{
+	matrix.clear();
+	EmbedBasicPatterns(version, matrix);
 	// Type information appear with any version.
 	EmbedTypeInfo(ecLevel, maskPattern, matrix);
 	// Version info appear if version >= 7.
@@ -315,4 +326,51 @@ void BuildMatrix(const BitArray& dataBits, ErrorCorrectionLevel ecLevel, const V
 	EmbedDataBits(dataBits, maskPattern, matrix);
 }
 
+int ChooseMaskPattern(const BitArray& dataBits, ErrorCorrectionLevel ecLevel, const Version& version, TritMatrix& matrix)
+{
+	// Lay out the function patterns and the unmasked data bits only once, the type info is overwritten for each mask.
+	matrix.clear();
+	EmbedBasicPatterns(version, matrix);
+	EmbedTypeInfo(ecLevel, 0, matrix);
+	EmbedVersionInfo(version, matrix);
+
+	const int width = matrix.width();
+	const int height = matrix.height();
+	Matrix<uint8_t> isData(width, height);
+	std::transform(matrix.begin(), matrix.end(), isData.begin(), [](Trit cell) { return uint8_t(cell.isEmpty()); });
+
+	EmbedDataBits(dataBits, -1, matrix);
+
+	// All mask patterns repeat every 12 rows, so masking a row is an AND with one of 12 precomputed rows and an XOR.
+	constexpr int MASK_PERIOD = 12;
+	std::vector<uint8_t> maskRows(MASK_PERIOD * width);
+	Matrix<uint8_t> masked(width, height);
+
+	int minPenalty = std::numeric_limits<int>::max(); // Lower penalty is better.
+	int bestMaskPattern = -1;
+	for (int maskPattern = 0; maskPattern < NUM_MASK_PATTERNS; maskPattern++) {
+		EmbedTypeInfo(ecLevel, maskPattern, matrix);
+
+		for (int y = 0; y < MASK_PERIOD; ++y)
+			for (int x = 0; x < width; ++x)
+				maskRows[y * width + x] = GetDataMaskBit(maskPattern, x, y);
+
+		for (int y = 0; y < height; ++y) {
+			const Trit* src = matrix.begin() + y * width;
+			const uint8_t* data = isData.begin() + y * width;
+			const uint8_t* mask = maskRows.data() + (y % MASK_PERIOD) * width;
+			uint8_t* dst = masked.begin() + y * width;
+			for (int x = 0; x < width; ++x)
+				dst[x] = uint8_t(bool(src[x])) ^ (data[x] & mask[x]);
+		}
+
+		int penalty = MaskUtil::CalculateMaskPenalty(masked);
+		if (penalty < minPenalty) {
+			minPenalty = penalty;
+			bestMaskPattern = maskPattern;
+		}
+	}
+	return bestMaskPattern;
+}
+
 } // namespace ZXing::QRCode
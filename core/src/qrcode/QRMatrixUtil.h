@@ -21,5 +21,8 @@ constexpr int NUM_MASK_PATTERNS = 8;
 
 void BuildMatrix(const BitArray& dataBits, ErrorCorrectionLevel ecLevel, const Version& version, int maskPattern, TritMatrix& matrix);
 
+// Return the mask pattern with the lowest penalty, matrix is used as scratch space.
+int ChooseMaskPattern(const BitArray& dataBits, ErrorCorrectionLevel ecLevel, const Version& version, TritMatrix& matrix);
+
 } // QRCode
 } // ZXing
@@ -356,9 +356,9 @@ int runBlackBoxTests(const fs::path& testPathPrefix, const std::set<std::string>
 #ifdef ZXING_WITH_DATAMATRIX
 		runTests("datamatrix-1", "DataMatrix", 29, {
 			{ 29, 29, 0   },
-			{  0, 27, 90  },
-			{  0, 27, 180 },
-			{  0, 27, 270 },
+			{  0, 29, 90  },
+			{  0, 29, 180 },
+			{  0, 29, 270 },
 			{ 28, 0, pure },
 		});
 
@@ -572,7 +572,7 @@ int runBlackBoxTests(const fs::path& testPathPrefix, const std::set<std::string>
 		});
 
 		runTests("maxicode-2", "MaxiCode", 4, {
-			{ 0, 0, 0 },
+			{ 4, 4, 0 },
 		});
 #endif
 #ifdef ZXING_WITH_QRCODE
@@ -0,0 +1,69 @@
+/*
+* Copyright 2026 ZXing authors
+*/
+// SPDX-License-Identifier: Apache-2.0
+
+#include "BitMatrixIO.h"
+#include "PseudoRandom.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+
+using namespace ZXing;
+
+// Paint the rectangles of the path written by ToSVG into a matrix, fails on overlapping rectangles.
+static BitMatrix FromSVGPath(const std::string& svg, int width, int height)
+{
+	BitMatrix res(width, height);
+	auto begin = svg.find("d=\"");
+	EXPECT_NE(begin, std::string::npos);
+	const char* p = svg.c_str() + begin + 3;
+	int px = 0, py = 0;
+	while (*p != '"') {
+		int x, y, w, h, w2;
+		char* end;
+		EXPECT_TRUE(*p == 'M' || *p == 'm');
+		x = std::strtol(p + 1, &end, 10), p = end;
+		EXPECT_EQ(*p, ',');
+		y = std::strtol(p + 1, &end, 10), p = end;
+		EXPECT_EQ(*p, 'h');
+		w = std::strtol(p + 1, &end, 10), p = end;
+		EXPECT_EQ(*p, 'v');
+		h = std::strtol(p + 1, &end, 10), p = end;
+		EXPECT_EQ(*p, 'h');
+		w2 = std::strtol(p + 1, &end, 10), p = end;
+		EXPECT_EQ(*p++, 'z');
+		EXPECT_EQ(w, -w2);
+		px += x, py += y;
+		for (int dy = 0; dy < h; ++dy)
+			for (int dx = 0; dx < w; ++dx) {
+				EXPECT_FALSE(res.get(px + dx, py + dy));
+				res.set(px + dx, py + dy);
+			}
+	}
+	return res;
+}
+
+TEST(BitMatrixIOTest, ToSVG)
+{
+	auto m = ParseBitMatrix("X X X   \n"
+							"X X X   \n"
+							"  X X X \n"
+							"X     X \n", 'X', true);
+	auto svg = ToSVG(m);
+	EXPECT_EQ(svg, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+				   "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\" viewBox=\"0 0 4 4\" stroke=\"none\">\n"
+				   "<path d=\"M0,0h3v2h-3zm1,2h3v1h-3zm-1,1h1v1h-1zm3,0h1v1h-1z\"/>\n</svg>");
+
+	PseudoRandom rand(42);
+	for (int i = 0; i < 20; ++i) {
+		int width = rand.next(1, 40), height = rand.next(1, 40);
+		BitMatrix bits(width, height);
+		for (int y = 0; y < height; ++y)
+			for (int x = 0; x < width; ++x)
+				if (rand.next(0, 2))
+					bits.set(x, y);
+		EXPECT_EQ(FromSVGPath(ToSVG(bits), width, height), bits);
+	}
+}
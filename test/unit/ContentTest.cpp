@@ -25,7 +25,7 @@ TEST(ContentTest, Base)
 {
 	{ // Null
 		Content c;
-#if defined(ZXING_READERS) || (defined(ZXING_EXPERIMENTAL_API) && defined(ZXING_USE_ZINT))
+#if defined(ZXING_READERS) || (defined(ZXING_EXPERIMENTAL_API) && (defined(ZXING_USE_ZINT) || defined(ZXING_USE_BUILTIN_WRITERS)))
 		EXPECT_EQ(c.guessEncoding(), CharacterSet::Unknown);
 #else
 		EXPECT_EQ(c.guessEncoding(), CharacterSet::ISO8859_1);
@@ -34,7 +34,7 @@ TEST(ContentTest, Base)
 		EXPECT_TRUE(c.empty());
 	}
 
-#if defined(ZXING_READERS) || (defined(ZXING_EXPERIMENTAL_API) && defined(ZXING_USE_ZINT))
+#if defined(ZXING_READERS) || (defined(ZXING_EXPERIMENTAL_API) && (defined(ZXING_USE_ZINT) || defined(ZXING_USE_BUILTIN_WRITERS)))
 	{ // set latin1
 		Content c;
 		c.switchEncoding(CharacterSet::ISO8859_1);
@@ -73,7 +73,7 @@ TEST(ContentTest, Base)
 #endif
 }
 
-#if defined(ZXING_READERS) || (defined(ZXING_EXPERIMENTAL_API) && defined(ZXING_USE_ZINT))
+#if defined(ZXING_READERS) || (defined(ZXING_EXPERIMENTAL_API) && (defined(ZXING_USE_ZINT) || defined(ZXING_USE_BUILTIN_WRITERS)))
 TEST(ContentTest, GuessEncoding)
 {
 	{ // guess latin1
@@ -99,7 +99,7 @@ TEST(ContentTest, GuessEncoding)
 }
 #endif
 
-#if defined(ZXING_READERS) || (defined(ZXING_EXPERIMENTAL_API) && defined(ZXING_USE_ZINT))
+#if defined(ZXING_READERS) || (defined(ZXING_EXPERIMENTAL_API) && (defined(ZXING_USE_ZINT) || defined(ZXING_USE_BUILTIN_WRITERS)))
 TEST(ContentTest, ECI)
 {
 	{ // switch to ECI::ISO8859_5
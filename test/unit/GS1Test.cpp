@@ -350,3 +350,26 @@ TEST(HRIFromGS1, MultiVariable)
 {
 	EXPECT_EQ(HRIFromGS1("70041234\x1d""81111234"), "(7004)1234(8111)1234");
 }
+
+TEST(ParseGS1, Elements)
+{
+	std::string_view gs1 = "0101234567890128" "10ABC123\x1d" "3103001234" "8200http://example.com";
+	auto elements = ParseGS1(gs1);
+	ASSERT_EQ(elements.size(), 4u);
+	EXPECT_EQ(elements[0].ai, "01");
+	EXPECT_EQ(elements[0].value, "01234567890128");
+	EXPECT_EQ(elements[1].ai, "10");
+	EXPECT_EQ(elements[1].value, "ABC123");
+	EXPECT_EQ(elements[2].ai, "3103");
+	EXPECT_EQ(elements[2].value, "001234");
+	EXPECT_EQ(elements[3].ai, "8200");
+	EXPECT_EQ(elements[3].value, "http://example.com");
+
+	// the elements are views into the input string
+	EXPECT_EQ(elements[1].value.data(), gs1.data() + 18);
+
+	EXPECT_TRUE(ParseGS1("").empty());
+	EXPECT_TRUE(ParseGS1("0101234567890128" "1").empty()); // incomplete second element
+	EXPECT_TRUE(ParseGS1("0101234567890128" "23").empty()); // unknown AI
+	EXPECT_TRUE(ParseGS1("A101234567890128").empty()); // non-digit AI
+}
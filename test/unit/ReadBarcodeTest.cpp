@@ -0,0 +1,56 @@
+/*
+* Copyright 2026 ZXing authors
+*/
+// SPDX-License-Identifier: Apache-2.0
+
+#include "BitMatrix.h"
+#include "ReadBarcode.h"
+#include "datamatrix/DMWriter.h"
+
+#include "gtest/gtest.h"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace ZXing;
+
+#ifdef ZXING_WITH_DATAMATRIX
+
+TEST(ReadBarcodeTest, ReadBarcodesBatch)
+{
+	// images of different sizes, so the reused buffers of the workers need to grow and shrink
+	std::vector<Matrix<uint8_t>> images;
+	for (int i = 0; i < 20; ++i) {
+		auto symbol = ToMatrix<uint8_t>(DataMatrix::Writer().setMargin(0).encode(L"Image " + std::to_wstring(i), 0, 0));
+		int scale = 2 + i % 5;
+		Matrix<uint8_t> image(scale * symbol.width() + 20 + i, scale * symbol.height() + 20, 255);
+		for (int y = 0; y < scale * symbol.height(); ++y)
+			for (int x = 0; x < scale * symbol.width(); ++x)
+				image.set(10 + x, 10 + y, symbol.get(x / scale, y / scale));
+		images.push_back(std::move(image));
+	}
+	// an image without any symbol
+	images.emplace_back(50, 50, 255);
+
+	std::vector<ImageView> views;
+	for (auto& image : images)
+		views.emplace_back(image.data(), image.width(), image.height(), ImageFormat::Lum);
+
+	auto opts = ReaderOptions().setFormats(BarcodeFormat::DataMatrix);
+	for (int numThreads : {1, 4, 100}) {
+		auto results = ReadBarcodesBatch(views, opts, numThreads);
+		ASSERT_EQ(results.size(), views.size());
+		for (int i = 0; i < 20; ++i) {
+			ASSERT_EQ(results[i].size(), 1) << "image " << i;
+			EXPECT_EQ(results[i][0].text(), "Image " + std::to_string(i));
+		}
+		EXPECT_TRUE(results.back().empty());
+	}
+
+	EXPECT_TRUE(ReadBarcodesBatch({}, opts).empty());
+	views.emplace_back(nullptr, 0, 0, ImageFormat::Lum);
+	EXPECT_THROW(ReadBarcodesBatch(views, opts, 4), std::invalid_argument);
+}
+
+#endif // ZXING_WITH_DATAMATRIX
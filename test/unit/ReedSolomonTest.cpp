@@ -4,12 +4,16 @@
 */
 // SPDX-License-Identifier: Apache-2.0
 
+#include "GF256.h"
 #include "GenericGF.h"
 #include "PseudoRandom.h"
 #include "ReedSolomonDecoder.h"
 #include "ReedSolomonEncoder.h"
 
 #include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <numeric>
 #include <ostream>
 
 static std::ostream& operator<<(std::ostream& out, const ZXing::GenericGF& field) {
@@ -21,6 +25,12 @@ static std::ostream& operator<<(std::ostream& out, const ZXing::GenericGF& field
 
 using namespace ZXing;
 
+namespace ZXing {
+bool ReedSolomonDecodeEuclidean(const GenericGF& field, std::vector<int>& message, int numECCodeWords, const std::vector<int>& erasures);
+bool ReedSolomonDecodeBerlekampMassey(const GF256& gf, int generatorBase, std::vector<int>& message, int numECCodeWords,
+									  const std::vector<int>& erasures);
+} // namespace ZXing
+
 namespace {
 	static const int DECODER_RANDOM_TEST_ITERATIONS = 2;
 	static const int DECODER_TEST_ITERATIONS = 4;
@@ -494,3 +504,135 @@ TEST(ReedSolomonTest, Aztec)
 	TestEncodeDecodeRandom(GenericGF::AztecData10(), 768, 255);
 	TestEncodeDecodeRandom(GenericGF::AztecData12(), 3072, 1023);
 }
+
+TEST(ReedSolomonTest, Erasures)
+{
+	const auto& field = GenericGF::QRCodeField256();
+	const int numData = 40, numEC = 20;
+	PseudoRandom random(0x12345678);
+	std::vector<int> encoded(numData + numEC);
+	for (int i = 0; i < numData; ++i)
+		encoded[i] = random.next(0, 255);
+	ReedSolomonEncode(field, encoded, numEC);
+
+	// each erasure costs one EC codeword, each unknown error two
+	for (int numErasures = 0; numErasures <= numEC; ++numErasures) {
+		int numErrors = (numEC - numErasures) / 2;
+		auto message = encoded;
+		std::vector<int> erasures;
+		for (int i = 0; i < numErasures; ++i) {
+			erasures.push_back(3 * i);
+			message[3 * i] = 0;
+		}
+		for (int i = 0; i < numErrors; ++i)
+			message[3 * i + 1] ^= 0x55;
+
+		EXPECT_TRUE(ReedSolomonDecode(field, message, numEC, erasures)) << numErasures << " erasures, " << numErrors << " errors";
+		EXPECT_EQ(message, encoded) << numErasures << " erasures, " << numErrors << " errors";
+	}
+
+	// more erasures than EC codewords can not be corrected
+	auto message = encoded;
+	std::vector<int> erasures(numEC + 1);
+	std::iota(erasures.begin(), erasures.end(), 0);
+	EXPECT_FALSE(ReedSolomonDecode(field, message, numEC, erasures));
+
+	// without knowing the erasures, the same number of wrong codewords is not correctable
+	message = encoded;
+	for (int i = 0; i < numEC; ++i)
+		message[3 * i] ^= 0x55;
+	EXPECT_FALSE(ReedSolomonDecode(field, message, numEC));
+}
+
+TEST(ReedSolomonTest, GF256SolversAgree)
+{
+	PseudoRandom random(0x12345678);
+	for (auto field : {&GenericGF::QRCodeField256(), &GenericGF::DataMatrixField256()}) {
+		auto gf = GF256::Of(*field);
+		ASSERT_NE(gf, nullptr);
+		for (auto [numData, numEC] : {std::pair{19, 7}, {16, 10}, {118, 30}, {3, 5}, {200, 55}}) {
+			std::vector<int> encoded(numData + numEC);
+			for (int i = 0; i < numData; ++i)
+				encoded[i] = random.next(0, 255);
+			ReedSolomonEncode(*field, encoded, numEC);
+
+			// up to numEC errors, i.e. also way beyond what can be corrected
+			for (int numErrors = 0; numErrors <= numEC; ++numErrors) {
+				auto m1 = encoded;
+				Corrupt(m1, numErrors, random, 256);
+				auto m2 = m1;
+				bool r1 = ReedSolomonDecodeEuclidean(*field, m1, numEC, {});
+				bool r2 = ReedSolomonDecodeBerlekampMassey(*gf, field->generatorBase(), m2, numEC, {});
+				EXPECT_EQ(r1, r2) << *field << " (" << numData << ',' << numEC << ") " << numErrors << " errors";
+				if (r1 && r2) {
+					EXPECT_EQ(m1, m2);
+				}
+				if (2 * numErrors <= numEC) {
+					EXPECT_TRUE(r2 && m2 == encoded);
+				}
+			}
+		}
+	}
+}
+
+// run with --gtest_also_run_disabled_tests
+TEST(ReedSolomonTest, DISABLED_BenchmarkGF256)
+{
+	using namespace std::chrono;
+	const auto& field = GenericGF::QRCodeField256();
+	const auto& gf = *GF256::Of(field);
+	PseudoRandom random(0x12345678);
+
+	// QR code version 40-L block: 118 data, 30 EC codewords
+	const int numData = 118, numEC = 30, iterations = 20000;
+	std::vector<int> encoded(numData + numEC);
+	for (int i = 0; i < numData; ++i)
+		encoded[i] = random.next(0, 255);
+	ReedSolomonEncode(field, encoded, numEC);
+
+	for (int numErrors : {0, 1, 5, numEC / 2}) {
+		auto corrupted = encoded;
+		Corrupt(corrupted, numErrors, random, 256);
+
+		auto bench = [&](auto decode) {
+			auto start = steady_clock::now();
+			for (int i = 0; i < iterations; ++i) {
+				auto m = corrupted;
+				EXPECT_TRUE(decode(m));
+			}
+			return duration_cast<nanoseconds>(steady_clock::now() - start).count() / iterations;
+		};
+		auto euclid = bench([&](auto& m) { return ReedSolomonDecodeEuclidean(field, m, numEC, {}); });
+		auto bm = bench([&](auto& m) { return ReedSolomonDecodeBerlekampMassey(gf, field.generatorBase(), m, numEC, {}); });
+		std::cout << numErrors << " errors: Euclidean " << euclid << " ns, Berlekamp-Massey " << bm << " ns" << std::endl;
+	}
+}
+
+TEST(ReedSolomonTest, ByteArrayInPlace)
+{
+	const auto& field = GenericGF::DataMatrixField256();
+	const int numData = 30, numEC = 12;
+	PseudoRandom random(0x12345678);
+	std::vector<int> encoded(numData + numEC);
+	for (int i = 0; i < numData; ++i)
+		encoded[i] = random.next(0, 255);
+	ReedSolomonEncode(field, encoded, numEC);
+	ByteArray expected(Size(encoded));
+	std::copy(encoded.begin(), encoded.end(), expected.begin());
+
+	auto message = expected;
+	EXPECT_TRUE(ReedSolomonDecode(field, message, numEC));
+	EXPECT_EQ(message, expected);
+
+	for (int i = 0; i < numEC / 2; ++i)
+		message[5 * i] ^= 0xA5;
+	EXPECT_TRUE(ReedSolomonDecode(field, message, numEC));
+	EXPECT_EQ(message, expected);
+
+	// a message that can not be corrected stays untouched
+	for (int i = 0; i < numEC; ++i)
+		message[3 * i] ^= 0x5A;
+	auto corrupted = message;
+	EXPECT_FALSE(ReedSolomonDecode(field, message, numEC));
+	EXPECT_EQ(message, corrupted);
+}
@@ -4,12 +4,16 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "CharacterSet.h"
+#include "Content.h"
+#include "PseudoRandom.h"
 #include "TextDecoder.h"
 #include "Utf.h"
 
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 
+#include <chrono>
+
 using namespace ZXing;
 using namespace testing;
 
@@ -219,3 +223,80 @@ TEST(TextDecoderTest, AppendUTF16BE)
 		EXPECT_EQ(ToUtf8(str), "𐀀");
 	}
 }
+
+static ByteView AsBytes(std::string_view str)
+{
+	return {reinterpret_cast<const uint8_t*>(str.data()), str.size()};
+}
+
+TEST(TextDecoderTest, AsciiAndUtf8PrefixLength)
+{
+	std::string ascii(100, 'a');
+	EXPECT_EQ(AsciiPrefixLength({}), 0);
+	EXPECT_EQ(AsciiPrefixLength(AsBytes(ascii)), 100);
+	for (int i : {0, 7, 15, 16, 17, 50, 99}) {
+		auto str = ascii;
+		str[i] = '\xC3';
+		EXPECT_EQ(AsciiPrefixLength(AsBytes(str)), i);
+	}
+
+	EXPECT_EQ(Utf8PrefixLength({}), 0);
+	EXPECT_EQ(Utf8PrefixLength(AsBytes(ascii)), 100);
+	EXPECT_EQ(Utf8PrefixLength(AsBytes("aäb€c𐀀")), 12);
+	EXPECT_EQ(Utf8PrefixLength(AsBytes("ab\xC3")), 2);          // truncated
+	EXPECT_EQ(Utf8PrefixLength(AsBytes("ab\xC3" "c")), 2);      // missing continuation byte
+	EXPECT_EQ(Utf8PrefixLength(AsBytes("ab\xC0\x80")), 2);      // overlong
+	EXPECT_EQ(Utf8PrefixLength(AsBytes("ab\xE0\x80\x80")), 2);  // overlong
+	EXPECT_EQ(Utf8PrefixLength(AsBytes("ab\xED\xA0\x80")), 2);  // surrogate
+	EXPECT_EQ(Utf8PrefixLength(AsBytes("ab\xF4\x90\x80\x80")), 2); // > U+10FFFF
+	EXPECT_EQ(Utf8PrefixLength(AsBytes("ab\x80")), 2);          // lone continuation byte
+}
+
+TEST(TextDecoderTest, AppendMixedPrefix)
+{
+	// the leading ASCII/UTF-8 part is copied, the rest is transcoded
+	const uint8_t data[] = {'a', 'b', 'c', 0xC3, 0xA4, 0xFF, 'd'};
+	EXPECT_EQ(BytesToUtf8(data, CharacterSet::ISO8859_1), "abcÃ¤ÿd");
+	EXPECT_EQ(BytesToUtf8(data, CharacterSet::UTF8), "abcä\xEF\xBF\xBD" "d");
+	EXPECT_EQ(BytesToUtf8(data, CharacterSet::BINARY), "abcÃ¤ÿd");
+
+	std::string utf8 = "x";
+	AppendUtf8(utf8, data, ECI::UTF8);
+	AppendUtf8(utf8, ByteView(data, 3), ECI::UTF16BE);
+	EXPECT_EQ(utf8, "xabcä\xEF\xBF\xBD" "d" "慢\xEF\xBF\xBD");
+}
+
+// run with --gtest_also_run_disabled_tests
+TEST(TextDecoderTest, DISABLED_BenchmarkTextExtraction)
+{
+	using namespace std::chrono;
+	PseudoRandom random(0x12345678);
+	const int size = 4000, iterations = 5000;
+
+	ByteArray ascii(size), latin1(size), sjis(size), binary(size);
+	for (int i = 0; i < size; ++i) {
+		ascii[i] = random.next(0x20, 0x7E);
+		latin1[i] = i % 20 ? ascii[i] : 0xE9;
+		sjis[i] = i % 2 ? 0x65 : 0x83; // katakana 'te'
+		binary[i] = random.next(0, 255);
+	}
+
+	auto bench = [&](auto func) {
+		auto start = steady_clock::now();
+		for (int i = 0; i < iterations; ++i)
+			func();
+		return duration_cast<nanoseconds>(steady_clock::now() - start).count() / iterations;
+	};
+
+	for (auto& [name, bytes] : {std::pair{"ASCII", ascii}, {"Latin1", latin1}, {"Shift_JIS", sjis}, {"binary", binary}}) {
+		Content c;
+		c.append(bytes);
+		CharacterSet cs = c.guessEncoding();
+		std::size_t sum = 0;
+		auto guess = bench([&] { sum += static_cast<int>(c.guessEncoding()); });
+		auto decode = bench([&] { sum += BytesToUtf8(bytes, cs).size(); });
+		std::cout << name << " (" << ToString(cs) << "): guessEncoding " << guess << " ns, BytesToUtf8 " << decode << " ns"
+				  << std::endl;
+		EXPECT_GT(sum, 0);
+	}
+}
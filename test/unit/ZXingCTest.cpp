@@ -0,0 +1,211 @@
+/*
+* Copyright 2026 ZXing authors
+*/
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ZXingC.h"
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+static std::string LastErrorMsg()
+{
+	char* msg = ZXing_LastErrorMsg();
+	std::string res = msg ? msg : "";
+	ZXing_free(msg);
+	return res;
+}
+
+TEST(ZXingCTest, ParseGS1)
+{
+	const char* gs1 = "0101234567890128" "10ABC123\x1d" "3103001234";
+	int len = static_cast<int>(strlen(gs1));
+	ZXing_GS1Element elements[2] = {};
+
+	// the result is the total number of elements, only maxElements of them are stored
+	ASSERT_EQ(ZXing_ParseGS1(gs1, len, elements, 2), 3);
+	EXPECT_EQ(std::string(gs1 + elements[0].aiPos, elements[0].aiLen), "01");
+	EXPECT_EQ(std::string(gs1 + elements[0].valuePos, elements[0].valueLen), "01234567890128");
+	EXPECT_EQ(std::string(gs1 + elements[1].aiPos, elements[1].aiLen), "10");
+	EXPECT_EQ(std::string(gs1 + elements[1].valuePos, elements[1].valueLen), "ABC123");
+	EXPECT_EQ(ZXing_ParseGS1(gs1, len, nullptr, 0), 3);
+	EXPECT_EQ(ZXing_ParseGS1(gs1, 0, nullptr, 0), 0);
+
+	EXPECT_EQ(ZXing_ParseGS1("0101234567890128" "23", 18, elements, 2), -1); // unknown AI
+	EXPECT_EQ(LastErrorMsg(), "Invalid GS1 element string");
+	EXPECT_EQ(ZXing_ParseGS1(gs1, len, nullptr, 2), -1);
+	EXPECT_EQ(LastErrorMsg(), "Invalid GS1 string or elements param");
+	EXPECT_EQ(ZXing_ParseGS1(nullptr, 0, elements, 2), -1);
+}
+
+#ifdef ZXING_EXPERIMENTAL_API
+
+TEST(ZXingCTest, WriteBarcodeInvalidImageFormat)
+{
+	auto cOpts = ZXing_CreatorOptions_new(ZXing_BarcodeFormat_QRCode);
+	auto barcode = ZXing_CreateBarcodeFromText("Hello", 0, cOpts);
+	ASSERT_NE(barcode, nullptr);
+
+	auto wOpts = ZXing_WriterOptions_new();
+	ZXing_WriterOptions_setImageFormat(wOpts, ZXing_ImageFormat_None);
+	EXPECT_EQ(ZXing_WriteBarcodeToImage(barcode, wOpts), nullptr);
+	EXPECT_EQ(LastErrorMsg(), "Invalid image format for writing barcodes");
+
+	uint8_t buffer[64 * 64];
+	EXPECT_FALSE(ZXing_WriteBarcodeToBuffer(barcode, wOpts, buffer, sizeof(buffer), 0, nullptr, nullptr));
+	EXPECT_EQ(LastErrorMsg(), "Invalid image format for writing barcodes");
+
+	// the bitmap output ignores the image format
+	int width = 0, height = 0;
+	EXPECT_TRUE(ZXing_WriteBarcodeToBitmap(barcode, wOpts, nullptr, 0, 0, &width, &height));
+	EXPECT_GT(width, 0);
+	EXPECT_EQ(width, height);
+
+	ZXing_WriterOptions_delete(wOpts);
+	ZXing_Barcode_delete(barcode);
+	ZXing_CreatorOptions_delete(cOpts);
+}
+
+static std::string Text(const ZXing_Barcode* barcode)
+{
+	char* text = ZXing_Barcode_text(barcode);
+	std::string res = text ? text : "";
+	ZXing_free(text);
+	return res;
+}
+
+TEST(ZXingCTest, CreateBarcodesFromTexts)
+{
+	auto cOpts = ZXing_CreatorOptions_new(ZXing_BarcodeFormat_QRCode);
+	const char* data[] = {"first", "second payload", "3"};
+
+	// without sizes, the texts are NUL terminated, the results are in the order of the input
+	for (int numThreads : {1, 0}) {
+		auto barcodes = ZXing_CreateBarcodesFromTexts(data, nullptr, 3, cOpts, numThreads);
+		ASSERT_NE(barcodes, nullptr);
+		ASSERT_EQ(ZXing_Barcodes_size(barcodes), 3);
+		for (int i = 0; i < 3; ++i)
+			EXPECT_EQ(Text(ZXing_Barcodes_at(barcodes, i)), data[i]);
+		ZXing_Barcodes_delete(barcodes);
+	}
+
+	// a size of 0 means strlen, other sizes are taken as is
+	int sizes[] = {0, 6, 1};
+	auto barcodes = ZXing_CreateBarcodesFromTexts(data, sizes, 3, cOpts, 2);
+	ASSERT_NE(barcodes, nullptr);
+	EXPECT_EQ(Text(ZXing_Barcodes_at(barcodes, 0)), "first");
+	EXPECT_EQ(Text(ZXing_Barcodes_at(barcodes, 1)), "second");
+	EXPECT_EQ(Text(ZXing_Barcodes_at(barcodes, 2)), "3");
+	ZXing_Barcodes_delete(barcodes);
+
+	int negative[] = {1, -1, 1};
+	EXPECT_EQ(ZXing_CreateBarcodesFromTexts(data, negative, 3, cOpts, 1), nullptr);
+	EXPECT_EQ(LastErrorMsg(), "Size param in CreateBarcodesFromTexts is negative");
+
+	const char* withNull[] = {"first", nullptr};
+	EXPECT_EQ(ZXing_CreateBarcodesFromTexts(withNull, nullptr, 2, cOpts, 1), nullptr);
+	EXPECT_EQ(LastErrorMsg(), "Data param in CreateBarcodesFromTexts is NULL");
+
+	ZXing_CreatorOptions_delete(cOpts);
+}
+
+TEST(ZXingCTest, CreateBarcodesFromBytes)
+{
+	auto cOpts = ZXing_CreatorOptions_new(ZXing_BarcodeFormat_QRCode);
+	const uint8_t bytes0[] = {0x00, 0xff, 0x10};
+	const uint8_t bytes1[] = {0x80};
+	const void* data[] = {bytes0, bytes1};
+	int sizes[] = {3, 1};
+
+	auto barcodes = ZXing_CreateBarcodesFromBytes(data, sizes, 2, cOpts, 0);
+	ASSERT_NE(barcodes, nullptr);
+	ASSERT_EQ(ZXing_Barcodes_size(barcodes), 2);
+	for (int i = 0; i < 2; ++i) {
+		int len = 0;
+		uint8_t* res = ZXing_Barcode_bytes(ZXing_Barcodes_at(barcodes, i), &len);
+		ASSERT_EQ(len, sizes[i]);
+		EXPECT_EQ(memcmp(res, data[i], len), 0);
+		ZXing_free(res);
+	}
+	ZXing_Barcodes_delete(barcodes);
+
+	// an empty byte array gets its own error message
+	int empty[] = {3, 0};
+	EXPECT_EQ(ZXing_CreateBarcodesFromBytes(data, empty, 2, cOpts, 1), nullptr);
+	EXPECT_EQ(LastErrorMsg(), "Size param in CreateBarcodesFromBytes is not positive");
+
+	const void* withNull[] = {bytes0, nullptr};
+	EXPECT_EQ(ZXing_CreateBarcodesFromBytes(withNull, sizes, 2, cOpts, 1), nullptr);
+	EXPECT_EQ(LastErrorMsg(), "Data param in CreateBarcodesFromBytes is NULL");
+
+	EXPECT_EQ(ZXing_CreateBarcodesFromBytes(data, sizes, -1, cOpts, 1), nullptr);
+	EXPECT_EQ(LastErrorMsg(), "Invalid count param");
+
+	ZXing_CreatorOptions_delete(cOpts);
+}
+
+#ifdef ZXING_READERS
+TEST(ZXingCTest, ReadBarcodesBatch)
+{
+	constexpr int count = 6;
+	auto cOpts = ZXing_CreatorOptions_new(ZXing_BarcodeFormat_QRCode);
+	auto wOpts = ZXing_WriterOptions_new();
+	ZXing_Image* images[count] = {};
+	ZXing_ImageView* views[count + 1] = {};
+	for (int i = 0; i < count; ++i) {
+		auto text = "Image " + std::to_string(i);
+		ZXing_WriterOptions_setSizeHint(wOpts, 40 + 10 * i);
+		auto barcode = ZXing_CreateBarcodeFromText(text.c_str(), 0, cOpts);
+		ASSERT_NE(barcode, nullptr);
+		images[i] = ZXing_WriteBarcodeToImage(barcode, wOpts);
+		ZXing_Barcode_delete(barcode);
+		ASSERT_NE(images[i], nullptr);
+		views[i] = ZXing_ImageView_new(ZXing_Image_data(images[i]), ZXing_Image_width(images[i]), ZXing_Image_height(images[i]),
+									   ZXing_ImageFormat_Lum, 0, 0);
+	}
+	// an image without any symbol
+	std::vector<uint8_t> blank(50 * 50, 0xff);
+	views[count] = ZXing_ImageView_new(blank.data(), 50, 50, ZXing_ImageFormat_Lum, 0, 0);
+
+	auto rOpts = ZXing_ReaderOptions_new();
+	ZXing_ReaderOptions_setFormats(rOpts, ZXing_BarcodeFormat_QRCode);
+	for (int numThreads : {1, 3, 0}) {
+		ZXing_Barcodes* results[count + 1] = {};
+		ASSERT_TRUE(ZXing_ReadBarcodesBatch(views, count + 1, rOpts, numThreads, results));
+		for (int i = 0; i < count; ++i) {
+			ASSERT_EQ(ZXing_Barcodes_size(results[i]), 1) << "image " << i;
+			EXPECT_EQ(Text(ZXing_Barcodes_at(results[i], 0)), "Image " + std::to_string(i));
+		}
+		EXPECT_EQ(ZXing_Barcodes_size(results[count]), 0);
+		for (auto res : results)
+			ZXing_Barcodes_delete(res);
+	}
+
+	// the options are optional, invalid params leave results untouched
+	ZXing_Barcodes* results[count + 1] = {};
+	ASSERT_TRUE(ZXing_ReadBarcodesBatch(views, 1, nullptr, 1, results));
+	EXPECT_EQ(Text(ZXing_Barcodes_at(results[0], 0)), "Image 0");
+	ZXing_Barcodes_delete(results[0]);
+	results[0] = nullptr;
+
+	EXPECT_FALSE(ZXing_ReadBarcodesBatch(views, -1, rOpts, 1, results));
+	EXPECT_EQ(LastErrorMsg(), "Invalid count param");
+	ZXing_ImageView* withNull[] = {views[0], nullptr};
+	EXPECT_FALSE(ZXing_ReadBarcodesBatch(withNull, 2, rOpts, 1, results));
+	EXPECT_EQ(LastErrorMsg(), "ImageView param is NULL");
+	EXPECT_EQ(results[0], nullptr);
+
+	ZXing_ReaderOptions_delete(rOpts);
+	for (auto view : views)
+		ZXing_ImageView_delete(view);
+	for (auto image : images)
+		ZXing_Image_delete(image);
+	ZXing_WriterOptions_delete(wOpts);
+	ZXing_CreatorOptions_delete(cOpts);
+}
+#endif // ZXING_READERS
+
+#endif // ZXING_EXPERIMENTAL_API
@@ -12,8 +12,12 @@
 #include "Utf.h"
 #include "aztec/AZDecoder.h"
 #include "aztec/AZDetectorResult.h"
+#include "aztec/AZWriter.h"
 
 #include "gtest/gtest.h"
+#include <chrono>
+#include <iostream>
+#include <string>
 #include <string_view>
 #include <vector>
 
@@ -485,4 +489,54 @@ TEST(AZDetectorTest, Rune)
 		// This is just the core of a regular compact code, and not a valid rune
 		EXPECT_FALSE(r.isValid());
 	}
-}
\ No newline at end of file
+}
+
+// a boarding pass / ticket like image: lines of 'text' with three Aztec symbols of different size in between
+static BitMatrix TicketImage(PseudoRandom& random)
+{
+	BitMatrix image(1200, 800);
+	for (int y = 10; y < image.height() - 30; y += 24)
+		for (int x = 10; x < image.width() - 20; x += 9)
+			if (random.next(0, 4))
+				image.setRegion(x, y, random.next(2, 6), random.next(6, 15));
+
+	for (int i = 0; i < 3; ++i) {
+		auto symbol = Aztec::Writer().setMargin(2).encode("M1DOE/JOHN E ABC123 FRAMUCLH 0123 045Y012A0001 " + std::string(40 * i, 'x'), 0, 0);
+		int scale = 3 + i % 2, left = 40 + 380 * i, top = 60 + 200 * i;
+		for (int y = 0; y < scale * symbol.height(); ++y)
+			for (int x = 0; x < scale * symbol.width(); ++x)
+				image.set(left + x, top + y, symbol.get(x / scale, y / scale));
+	}
+	return image;
+}
+
+TEST(AZDetectorTest, MultipleSymbolsBetweenText)
+{
+	PseudoRandom random(0x5EED);
+	auto image = TicketImage(random);
+	auto results = Aztec::Detect(image, false /*isPure*/, true /*tryHarder*/, 10);
+	EXPECT_EQ(Size(results), 3);
+	for (auto& r : results)
+		EXPECT_TRUE(Aztec::Decode(r).isValid());
+}
+
+// run with --gtest_also_run_disabled_tests
+TEST(AZDetectorTest, DISABLED_BenchmarkMultipleSymbolsBetweenText)
+{
+	using namespace std::chrono;
+	PseudoRandom random(0x5EED);
+	std::vector<BitMatrix> images;
+	for (int i = 0; i < 8; ++i)
+		images.push_back(TicketImage(random));
+
+	const int iterations = 20;
+	int found = 0;
+	auto start = steady_clock::now();
+	for (int i = 0; i < iterations; ++i)
+		for (auto& image : images)
+			found += Size(Aztec::Detect(image, false, true, 10));
+	auto us = duration_cast<microseconds>(steady_clock::now() - start).count() / (iterations * Size(images));
+
+	EXPECT_EQ(found, 3 * iterations * Size(images));
+	std::cout << "Aztec::Detect with 3 symbols between text: " << us << " us per image" << std::endl;
+}
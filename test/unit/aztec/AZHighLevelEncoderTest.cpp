@@ -8,10 +8,13 @@
 #include "BitArray.h"
 #include "BitArrayUtility.h"
 #include "DecoderResult.h"
+#include "PseudoRandom.h"
 #include "StructuredAppend.h"
 
 #include "gtest/gtest.h"
 #include <algorithm>
+#include <chrono>
+#include <iostream>
 
 namespace ZXing::Aztec {
 
@@ -43,6 +46,21 @@ namespace {
 		EXPECT_EQ(receivedBitCount, expectedReceivedBits) << "highLevelEncode() failed for input string: " + s;
 		EXPECT_EQ(ByteArray(s), Aztec::Decode(bits).content().bytes);
 	}
+
+	// Text with punctuation and digits, interrupted by runs of binary data, like the payload of a rail ticket.
+	std::string MixedPayload(PseudoRandom& random, int size) {
+		const std::string text = "Zurich HB - Bern, 12:34. Class 2\r\nAdult 1 ";
+		std::string res;
+		while (Size(res) < size) {
+			if (random.next(0, 3))
+				res += text.substr(random.next(0, Size(text) - 1));
+			else
+				for (int n = random.next(1, 80); n > 0; --n)
+					res.push_back(static_cast<char>(random.next(0, 255)));
+		}
+		res.resize(size);
+		return res;
+	}
 }
 
 TEST(AZHighLevelEncoderTest, HighLevelEncode)
@@ -184,3 +202,29 @@ TEST(AZHighLevelEncoderTest, HighLevelEncodePairs)
 		// 'A'  B/S    =2    \200      "."     " "     \200
 		"...X. XXXXX ..X.. X....... ..X.XXX. ..X..... X.......");
 }
+
+TEST(AZHighLevelEncoderTest, HighLevelEncodeLong)
+{
+	PseudoRandom random(0x5EED);
+	for (int size : {300, 1000, 3000}) {
+		auto s = MixedPayload(random, size);
+		EXPECT_EQ(ByteArray(s), Aztec::Decode(Aztec::HighLevelEncoder::Encode(s)).content().bytes) << size;
+	}
+}
+
+TEST(AZHighLevelEncoderTest, DISABLED_BenchmarkHighLevelEncode)
+{
+	using namespace std::chrono;
+	PseudoRandom random(0x5EED);
+	for (int size : {100, 1000, 3000}) {
+		auto s = MixedPayload(random, size);
+		const int iterations = 50;
+		int bits = 0;
+		auto start = steady_clock::now();
+		for (int i = 0; i < iterations; ++i)
+			bits += Aztec::HighLevelEncoder::Encode(s).size();
+		auto us = duration_cast<microseconds>(steady_clock::now() - start).count() / iterations;
+		std::cout << "Aztec::HighLevelEncoder::Encode with " << size << " bytes: " << us << " us (" << bits / iterations
+				  << " bits)" << std::endl;
+	}
+}
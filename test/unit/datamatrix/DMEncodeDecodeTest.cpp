@@ -6,6 +6,7 @@
 
 #include "BitMatrixIO.h"
 #include "DecoderResult.h"
+#include "ReadBarcode.h"
 #include "datamatrix/DMDecoder.h"
 #include "datamatrix/DMWriter.h"
 
@@ -15,9 +16,10 @@ using namespace ZXing;
 
 namespace {
 
-	void TestEncodeDecode(const std::wstring& data, DataMatrix::SymbolShape shape = DataMatrix::SymbolShape::NONE)
+	void TestEncodeDecode(const std::wstring& data, DataMatrix::SymbolShape shape = DataMatrix::SymbolShape::NONE,
+						  bool minimal = false)
 	{
-		BitMatrix matrix = DataMatrix::Writer().setMargin(0).setShapeHint(shape).encode(data, 0, 0);
+		BitMatrix matrix = DataMatrix::Writer().setMargin(0).setShapeHint(shape).setMinimalEncoding(minimal).encode(data, 0, 0);
 		ASSERT_EQ(matrix.empty(), false);
 
 		DecoderResult res = DataMatrix::Decode(matrix);
@@ -107,3 +109,75 @@ TEST(DMEncodeDecodeTest, EDIFACTWithEOD)
 			TestEncodeDecode(data, shape);
 }
 
+
+TEST(DMEncodeDecodeTest, MinimalEncoding)
+{
+	using namespace DataMatrix;
+	std::wstring text[] = {
+	    L"Abc123!",
+	    L"Lorem ipsum. http://test/",
+	    L"3i0QnD^RcZO[\\#!]1,9zIJ{1z3qrvsq",
+	    L"AAAANAAAANAAAANAAAANAAAANAAAANAAAANAAAANAAAANAAAAN",
+	    L"http://test/~!@#*^%&)__ ;:'\"[]{}\\|-+-=`1029384",
+	    L"abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ",
+	    L"https://test~[******]_<ABCDEFG><ABCDEFGK>*CH/GN1/022/00",
+	    L"ABC>ABC123>AB\rABC*DEF 0123456789",
+	};
+
+	// every prefix, so that all the end of data situations are hit in the different symbol sizes
+	for (auto& data : text)
+		for (auto shape : {SymbolShape::NONE, SymbolShape::SQUARE, SymbolShape::RECTANGLE})
+			for (size_t len = 1; len <= data.size(); ++len)
+				TestEncodeDecode(data.substr(0, len), shape, true);
+
+	std::wstring binary = L"ABC";
+	for (int i = 0; i < 300; ++i)
+		binary.push_back(L'\xA0' + i % 32);
+	TestEncodeDecode(binary, SymbolShape::SQUARE, true);
+}
+
+TEST(DMEncodeDecodeTest, OffCenterSymbols)
+{
+	// two symbols in the upper corners of an otherwise empty image, none of them is crossed by the center lines
+	Matrix<uint8_t> image(400, 300, 255);
+	for (int i = 0; i < 2; ++i) {
+		auto symbol = ToMatrix<uint8_t>(DataMatrix::Writer().setMargin(0).encode(L"Symbol " + std::to_wstring(i), 0, 0));
+		for (int y = 0; y < 3 * symbol.height(); ++y)
+			for (int x = 0; x < 3 * symbol.width(); ++x)
+				image.set(20 + 300 * i + x, 20 + y, symbol.get(x / 3, y / 3));
+	}
+
+	auto barcodes = ReadBarcodes({image.data(), image.width(), image.height(), ImageFormat::Lum},
+								 ReaderOptions().setFormats(BarcodeFormat::DataMatrix));
+	ASSERT_EQ(barcodes.size(), 2);
+	EXPECT_NE(barcodes[0].text(), barcodes[1].text());
+	for (auto& barcode : barcodes)
+		EXPECT_EQ(barcode.text().substr(0, 7), "Symbol ");
+}
+
+TEST(DMEncodeDecodeTest, PureRotatedAndMirrored)
+{
+	for (auto shape : {DataMatrix::SymbolShape::SQUARE, DataMatrix::SymbolShape::RECTANGLE}) {
+		auto symbol = DataMatrix::Writer().setMargin(2).setShapeHint(shape).encode(L"Hello, World!", 0, 0);
+		for (bool mirrored : {false, true}) {
+			BitMatrix bits = mirrored ? BitMatrix(symbol.height(), symbol.width()) : symbol.copy();
+			if (mirrored)
+				for (int y = 0; y < symbol.height(); ++y)
+					for (int x = 0; x < symbol.width(); ++x)
+						bits.set(y, x, symbol.get(x, y));
+
+			constexpr int orientations[] = {0, -90, 180, 90};
+			for (int rotation = 0; rotation < 4; ++rotation, bits.rotate90()) {
+				auto image = ToMatrix<uint8_t>(bits);
+				auto barcode = ReadBarcode({image.data(), image.width(), image.height(), ImageFormat::Lum},
+										   ReaderOptions().setFormats(BarcodeFormat::DataMatrix).setIsPure(true));
+				EXPECT_EQ(barcode.text(), "Hello, World!") << "shape: " << static_cast<int>(shape) << ", rotation: " << rotation
+														   << ", mirrored: " << mirrored;
+				if (!mirrored) {
+					EXPECT_EQ(barcode.orientation(), orientations[rotation]) << "shape: " << static_cast<int>(shape);
+				}
+				EXPECT_EQ(barcode.isMirrored(), mirrored);
+			}
+		}
+	}
+}
@@ -65,6 +65,11 @@ namespace {
 		return Visualize(DataMatrix::Encode(text));
 	}
 
+	std::string EncodeMinimal(const std::wstring& text,
+							  DataMatrix::SymbolShape shape = DataMatrix::SymbolShape::NONE) {
+		return Visualize(DataMatrix::EncodeMinimal(text, CharacterSet::ISO8859_1, shape, -1, -1, -1, -1));
+	}
+
 	std::wstring CreateBinaryMessage(int len) {
 		std::wstring buf;
 		buf.append(L"\xAB\xE4\xF6\xFC\xE9\xE0\xE1-");
@@ -352,6 +357,35 @@ TEST(DMHighLevelEncodeTest, EDIFACTWithEODBug)
 	EXPECT_EQ(visualized, "98 99 100 240 242 223 129 8 49 5 129 147");
 }
 
+TEST(DMHighLevelEncodeTest, MinimalEncodation)
+{
+	// C40/Text until 1 codeword is left in the symbol, the decoder implicitly returns to ASCII for the last one
+	EXPECT_EQ(EncodeMinimal(L"GX5OIYNa."), "230 130 210 178 151 169 18 47");
+	EXPECT_EQ(EncodeMinimal(L"qwtbqqb%B"), "239 193 66 98 143 93 237 67");
+
+	// same as the heuristic if that is already optimal
+	EXPECT_EQ(EncodeMinimal(L"123456"), Encode(L"123456"));
+	// no unlatch before the padding if only 1 codeword is left
+	EXPECT_EQ(EncodeMinimal(L"AIMAIMAIM"), "230 91 11 91 11 91 11 129");
+	EXPECT_EQ(EncodeMinimal(L"[)>\x1E""05\x1D""5555\x1C""6666\x1E\x04"), "236 185 185 29 196 196 129 56");
+	// plain ASCII if no run of characters can make up for a latch into another mode
+	EXPECT_EQ(EncodeMinimal(L"aBcDeFgH"), "98 67 100 69 102 71 104 73");
+	EXPECT_EQ(EncodeMinimal(L"x_y_z~Q*r"), "121 96 122 96 123 127 82 43 115 129");
+	EXPECT_EQ(EncodeMinimal(L"ab_CD_ef_GH."), "98 99 96 68 69 96 102 103 96 72 73 47");
+	// "CDE" could be a C40 triplet, which only breaks even with latch and unlatch
+	EXPECT_EQ(EncodeMinimal(L"ab_CDE_fg"), "98 99 96 68 69 70 96 103 104 129");
+
+	std::wstring text[] = {
+		L"ABC>ABC123>AB", L"ABCDEabcde12345", L"*MEMANT-1F-MESTECH", L"abc<->ABCDE", L"fiykmj*Rh2`,e6",
+		L"http://test/~!@#*^%&)__ ;:'\"[]{}\\|-+-=`1029384", L"\xAB\xE4\xF6\xFC\xE9\xBB 12345678",
+		CreateBinaryMessage(30),
+	};
+	for (auto& data : text)
+		for (auto shape : {DataMatrix::SymbolShape::NONE, DataMatrix::SymbolShape::RECTANGLE})
+			EXPECT_LE(DataMatrix::EncodeMinimal(data, CharacterSet::ISO8859_1, shape, -1, -1, -1, -1).size(),
+					  DataMatrix::Encode(data, CharacterSet::ISO8859_1, shape, -1, -1, -1, -1).size());
+}
+
 //  @Ignore
 //  @Test  
 //  public void testDataURL() {
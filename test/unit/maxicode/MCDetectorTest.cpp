@@ -0,0 +1,113 @@
+/*
+* Copyright 2026 ZXing authors
+*/
+// SPDX-License-Identifier: Apache-2.0
+
+#include "maxicode/MCDetector.h"
+
+#include "BitMatrix.h"
+#include "BitMatrixIO.h"
+#include "DecoderResult.h"
+#include "DetectorResult.h"
+#include "PerspectiveTransform.h"
+#include "maxicode/MCDecoder.h"
+
+#include "gtest/gtest.h"
+#include <cmath>
+#include <string>
+
+using namespace ZXing;
+
+// the modules of MODE2.png from the maxicode-1 blackbox test samples
+static BitMatrix Mode2Modules()
+{
+	return ParseBitMatrix(
+		"XX X XXX XX XXXXX XXXX      XX\n"
+		" X X X X XXX    XX XX XXXXX X \n"
+		"XX XX XX   X  X X X  XX XX   X\n"
+		" X X X X X X X X X X XXXXX    \n"
+		"                      XX  X X \n"
+		"X X X X X X X X X X X XX XX   \n"
+		" X X X X X X X X X X X X X XXX\n"
+		"                              \n"
+		"X X X X X X X X X X X X X X X \n"
+		" X X X XXXXXXX X   X X X X X  \n"
+		"          XX       XXX      XX\n"
+		"X X X X      XX  XXXX X X X X \n"
+		" X X X X  X X   X X    X X X  \n"
+		"      XXX X XXXX XXX        X \n"
+		"X X X    XX X X X X   X X X X \n"
+		" X X XXX X XX  XX      X X XX \n"
+		"      X X  XX    XX X         \n"
+		"X X X XXXX XX  XX   XXX X X   \n"
+		" X X X    X X X X X  X X X X X\n"
+		"          X XXXX X XX       X \n"
+		"X X X XX X  X   X XX  X X X XX\n"
+		" X X X XXX   XX   X X  X X XX \n"
+		"          X  XX  X  X       XX\n"
+		"X X X X XXX X XX XXXXXX X X   \n"
+		" X X X X X X X X X XX  XX X  X\n"
+		"                    X     X X \n"
+		"X X X X X X X X X X XX  XXX X \n"
+		"XXX X X   X   XX XXXX  X XXXX \n"
+		"X   X XXX  XXX  X XXX XXXX  XX\n"
+		" XX  XX    XX  X XXX    XX    \n"
+		"X  X   X  XXX X XX  XXX  XXX  \n"
+		"X  XX  XXXX   X XXXXX XXXX  X \n"
+		"    X  X  XXXXXXX  X  XX   XXX\n",
+		'X', false);
+}
+
+// Render the modules as round dots on a hexagonal grid plus the bullseye. pix2Mod maps the image into module space, where
+// the column pitch is 1 and the origin is the center of the bullseye.
+static BitMatrix RenderSymbol(const BitMatrix& modules, int size, const PerspectiveTransform& pix2Mod)
+{
+	constexpr double ROW_PITCH = 0.8660254037844386;
+	BitMatrix image(size, size);
+	for (int y = 0; y < size; ++y)
+		for (int x = 0; x < size; ++x) {
+			auto m = pix2Mod(centered(PointI{x, y}));
+			if (double r = length(m); r < 4.6) {
+				if ((r > 1.1 && r < 1.8) || (r > 2.5 && r < 3.2) || (r > 3.8 && r < 4.48))
+					image.set(x, y);
+				continue;
+			}
+			int row = static_cast<int>(std::lround(m.y / ROW_PITCH)) + 16;
+			for (int my = row - 1; my <= row + 1; ++my) {
+				int mx = static_cast<int>(std::lround(m.x - 0.5 * (my & 1))) + 14;
+				if (!modules.isIn(PointI{mx, my}) || !modules.get(mx, my))
+					continue;
+				if (distance(m, PointF(mx + 0.5 * (my & 1) - 14, (my - 16) * ROW_PITCH)) < 0.42)
+					image.set(x, y);
+			}
+		}
+	return image;
+}
+
+TEST(MCDetectorTest, RotatedAndTilted)
+{
+	constexpr double PI = 3.14159265358979323846;
+	const auto modules = Mode2Modules();
+	const QuadrilateralF modSquare = {PointF{-20, -20}, {20, -20}, {20, 20}, {-20, 20}};
+
+	for (double angle : {0, 20, 90, 135, 200, 330}) {
+		for (double tilt : {0.0, 0.1, 0.2}) {
+			// 7 pixels per module, the top of the symbol is farther away from the camera than the bottom
+			QuadrilateralF imgSquare;
+			for (int i = 0; i < 4; ++i) {
+				auto p = 7 * (1 - (i < 2 ? tilt : 0)) * modSquare[i];
+				double co = std::cos(angle * PI / 180), si = std::sin(angle * PI / 180);
+				imgSquare[i] = PointF(co * p.x - si * p.y, si * p.x + co * p.y) + PointF(200, 200);
+			}
+			auto image = RenderSymbol(modules, 400, PerspectiveTransform(imgSquare, modSquare));
+
+			std::string text;
+			for (auto&& detRes : MaxiCode::Detect(image, false))
+				if (auto decRes = MaxiCode::Decode(detRes.bits()); decRes.isValid()) {
+					text = decRes.content().text(TextMode::Plain);
+					break;
+				}
+			EXPECT_EQ(text, "[)>\x1E" "01\x1D" "96123450000\x1D" "222\x1D" "111\x1D" "MODE2") << "angle " << angle << ", tilt " << tilt;
+		}
+	}
+}
@@ -0,0 +1,77 @@
+/*
+* Copyright 2026 ZXing authors
+*/
+// SPDX-License-Identifier: Apache-2.0
+
+#include "BitMatrix.h"
+#include "ReadBarcode.h"
+#include "pdf417/PDFWriter.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+
+using namespace ZXing;
+
+namespace {
+
+	const int QUIET_ZONE = 20;
+	const int SCALE = 2;
+	const int ROW_HEIGHT = 4 * SCALE; // keep in sync with the aspect ratio in PDFWriter.cpp
+
+	// Render the symbol with SCALE pixels per module and a quiet zone around it
+	Matrix<uint8_t> Render(const std::wstring& text)
+	{
+		auto symbol = ToMatrix<uint8_t>(Pdf417::Writer().setMargin(0).setErrorCorrectionLevel(2).encode(text, 0, 0));
+		Matrix<uint8_t> image(SCALE * symbol.width() + 2 * QUIET_ZONE, SCALE * symbol.height() + 2 * QUIET_ZONE, 255);
+		for (int y = 0; y < image.height() - 2 * QUIET_ZONE; ++y)
+			for (int x = 0; x < image.width() - 2 * QUIET_ZONE; ++x)
+				image.set(QUIET_ZONE + x, QUIET_ZONE + y, symbol.get(x / SCALE, y / SCALE));
+		return image;
+	}
+
+	// Fill the image rows [first, last] of each symbol row with black between the row indicator columns, so that no
+	// data codeword can be read there
+	void BlackenDataColumns(Matrix<uint8_t>& image, int first, int last)
+	{
+		int minX = QUIET_ZONE + SCALE * (17 + 17); // start pattern and left row indicator
+		int maxX = image.width() - QUIET_ZONE - SCALE * (18 + 17); // stop pattern and right row indicator
+		for (int rowTop = QUIET_ZONE; rowTop < image.height() - QUIET_ZONE; rowTop += ROW_HEIGHT)
+			for (int y = rowTop + first; y <= rowTop + last; ++y)
+				for (int x = minX; x < maxX; ++x)
+					image.set(x, y, 0);
+	}
+
+	Barcode Read(const Matrix<uint8_t>& image)
+	{
+		return ReadBarcode({image.data(), image.width(), image.height(), ImageFormat::Lum},
+						   ReaderOptions().setFormats(BarcodeFormat::PDF417).setTryRotate(false));
+	}
+
+} // namespace
+
+TEST(PDF417EncodeDecodeTest, RowLines)
+{
+	const std::wstring text = L"PDF417 row lines 0123456789 abcdefghijklmnopqrstuvwxyz";
+	auto image = Render(text);
+
+	// undamaged: every data codeword is sampled once along the center line of its symbol row
+	auto barcode = Read(image);
+	ASSERT_TRUE(barcode.isValid());
+	EXPECT_EQ(barcode.text(), std::string(text.begin(), text.end()));
+
+	// only the center lines readable: the sparse pass alone decodes the symbol
+	auto centerOnly = image.copy();
+	BlackenDataColumns(centerOnly, 0, ROW_HEIGHT / 2 - 1);
+	BlackenDataColumns(centerOnly, ROW_HEIGHT / 2 + 1, ROW_HEIGHT - 1);
+	barcode = Read(centerOnly);
+	ASSERT_TRUE(barcode.isValid());
+	EXPECT_EQ(barcode.text(), std::string(text.begin(), text.end()));
+
+	// center lines unreadable: the sparse pass finds no data codewords, the full scan of all image rows is needed
+	auto centerDamaged = image.copy();
+	BlackenDataColumns(centerDamaged, ROW_HEIGHT / 2 - 2, ROW_HEIGHT / 2 + 1);
+	barcode = Read(centerDamaged);
+	ASSERT_TRUE(barcode.isValid());
+	EXPECT_EQ(barcode.text(), std::string(text.begin(), text.end()));
+}
@@ -100,3 +100,46 @@ TEST(PDF417ErrorCorrectionTest, TooManyErrors)
 	int nbError = 0;
 	EXPECT_FALSE(DecodeErrorCorrection(received, ECC_BYTES, std::vector<int>(), nbError));
 }
+
+TEST(PDF417ErrorCorrectionTest, MaxErasures)
+{
+	PseudoRandom random(0x12345678);
+	for (int testIterations = 0; testIterations < 100; testIterations++) { // # iterations is kind of arbitrary
+		std::vector<int> received(PDF417_TEST_WITH_EC, PDF417_TEST_WITH_EC + Size(PDF417_TEST_WITH_EC));
+		std::vector<int> erasures;
+		while (Size(erasures) < MAX_ERASURES) {
+			int location = random.next(0, Size(received) - 1);
+			if (!Contains(erasures, location)) {
+				erasures.push_back(location);
+				received[location] = 0;
+			}
+		}
+		CheckDecode(received, erasures);
+	}
+}
+
+TEST(PDF417ErrorCorrectionTest, ErasuresAndErrors)
+{
+	PseudoRandom random(0x12345678);
+	for (int testIterations = 0; testIterations < 100; testIterations++) {
+		std::vector<int> received(PDF417_TEST_WITH_EC, PDF417_TEST_WITH_EC + Size(PDF417_TEST_WITH_EC));
+		int numErasures = random.next(1, MAX_ERASURES);
+		std::vector<int> erasures;
+		while (Size(erasures) < numErasures) {
+			int location = random.next(0, Size(received) - 1);
+			if (!Contains(erasures, location)) {
+				erasures.push_back(location);
+				received[location] = 0;
+			}
+		}
+		// unknown errors must not hit one of the erasures
+		for (int numErrors = 0; numErrors < (ERROR_LIMIT - numErasures) / 2;) {
+			int location = random.next(0, Size(received) - 1);
+			if (!Contains(erasures, location) && received[location] == PDF417_TEST_WITH_EC[location]) {
+				received[location] = (received[location] + random.next(1, 928)) % 929;
+				numErrors++;
+			}
+		}
+		CheckDecode(received, erasures);
+	}
+}
@@ -5,19 +5,90 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "CharacterSet.h"
+#include "PseudoRandom.h"
+#include "Version.h"
+#include "ZXAlgorithms.h"
 #include "pdf417/PDFCompaction.h"
 #include "pdf417/PDFHighLevelEncoder.h"
+#ifdef ZXING_READERS
+#include "DecoderResult.h"
+#include "pdf417/PDFDecoder.h"
+#endif
 
 #include "gtest/gtest.h"
 
 using namespace ZXing;
 using namespace ZXing::Pdf417;
 
+#ifdef ZXING_READERS
+// Prepends the symbol length descriptor the decoder expects and decodes the high-level codewords.
+static std::wstring DecodeHighLevel(std::vector<int> codewords)
+{
+	codewords.insert(codewords.begin(), Size(codewords) + 1);
+	auto res = Pdf417::Decode(codewords);
+	EXPECT_TRUE(res.isValid()) << ToString(res.error());
+	return res.content().utfW();
+}
+
+static std::wstring MixedText(PseudoRandom& random, int length)
+{
+	static const std::wstring pieces[] = {L"Invoice ", L"No. ", L"20261018", L"0123456789012345678901234567890123456789",
+										  L"EUR ", L"1.234,56", L"\n", L"Straße ", L"a@b.c ", L"(x+y)*z; ", L"\t", L"ABC"};
+	std::wstring res;
+	while (Size(res) < length) {
+		if (random.next(0, 9) == 0)
+			res += static_cast<wchar_t>(random.next(0xa0, 0xff));
+		else
+			res += pieces[random.next(0, Size(pieces) - 1)];
+	}
+	res.resize(length);
+	return res;
+}
+#endif
+
 TEST(PDF417HighLevelEncoderTest, EncodeAuto)
 {
 	auto encoded = HighLevelEncoder::EncodeHighLevel(L"ABCD", Compaction::AUTO, CharacterSet::UTF8);
-	EXPECT_EQ(encoded, std::vector<int>({ 0x39f, 0x1A, 0x385, 'A', 'B', 'C', 'D' }));
+	EXPECT_EQ(encoded, std::vector<int>({ 0x39f, 0x1A, 1, 63 }));
+}
+
+TEST(PDF417HighLevelEncoderTest, EncodeAutoMinimal)
+{
+	// "ab" is shorter as two text values following a latch to LOWER than as two bytes following a byte latch
+	EXPECT_EQ(HighLevelEncoder::EncodeHighLevel(L"ab", Compaction::AUTO, CharacterSet::ISO8859_1),
+			  std::vector<int>({ 27 * 30 + 0, 1 * 30 + 29 }));
+	// 13 digits are shorter in Numeric Compaction than in Text Compaction
+	EXPECT_EQ(HighLevelEncoder::EncodeHighLevel(L"1234567890123", Compaction::AUTO, CharacterSet::ISO8859_1).size(), 6);
+	// a single non-text byte between text is shifted to Byte Compaction
+	EXPECT_EQ(HighLevelEncoder::EncodeHighLevel(L"AB\xE9""CD", Compaction::AUTO, CharacterSet::ISO8859_1),
+			  std::vector<int>({ 1, 913, 0xe9, 63 }));
+}
+
+TEST(PDF417HighLevelEncoderTest, EncodeAutoNumericGroups)
+{
+	// each full group of 44 digits takes 15 codewords
+	std::wstring digits(88, L'7');
+	auto encoded = HighLevelEncoder::EncodeHighLevel(digits, Compaction::AUTO, CharacterSet::ISO8859_1);
+	EXPECT_EQ(encoded.size(), 1 + 2 * 15);
+	EXPECT_EQ(encoded.front(), 902);
+#ifdef ZXING_READERS
+	EXPECT_EQ(DecodeHighLevel(encoded), digits);
+#endif
+}
+
+#ifdef ZXING_READERS
+TEST(PDF417HighLevelEncoderTest, EncodeAutoRoundTrip)
+{
+	PseudoRandom random(0x3f417);
+	for (int length : {1, 2, 5, 17, 60, 300, 1000}) {
+		for (int i = 0; i < 20; ++i) {
+			auto text = MixedText(random, length);
+			auto encoded = HighLevelEncoder::EncodeHighLevel(text, Compaction::AUTO, CharacterSet::UTF8);
+			EXPECT_EQ(DecodeHighLevel(encoded), text);
+		}
+	}
 }
+#endif
 
 TEST(PDF417HighLevelEncoderTest, EncodeAutoWithSpecialChars)
 {
@@ -142,3 +142,31 @@ TEST(QRDecodedBitStreamParserTest, GS1PercentGS)
 	EXPECT_EQ(result.content().text(TextMode::Plain), "9112%\x1D" "2012");
 	EXPECT_EQ(result.content().text(TextMode::HRI), "(91)12%(20)12");
 }
+
+TEST(QRDecodedBitStreamParserTest, NumericAndTruncatedByteMode)
+{
+	BitArray ba;
+	ba.appendBits(0x01, 4); // Numeric mode
+	ba.appendBits(0x06, 10); // 6 digits
+	ba.appendBits(7, 10); // "007"
+	ba.appendBits(999, 10); // "999"
+	ba.appendBits(0x01, 4); // Numeric mode
+	ba.appendBits(0x01, 10); // 1 digit
+	ba.appendBits(5, 4); // "5"
+	EXPECT_EQ(DecodeBitStream(ba.toBytes(), *Version::Model2(1), ErrorCorrectionLevel::Medium).content().bytes.asString(),
+			  "0079995");
+
+	ba.appendBits(0x04, 4); // Byte mode
+	ba.appendBits(0x05, 8); // 5 bytes, but only 2 follow
+	ba.appendBits(0x41, 8);
+	ba.appendBits(0x42, 8);
+	auto result = DecodeBitStream(ba.toBytes(), *Version::Model2(1), ErrorCorrectionLevel::Medium);
+	EXPECT_FALSE(result.isValid());
+	EXPECT_EQ(result.content().bytes.asString(0, 9), "0079995AB");
+
+	BitArray invalid;
+	invalid.appendBits(0x01, 4); // Numeric mode
+	invalid.appendBits(0x03, 10); // 3 digits
+	invalid.appendBits(1000, 10); // out of range
+	EXPECT_FALSE(DecodeBitStream(invalid.toBytes(), *Version::Model2(1), ErrorCorrectionLevel::Medium).isValid());
+}
@@ -7,8 +7,10 @@
 #include "BitArrayUtility.h"
 #include "BitMatrixIO.h"
 #include "CharacterSet.h"
+#include "DecoderResult.h"
 #include "TextDecoder.h"
 #include "Utf.h"
+#include "qrcode/QRDecoder.h"
 #include "qrcode/QREncoder.h"
 #include "qrcode/QRCodecMode.h"
 #include "qrcode/QREncodeResult.h"
@@ -19,7 +21,6 @@
 namespace ZXing {
 	namespace QRCode {
 		int GetAlphanumericCode(int code);
-		CodecMode ChooseMode(const std::wstring& content, CharacterSet encoding);
 		void AppendModeInfo(CodecMode mode, BitArray& bits);
 		void AppendLengthInfo(int numLetters, const Version& version, CodecMode mode, BitArray& bits);
 		void AppendNumericBytes(const std::wstring& content, BitArray& bits);
@@ -80,34 +81,6 @@ TEST(QREncoderTest, GetAlphanumericCode)
 	EXPECT_EQ(-1, GetAlphanumericCode('\0'));
 }
 
-TEST(QREncoderTest, ChooseMode)
-{
-	// Numeric mode.
-	EXPECT_EQ(CodecMode::NUMERIC, ChooseMode(L"0", CharacterSet::Unknown));
-	EXPECT_EQ(CodecMode::NUMERIC, ChooseMode(L"0123456789", CharacterSet::Unknown));
-	// Alphanumeric mode.
-	EXPECT_EQ(CodecMode::ALPHANUMERIC, ChooseMode(L"A", CharacterSet::Unknown));
-	EXPECT_EQ(CodecMode::ALPHANUMERIC,
-			  ChooseMode(L"0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ $%*+-./:", CharacterSet::Unknown));
-	// 8-bit byte mode.
-	EXPECT_EQ(CodecMode::BYTE, ChooseMode(L"a", CharacterSet::Unknown));
-	EXPECT_EQ(CodecMode::BYTE, ChooseMode(L"#", CharacterSet::Unknown));
-	EXPECT_EQ(CodecMode::BYTE, ChooseMode(L"", CharacterSet::Unknown));
-	// Kanji mode.  We used to use MODE_KANJI for these, but we stopped
-	// doing that as we cannot distinguish Shift_JIS from other encodings
-	// from data bytes alone.  See also comments in qrcode_encoder.h.
-
-	// AIUE in Hiragana in Shift_JIS
-	EXPECT_EQ(CodecMode::BYTE,
-			  ChooseMode(ShiftJISString({0x8, 0xa, 0x8, 0xa, 0x8, 0xa, 0x8, 0xa6}), CharacterSet::Unknown));
-
-	// Nihon in Kanji in Shift_JIS.
-	EXPECT_EQ(CodecMode::BYTE, ChooseMode(ShiftJISString({0x9, 0xf, 0x9, 0x7b}), CharacterSet::Unknown));
-
-	// Sou-Utsu-Byou in Kanji in Shift_JIS.
-	EXPECT_EQ(CodecMode::BYTE, ChooseMode(ShiftJISString({0xe, 0x4, 0x9, 0x5, 0x9, 0x61}), CharacterSet::Unknown));
-}
-
 TEST(QREncoderTest, Encode)
 {
 	auto qrCode = Encode(L"ABCDEF", ErrorCorrectionLevel::High, CharacterSet::Unknown, 0, false, -1);
@@ -289,33 +262,33 @@ TEST(QREncoderTest, EncodeGS1)
 	EXPECT_EQ(qrCode.ecLevel, ErrorCorrectionLevel::High);
 	ASSERT_NE(qrCode.version, nullptr);
 	EXPECT_EQ(qrCode.version->versionNumber(), 2);
-	EXPECT_EQ(qrCode.maskPattern, 4);
+	EXPECT_EQ(qrCode.maskPattern, 5);
 	EXPECT_EQ(ToString(qrCode.matrix, 'X', ' ', true),
-		"X X X X X X X     X X X X   X   X   X X X X X X X \n"
-		"X           X   X X           X X   X           X \n"
-		"X   X X X   X           X X X   X   X   X X X   X \n"
-		"X   X X X   X     X   X     X X     X   X X X   X \n"
-		"X   X X X   X       X X X       X   X   X X X   X \n"
-		"X           X   X X   X X   X X     X           X \n"
+		"X X X X X X X   X   X     X X   X   X X X X X X X \n"
+		"X           X           X       X   X           X \n"
+		"X   X X X   X   X   X   X X X X X   X   X X X   X \n"
+		"X   X X X   X       X   X X   X X   X   X X X   X \n"
+		"X   X X X   X   X   X X X   X   X   X   X X X   X \n"
+		"X           X     X X     X X X     X           X \n"
 		"X X X X X X X   X   X   X   X   X   X X X X X X X \n"
-		"                X X   X X   X X                   \n"
-		"        X X X X     X X       X X   X X       X   \n"
-		"  X X   X X     X X X       X X X X X X X       X \n"
-		"    X X X X X   X X X X X   X             X X X   \n"
-		"X   X X X     X X X   X X X X X   X X   X X X     \n"
-		"  X   X     X X X X X X     X X   X           X   \n"
-		"X     X X X     X X       X X   X   X   X         \n"
-		"    X     X X X   X X   X X X   X X X   X X X X   \n"
-		"      X X     X     X     X X     X       X X X   \n"
-		"X X   X   X X   X   X       X X X X X X X         \n"
-		"                X X   X       X X       X X   X   \n"
-		"X X X X X X X   X   X   X   X X X   X   X         \n"
-		"X           X   X X       X   X X       X   X X   \n"
-		"X   X X X   X   X X X           X X X X X X     X \n"
-		"X   X X X   X             X X X     X X   X       \n"
-		"X   X X X   X       X X   X   X X X   X X     X   \n"
-		"X           X     X X   X X X X X   X   X X       \n"
-		"X X X X X X X       X         X X     X X     X X \n");
+		"                X X   X   X   X X                 \n"
+		"          X X       X               X   X   X   X \n"
+		"X X X X   X     X       X   X           X   X   X \n"
+		"      X     X   X       X           X X X X     X \n"
+		"X   X X X     X X   X   X     X X   X   X     X X \n"
+		"X     X X X X       X X     X   X X       X X     \n"
+		"X X     X     X         X X     X X X X X         \n"
+		"X   X     X X X X X X     X X       X   X X     X \n"
+		"X   X   X       X         X   X     X X X   X   X \n"
+		"X   X   X   X X X     X     X   X X X X X X       \n"
+		"                X           X X X       X X   X   \n"
+		"X X X X X X X     X X X X     X X   X   X X   X X \n"
+		"X           X   X X X       X   X       X X     X \n"
+		"X   X X X   X     X X   X     X X X X X X X X   X \n"
+		"X   X X X   X     X         X X X   X   X   X     \n"
+		"X   X X X   X     X   X     X X     X           X \n"
+		"X           X         X     X     X     X     X X \n"
+		"X X X X X X X           X X X     X   X X X X   X \n");
 }
 
 TEST(QREncoderTest, EncodeGS1ModeHeaderWithECI)
@@ -350,6 +323,46 @@ TEST(QREncoderTest, EncodeGS1ModeHeaderWithECI)
 		"X X X X X X X     X X X   X X   X     X   \n");
 }
 
+TEST(QREncoderTest, EncodeMixedModes)
+{
+	// byte mode only: 4 + 8 + 44 * 8 = 364 bits -> version 3
+	// byte + numeric: (4 + 8 + 4 * 8) + (4 + 10 + 134) = 192 bits -> version 2
+	std::wstring text = L"tel:0123456789012345678901234567890123456789";
+	auto qrCode = Encode(text, ErrorCorrectionLevel::Low, CharacterSet::Unknown, 0, false, -1);
+	EXPECT_EQ(qrCode.mode, CodecMode::BYTE);
+	ASSERT_NE(qrCode.version, nullptr);
+	EXPECT_EQ(qrCode.version->versionNumber(), 2);
+	EXPECT_EQ(Decode(qrCode.matrix).text(), text);
+
+	// Kanji with Shift_JIS, no ECI needed without byte mode segment
+	text = L"\u65e5\u672c123456789";
+	qrCode = Encode(text, ErrorCorrectionLevel::Medium, CharacterSet::Shift_JIS, 0, false, -1);
+	EXPECT_EQ(qrCode.mode, CodecMode::KANJI);
+	EXPECT_EQ(Decode(qrCode.matrix).text(), text);
+
+	for (auto str : {L"ABC-12345678901234-xyz", L"Order 4711: 20 x ITEM-0815 @ 12.50 EUR, ship to 80331 M\u00fcnchen",
+					 L"\u00e4\u00f6\u00fc12345\u65e5\u672cABCDEFGHIJ"}) {
+		qrCode = Encode(str, ErrorCorrectionLevel::Medium, CharacterSet::UTF8, 0, false, -1);
+		EXPECT_EQ(Decode(qrCode.matrix).text(), str);
+	}
+
+	// '\\' is 2 bytes in Shift_JIS: 4 + 8 (ECI) + 4 + 8 + 10 * 16 = 184 bits -> version 2 (version 1-L holds 152)
+	text = std::wstring(10, L'\\');
+	qrCode = Encode(text, ErrorCorrectionLevel::Low, CharacterSet::Shift_JIS, 0, false, -1);
+	EXPECT_EQ(qrCode.mode, CodecMode::BYTE);
+	ASSERT_NE(qrCode.version, nullptr);
+	EXPECT_EQ(qrCode.version->versionNumber(), 2);
+	EXPECT_EQ(Decode(qrCode.matrix).text(), qrCode.content.utfW());
+
+	// numeric and alphanumeric segments are read in the ECI charset, so UTF-16 and UTF-32 only use byte mode
+	text = L"abc12345678901234567890";
+	for (auto charset : {CharacterSet::UTF16BE, CharacterSet::UTF16LE, CharacterSet::UTF32BE, CharacterSet::UTF32LE}) {
+		qrCode = Encode(text, ErrorCorrectionLevel::Medium, charset, 0, false, -1);
+		EXPECT_EQ(qrCode.mode, CodecMode::BYTE);
+		EXPECT_EQ(Decode(qrCode.matrix).text(), text) << ToString(charset);
+	}
+}
+
 TEST(QREncoderTest, AppendModeInfo)
 {
 	BitArray bits;
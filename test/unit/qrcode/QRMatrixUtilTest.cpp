@@ -0,0 +1,114 @@
+/*
+* Copyright 2026 ZXing authors
+*/
+// SPDX-License-Identifier: Apache-2.0
+
+#include "BitArray.h"
+#include "PseudoRandom.h"
+#include "qrcode/QRErrorCorrectionLevel.h"
+#include "qrcode/QRMaskUtil.h"
+#include "qrcode/QRMatrixUtil.h"
+#include "qrcode/QRVersion.h"
+
+#include "gtest/gtest.h"
+
+#include <array>
+#include <cstdlib>
+#include <limits>
+
+using namespace ZXing;
+using namespace ZXing::QRCode;
+
+namespace {
+
+// Straightforward implementation of the four penalty rules of ISO/IEC 18004:2015 section 7.8.3.1
+int ReferencePenalty(const TritMatrix& matrix)
+{
+	const int width = matrix.width(), height = matrix.height();
+	auto bit = [&](int x, int y, bool transpose) { return bool(transpose ? matrix.get(y, x) : matrix.get(x, y)); };
+	int penalty = 0;
+
+	for (bool transpose : {false, true}) {
+		const int rows = transpose ? width : height, cols = transpose ? height : width;
+		for (int y = 0; y < rows; ++y) {
+			// rule 1: runs of 5 or more modules of the same color
+			for (int x = 0; x < cols;) {
+				int run = 1;
+				while (x + run < cols && bit(x + run, y, transpose) == bit(x, y, transpose))
+					++run;
+				if (run >= 5)
+					penalty += 3 + run - 5;
+				x += run;
+			}
+			// rule 3: 1:1:3:1:1 finder-like pattern with 4 light modules (or the border) on one side
+			constexpr std::array<bool, 7> finder = {1, 0, 1, 1, 1, 0, 1};
+			for (int x = 0; x + 7 <= cols; ++x) {
+				bool found = true;
+				for (int i = 0; i < 7; ++i)
+					found &= bit(x + i, y, transpose) == finder[i];
+				if (!found)
+					continue;
+				bool lightBefore = true, lightAfter = true;
+				for (int i = 1; i <= 4; ++i) {
+					lightBefore &= x - i < 0 || !bit(x - i, y, transpose);
+					lightAfter &= x + 6 + i >= cols || !bit(x + 6 + i, y, transpose);
+				}
+				if (lightBefore || lightAfter)
+					penalty += 40;
+			}
+		}
+	}
+
+	// rule 2: 2x2 blocks of the same color
+	for (int y = 0; y + 1 < height; ++y)
+		for (int x = 0; x + 1 < width; ++x)
+			if (bit(x, y, false) == bit(x + 1, y, false) && bit(x, y, false) == bit(x, y + 1, false)
+				&& bit(x, y, false) == bit(x + 1, y + 1, false))
+				penalty += 3;
+
+	// rule 4: deviation of the proportion of dark modules from 50% in steps of 5%
+	int numDark = 0;
+	for (int y = 0; y < height; ++y)
+		for (int x = 0; x < width; ++x)
+			numDark += bit(x, y, false);
+	int numTotal = width * height;
+	penalty += std::abs(numDark * 2 - numTotal) * 10 / numTotal * 10;
+
+	return penalty;
+}
+
+} // namespace
+
+TEST(QRMatrixUtilTest, ChooseMaskPatternMatchesReference)
+{
+	PseudoRandom random(42);
+	for (int versionNumber = 1; versionNumber <= 40; ++versionNumber) {
+		const Version& version = *Version::Model2(versionNumber);
+		for (auto ecLevel : {ErrorCorrectionLevel::Low, ErrorCorrectionLevel::Medium, ErrorCorrectionLevel::Quality,
+							 ErrorCorrectionLevel::High}) {
+			BitArray dataBits;
+			for (int i = 0; i < version.totalCodewords(); ++i)
+				dataBits.appendBits(random.next(0, 255), 8);
+
+			TritMatrix matrix(version.dimension(), version.dimension());
+			int minPenalty = std::numeric_limits<int>::max();
+			int bestMaskPattern = -1;
+			for (int maskPattern = 0; maskPattern < NUM_MASK_PATTERNS; ++maskPattern) {
+				BuildMatrix(dataBits, ecLevel, version, maskPattern, matrix);
+				int penalty = ReferencePenalty(matrix);
+				ASSERT_EQ(MaskUtil::CalculateMaskPenalty(matrix), penalty)
+					<< "version " << versionNumber << ", ec " << ToString(ecLevel) << ", mask " << maskPattern;
+				if (penalty < minPenalty) {
+					minPenalty = penalty;
+					bestMaskPattern = maskPattern;
+				}
+			}
+
+			int maskPattern = ChooseMaskPattern(dataBits, ecLevel, version, matrix);
+			EXPECT_EQ(maskPattern, bestMaskPattern) << "version " << versionNumber << ", ec " << ToString(ecLevel);
+
+			BuildMatrix(dataBits, ecLevel, version, maskPattern, matrix);
+			EXPECT_EQ(ReferencePenalty(matrix), minPenalty) << "version " << versionNumber << ", ec " << ToString(ecLevel);
+		}
+	}
+}
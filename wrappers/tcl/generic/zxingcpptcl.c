@@ -53,7 +53,47 @@ static int ZXingCppDecodeHandleEvent(Tcl_Event *evPtr, int flags);
 static int ArgumentToZXingCppVisual(ClientData tkFlagPtr, Tcl_Interp *interp,
 	ZXing_ImageView **ivPtr, Tcl_Obj *const argObj);
 static int BarcodesToResultList(Tcl_Interp *interp, Tcl_Obj *resultList, 
-	Tcl_WideInt td, ZXing_Barcodes* barcodes);
+	Tcl_WideInt td, ZXing_Barcodes* barcodes, int resultKeys);
+static Tcl_Obj *ResultKeyObj(int key);
+
+/*
+ * Keys of the result dicts
+ */
+
+static const char *resultKeyNames[] = {
+    "text", "format", "bytes", "bytesECI", "content", "symbologyIdentifier",
+    "hasECI", "ecLevel", "position", "orientation", "isMirrored",
+    "isInverted", "gs1", "errorType", "errorMsg",
+    NULL};
+enum iResultKeyNames {
+    iKeyText, iKeyFormat, iKeyBytes, iKeyBytesECI, iKeyContent,
+    iKeySymbologyIdentifier, iKeyHasECI, iKeyEcLevel, iKeyPosition,
+    iKeyOrientation, iKeyIsMirrored, iKeyIsInverted, iKeyGS1,
+    iKeyErrorType, iKeyErrorMsg, iKeyCount
+};
+
+/*
+ * Maximum number of GS1 element strings reported by the gs1 result key.
+ * A symbol can not hold more than a few dozen of them.
+ */
+#define GS1_ELEMENTS_MAX 64
+
+/* Bit field of result keys, default: all keys */
+#define RESULT_KEY(key) (1 << (key))
+#define RESULT_KEYS_ALL (RESULT_KEY(iKeyCount) - 1)
+
+/*
+ * Result key objects are shared by all result dicts of a thread.
+ * Tcl objects may not be shared between threads, so they are kept in
+ * thread specific data.
+ */
+
+typedef struct {
+    int initialized;
+    Tcl_Obj *keyObjs[iKeyCount];
+} ThreadSpecificData;
+
+static Tcl_ThreadDataKey dataKey;
 
 /*
  *-------------------------------------------------------------------------
@@ -142,7 +182,8 @@ ZxingcppFormatsObjCmd(ClientData unused, Tcl_Interp *interp,
  */
 
 static int
-ReaderOptionsGet(Tcl_Interp *interp, int objc, Tcl_Obj *const objv[], ZXing_ReaderOptions* opts)
+ReaderOptionsGet(Tcl_Interp *interp, int objc, Tcl_Obj *const objv[],
+	ZXing_ReaderOptions* opts, int *resultKeysPtr)
 {
     int option;
     const char *options[] = {
@@ -151,7 +192,7 @@ ReaderOptionsGet(Tcl_Interp *interp, int objc, Tcl_Obj *const objv[], ZXing_Read
 #endif
 	"TryHarder", "TryRotate", "TryInvert", "TryDownscale",
 	"IsPure", "ReturnErrors", "Formats", "Binarizer", "EanAddOnSymbol",
-	"TextMode", "MinLineCount", "MaxNumberOfSymbols",
+	"TextMode", "MinLineCount", "MaxNumberOfSymbols", "ResultKeys",
 	NULL};
     enum iOptions {
 #ifdef ZXING_EXPERIMENTAL_API
@@ -159,9 +200,11 @@ ReaderOptionsGet(Tcl_Interp *interp, int objc, Tcl_Obj *const objv[], ZXing_Read
 #endif
 	iTryHarder, iTryRotate, iTryInvert, iTryDownscale,
 	iIsPure, iReturnErrors, iFormats, iBinarizer,iEanAddOnSymbol,
-	iTextMode, iMinLineCount, iMaxNumberOfSymbols
+	iTextMode, iMinLineCount, iMaxNumberOfSymbols, iResultKeys
 	};
 
+    *resultKeysPtr = RESULT_KEYS_ALL;
+
     /*
      * Check for pair option count
      */
@@ -372,22 +415,592 @@ ReaderOptionsGet(Tcl_Interp *interp, int objc, Tcl_Obj *const objv[], ZXing_Read
 		/* Default: 255 */
 	    ZXing_ReaderOptions_setMaxNumberOfSymbols(opts, intValue);
 	    break;
+	case iResultKeys:
+	    {
+		/*
+		 * List of keys to include in the result dicts.
+		 * This is not a zxing-cpp option but avoids to build unused
+		 * result objects.
+		 * Default: all keys
+		 */
+
+		Tcl_Size listLength, listItem;
+
+		if (TCL_OK != Tcl_ListObjLength(interp,objv[argPos],&listLength)) {
+		    return TCL_ERROR;
+		}
+		*resultKeysPtr = 0;
+		for ( listItem = 0; listItem < listLength; listItem++ ) {
+		    Tcl_Obj *keyObj;
+		    int key;
+
+		    if (TCL_OK != Tcl_ListObjIndex(interp, objv[argPos], listItem,
+			    &keyObj) ) {
+			return TCL_ERROR;
+		    }
+		    if (TCL_OK != Tcl_GetIndexFromObj(interp, keyObj,
+			    resultKeyNames, "result key", TCL_EXACT, &key))
+		    {
+			return TCL_ERROR;
+		    }
+		    *resultKeysPtr |= RESULT_KEY(key);
+		}
+	    }
+	    break;
+	}
+    }
+    return TCL_OK;
+}
+
+/*
+ * Encode job: settings and payloads of zxingcpp::encode,
+ * zxingcpp::encode_batch and zxingcpp::async_encode.
+ * The payloads are copied to a single memory block, so that a job may be
+ * handed over to the worker thread.
+ */
+
+typedef struct {
+    ZXing_CreatorOptions *copts;	/* Symbology and encoder settings */
+    ZXing_WriterOptions *wopts;	/* Image rendering settings */
+    int binary;			/* Payloads are byte arrays */
+    int numThreads;		/* Batch threads, 0: number of cores */
+    Tcl_Obj *photoObj;		/* Photo to write to or NULL */
+    int count;			/* Number of payloads */
+    const char **data;		/* Payload pointers into the block */
+    int *sizes;			/* Payload lengths in bytes */
+} EncodeJob;
+
+/*
+ *-------------------------------------------------------------------------
+ *
+ * ImagesFree --
+ *
+ *	Free an image array returned by EncodeImages.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+static void
+ImagesFree(ZXing_Image **images, int count)
+{
+    for (int i = 0; i < count; i++) {
+	if (images[i] != NULL) {
+	    ZXing_Image_delete(images[i]);
+	}
+    }
+    ckfree((char *) images);
+}
+
+#ifdef ZXING_EXPERIMENTAL_API
+
+/*
+ *-------------------------------------------------------------------------
+ *
+ * EncodeJobFree --
+ *
+ *	Free an encode job including its options and payloads.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+static void
+EncodeJobFree(EncodeJob *jobPtr)
+{
+    if (jobPtr->copts != NULL) {
+	ZXing_CreatorOptions_delete(jobPtr->copts);
+    }
+    if (jobPtr->wopts != NULL) {
+	ZXing_WriterOptions_delete(jobPtr->wopts);
+    }
+    if (jobPtr->data != NULL) {
+	ckfree((char *) jobPtr->data);
+    }
+    ckfree((char *) jobPtr);
+}
+
+/*
+ *-------------------------------------------------------------------------
+ *
+ * EncoderOptionsGet --
+ *
+ *	Extract command arguments and translate them to creator and writer
+ *	options of the given encode job.
+ *
+ *		objc	count of given parameters and values
+ *		objv	parameter object array. Contains arbitrary number of
+ *			option/value pairs
+ *		jobPtr	encode job with initialized option objects
+ *
+ *	Result:
+ *
+ *		TCL_OK		Options are processed
+ *		TCL_ERROR	An error occured. The error message of the
+ *				interpreter is set.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+static int
+EncoderOptionsGet(Tcl_Interp *interp, int objc, Tcl_Obj *const objv[],
+	EncodeJob *jobPtr)
+{
+    int option;
+    const char *options[] = {
+	"Binary", "EcLevel", "ForceSquareDataMatrix", "Options", "Photo",
+	"ReaderInit", "Rotate", "Scale", "SizeHint", "Threads", "WithHRT",
+	"WithQuietZones",
+	NULL};
+    enum iOptions {
+	iBinary, iEcLevel, iForceSquareDataMatrix, iOptions, iPhoto,
+	iReaderInit, iRotate, iScale, iSizeHint, iThreads, iWithHRT,
+	iWithQuietZones
+	};
+
+    if ( (objc %2) != 0) {
+	Tcl_SetResult(interp, "Option without value", TCL_STATIC);
+	return TCL_ERROR;
+    }
+
+    for (int argPos = 0; argPos < objc; argPos++) {
+
+	int intValue;
+
+	/* get the option */
+	if (TCL_OK !=
+		Tcl_GetIndexFromObj(interp, objv[argPos], options, "subcmd", argPos, &option))
+	{
+	    return TCL_ERROR;
+	}
+	/* get the following parameter value */
+	argPos++;
+
+	/*
+	 * get parameters of options with common type
+	 */
+
+	switch (option) {
+	case iBinary:
+	case iForceSquareDataMatrix:
+	case iReaderInit:
+	case iWithHRT:
+	case iWithQuietZones:
+	    /* get a boolean value */
+	    if (TCL_OK != Tcl_GetBooleanFromObj(interp,objv[argPos], &intValue)) {
+		return TCL_ERROR;
+	    }
+	    break;
+	case iRotate:
+	case iScale:
+	case iSizeHint:
+	case iThreads:
+	    /* get an int value */
+	    if (TCL_OK != Tcl_GetIntFromObj(interp,objv[argPos], &intValue)) {
+		return TCL_ERROR;
+	    }
+	    break;
+	}
+
+	/*
+	 * set the setting
+	 */
+
+	switch (option) {
+	case iBinary:
+		/* Default: 0, payloads are text */
+	    jobPtr->binary = intValue;
+	    break;
+	case iEcLevel:
+		/* Default: empty, symbology default */
+	    ZXing_CreatorOptions_setEcLevel(jobPtr->copts,
+		    Tcl_GetString(objv[argPos]));
+	    break;
+	case iForceSquareDataMatrix:
+		/* Default: 0 */
+	    ZXing_CreatorOptions_setForceSquareDataMatrix(jobPtr->copts,
+		    intValue);
+	    break;
+	case iOptions:
+		/* Default: empty, symbology specific like "gs1" */
+	    ZXing_CreatorOptions_setOptions(jobPtr->copts,
+		    Tcl_GetString(objv[argPos]));
+	    break;
+	case iPhoto:
+		/* Default: none, return image data */
+	    jobPtr->photoObj = objv[argPos];
+	    break;
+	case iReaderInit:
+		/* Default: 0 */
+	    ZXing_CreatorOptions_setReaderInit(jobPtr->copts, intValue);
+	    break;
+	case iRotate:
+		/* Default: 0 */
+	    ZXing_WriterOptions_setRotate(jobPtr->wopts, intValue);
+	    break;
+	case iScale:
+		/* Default: 0, automatic */
+	    ZXing_WriterOptions_setScale(jobPtr->wopts, intValue);
+	    break;
+	case iSizeHint:
+		/* Default: 0, automatic */
+	    ZXing_WriterOptions_setSizeHint(jobPtr->wopts, intValue);
+	    break;
+	case iThreads:
+		/* Default: 0, number of cores */
+	    jobPtr->numThreads = intValue;
+	    break;
+	case iWithHRT:
+		/* Default: 0 */
+	    ZXing_WriterOptions_setWithHRT(jobPtr->wopts, intValue);
+	    break;
+	case iWithQuietZones:
+		/* Default: 1 */
+	    ZXing_WriterOptions_setWithQuietZones(jobPtr->wopts, intValue);
+	    break;
+	}
+    }
+    return TCL_OK;
+}
+
+/*
+ *-------------------------------------------------------------------------
+ *
+ * EncodePayloadsGet --
+ *
+ *	Copy the payloads of an encode job to a single memory block.
+ *	Text payloads are converted to utf-8, byte array payloads are copied
+ *	verbatim.
+ *
+ *		payloadsObj	single payload or list of payloads
+ *		isList		payloadsObj is a list of payloads
+ *		jobPtr		encode job to set count, data and sizes
+ *
+ *	Result is a standard Tcl result.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+static int
+EncodePayloadsGet(Tcl_Interp *interp, Tcl_Obj *payloadsObj, int isList,
+	EncodeJob *jobPtr)
+{
+    Tcl_Obj **payloadObjs;
+    Tcl_Size count, length;
+    Tcl_Encoding utf8Encoding = NULL;
+    Tcl_DString all, recode;
+    char *block;
+    int *offsets;
+
+    if (isList) {
+	if (Tcl_ListObjGetElements(interp, payloadsObj, &count, &payloadObjs)
+		!= TCL_OK) {
+	    return TCL_ERROR;
 	}
+    } else {
+	count = 1;
+	payloadObjs = &payloadsObj;
     }
+
+    /*
+     * Collect the payload bytes and their end offsets
+     */
+
+    Tcl_DStringInit(&all);
+    offsets = (int *) ckalloc(sizeof(int) * (count + 1));
+    offsets[0] = 0;
+    for (Tcl_Size i = 0; i < count; i++) {
+	if (jobPtr->binary) {
+	    const unsigned char *bytes =
+		    Tcl_GetByteArrayFromObj(payloadObjs[i], &length);
+	    Tcl_DStringAppend(&all, (const char *) bytes, length);
+	} else {
+	    const char *pos, *string;
+
+	    string = Tcl_GetStringFromObj(payloadObjs[i], &length);
+
+	    /*
+	     * Pure ASCII strings are identical in utf-8 and are used
+	     * directly, see Utf8ToObj.
+	     */
+
+	    for (pos = string; pos < string + length
+		    && (unsigned char) *pos < 0x80; pos++) {
+	    }
+	    if (pos == string + length) {
+		Tcl_DStringAppend(&all, string, length);
+	    } else {
+		if (utf8Encoding == NULL) {
+		    utf8Encoding = Tcl_GetEncoding(interp, "utf-8");
+		}
+		Tcl_UtfToExternalDString(utf8Encoding, string, length,
+			&recode);
+		Tcl_DStringAppend(&all, Tcl_DStringValue(&recode),
+			Tcl_DStringLength(&recode));
+		Tcl_DStringFree(&recode);
+	    }
+	}
+	offsets[i + 1] = Tcl_DStringLength(&all);
+
+	/*
+	 * Empty payloads can not be encoded. ZXing_CreateBarcodesFromTexts
+	 * would also take a size of 0 as NUL terminated string.
+	 */
+
+	if (offsets[i + 1] == offsets[i]) {
+	    if (utf8Encoding != NULL) {
+		Tcl_FreeEncoding(utf8Encoding);
+	    }
+	    ckfree((char *) offsets);
+	    Tcl_DStringFree(&all);
+	    if (isList) {
+		Tcl_SetObjResult(interp, Tcl_ObjPrintf(
+			"payload %d is empty", (int) i));
+	    } else {
+		Tcl_SetResult(interp, "payload is empty", TCL_STATIC);
+	    }
+	    return TCL_ERROR;
+	}
+    }
+    if (utf8Encoding != NULL) {
+	Tcl_FreeEncoding(utf8Encoding);
+    }
+
+    /*
+     * Memory block layout: count data pointers, count sizes, bytes
+     */
+
+    block = ckalloc(count * (sizeof(char *) + sizeof(int))
+	    + Tcl_DStringLength(&all) + 1);
+    jobPtr->count = count;
+    jobPtr->data = (const char **) block;
+    jobPtr->sizes = (int *) (block + count * sizeof(char *));
+    block += count * (sizeof(char *) + sizeof(int));
+    memcpy(block, Tcl_DStringValue(&all), Tcl_DStringLength(&all) + 1);
+    for (Tcl_Size i = 0; i < count; i++) {
+	jobPtr->data[i] = block + offsets[i];
+	jobPtr->sizes[i] = offsets[i + 1] - offsets[i];
+    }
+    ckfree((char *) offsets);
+    Tcl_DStringFree(&all);
     return TCL_OK;
 }
+
+/*
+ *-------------------------------------------------------------------------
+ *
+ * EncodeJobGet --
+ *
+ *	Create an encode job from command arguments.
+ *
+ *		formatObj	symbology as returned by zxingcpp::formats
+ *		payloadsObj	single payload or list of payloads
+ *		isList		payloadsObj is a list of payloads
+ *		objc, objv	option/value pairs
+ *		jobPtrPtr	to save the new job to. To be freed by
+ *				EncodeJobFree.
+ *
+ *	Result is a standard Tcl result.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+static int
+EncodeJobGet(Tcl_Interp *interp, Tcl_Obj *formatObj, Tcl_Obj *payloadsObj,
+	int isList, int objc, Tcl_Obj *const objv[], EncodeJob **jobPtrPtr)
+{
+    EncodeJob *jobPtr;
+    ZXing_BarcodeFormat format;
+    const char *formatString = Tcl_GetString(formatObj);
+
+    /*
+     * A single format is required, no special values like "Any"
+     */
+
+    format = ZXing_BarcodeFormatFromString(formatString);
+    if (format == ZXing_BarcodeFormat_Invalid
+	    || format == ZXing_BarcodeFormat_None
+	    || (format & (format - 1)) != 0) {
+	Tcl_SetObjResult(interp, Tcl_ObjPrintf(
+		"zxing-cpp format \"%s\" not found", formatString ) );
+	return TCL_ERROR;
+    }
+
+    jobPtr = (EncodeJob *) ckalloc(sizeof(EncodeJob));
+    memset(jobPtr, 0, sizeof(EncodeJob));
+    jobPtr->copts = ZXing_CreatorOptions_new(format);
+    jobPtr->wopts = ZXing_WriterOptions_new();
+    if (jobPtr->copts == NULL || jobPtr->wopts == NULL) {
+	char* error = ZXing_LastErrorMsg();
+	Tcl_SetObjResult( interp, Tcl_NewStringObj(error,-1) );
+	ZXing_free(error);
+	EncodeJobFree(jobPtr);
+	return TCL_ERROR;
+    }
+
+    if (TCL_OK != EncoderOptionsGet(interp, objc, objv, jobPtr)
+	    || TCL_OK != EncodePayloadsGet(interp, payloadsObj, isList, jobPtr))
+    {
+	EncodeJobFree(jobPtr);
+	return TCL_ERROR;
+    }
+    if (isList && jobPtr->photoObj != NULL) {
+	Tcl_SetResult(interp, "option Photo requires a single payload",
+		TCL_STATIC);
+	EncodeJobFree(jobPtr);
+	return TCL_ERROR;
+    }
+
+    *jobPtrPtr = jobPtr;
+    return TCL_OK;
+}
+
+/*
+ *-------------------------------------------------------------------------
+ *
+ * EncodeImages --
+ *
+ *	Create the barcodes of an encode job and render them to images.
+ *	The barcodes are created by zxing-cpp in parallel.
+ *	This function does not use the interpreter and may be called
+ *	in the worker thread.
+ *
+ *		jobPtr		encode job
+ *		errorPtr	to save the error message in case of an
+ *				error. To be freed by ZXing_free.
+ *
+ *	Result is an array of jobPtr->count images to be freed by
+ *	ImagesFree or NULL on error.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+static ZXing_Image **
+EncodeImages(EncodeJob *jobPtr, char **errorPtr)
+{
+    ZXing_Barcodes *barcodes;
+    ZXing_Image **images;
+
+    if (jobPtr->binary) {
+	barcodes = ZXing_CreateBarcodesFromBytes(
+		(const void *const *) jobPtr->data, jobPtr->sizes,
+		jobPtr->count, jobPtr->copts, jobPtr->numThreads);
+    } else {
+	barcodes = ZXing_CreateBarcodesFromTexts(jobPtr->data, jobPtr->sizes,
+		jobPtr->count, jobPtr->copts, jobPtr->numThreads);
+    }
+    if (barcodes == NULL) {
+	*errorPtr = ZXing_LastErrorMsg();
+	return NULL;
+    }
+
+    images = (ZXing_Image **) ckalloc(sizeof(ZXing_Image *)
+	    * (jobPtr->count + 1));
+    memset(images, 0, sizeof(ZXing_Image *) * (jobPtr->count + 1));
+    for (int i = 0; i < jobPtr->count; i++) {
+	images[i] = ZXing_WriteBarcodeToImage(ZXing_Barcodes_at(barcodes, i),
+		jobPtr->wopts);
+	if (images[i] == NULL) {
+	    *errorPtr = ZXing_LastErrorMsg();
+	    ImagesFree(images, i);
+	    ZXing_Barcodes_delete(barcodes);
+	    return NULL;
+	}
+    }
+    ZXing_Barcodes_delete(barcodes);
+    return images;
+}
+
+/*
+ *-------------------------------------------------------------------------
+ *
+ * ImageToObj --
+ *
+ *	Return a greyscale image as list {width height 1 bytes}, which is
+ *	also accepted by the decode commands.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+static Tcl_Obj *
+ImageToObj(const ZXing_Image *image)
+{
+    Tcl_Obj *elems[4];
+    int width = ZXing_Image_width(image);
+    int height = ZXing_Image_height(image);
+
+    elems[0] = Tcl_NewIntObj(width);
+    elems[1] = Tcl_NewIntObj(height);
+    elems[2] = Tcl_NewIntObj(1);
+    elems[3] = Tcl_NewByteArrayObj(ZXing_Image_data(image), width * height);
+    return Tcl_NewListObj(4, elems);
+}
+
+/*
+ *-------------------------------------------------------------------------
+ *
+ * ImageToPhoto --
+ *
+ *	Write a greyscale image to a Tk photo image, which is resized to
+ *	the image size.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+static int
+ImageToPhoto(int *tkFlagPtr, Tcl_Interp *interp, Tcl_Obj *photoObj,
+	const ZXing_Image *image)
+{
+#ifdef ZXINGCPP_NO_TK
+    Tcl_SetResult(interp, "option Photo requires Tk", TCL_STATIC);
+    return TCL_ERROR;
+#else
+    Tk_PhotoHandle handle;
+    Tk_PhotoImageBlock block;
+
+    if (CheckForTk(interp, tkFlagPtr) != TCL_OK) {
+	return TCL_ERROR;
+    }
+    handle = Tk_FindPhoto(interp, Tcl_GetString(photoObj));
+    if (handle == NULL) {
+	Tcl_SetObjResult(interp, Tcl_ObjPrintf("photo \"%s\" not found",
+					       Tcl_GetString(photoObj)));
+	return TCL_ERROR;
+    }
+
+    /* greyscale without alpha channel, see ArgumentToZXingCppVisual */
+    block.pixelPtr = (unsigned char *) ZXing_Image_data(image);
+    block.width = ZXing_Image_width(image);
+    block.height = ZXing_Image_height(image);
+    block.pitch = block.width;
+    block.pixelSize = 1;
+    block.offset[0] = 0;
+    block.offset[1] = 0;
+    block.offset[2] = 0;
+    block.offset[3] = -1;
+
+    Tk_PhotoBlank(handle);
+    if (Tk_PhotoSetSize(interp, handle, block.width, block.height)
+	    != TCL_OK) {
+	return TCL_ERROR;
+    }
+    return Tk_PhotoPutBlock(interp, handle, &block, 0, 0, block.width,
+	    block.height, TK_PHOTO_COMPOSITE_SET);
+#endif
+}
+
+#endif /* ZXING_EXPERIMENTAL_API */
 
 
 #ifdef TCL_THREADS
 
 /*
- * Structure used for asynchronous decoding carried out by
- * a dedicated thread. At most, one decoding job can be
+ * Structure used for asynchronous decoding and encoding carried out by
+ * a dedicated thread. At most, one decoding or encoding job can be
  * outstanding at any one time.
  */
 
 typedef struct {
     int tip609;			/* When true, TIP#609 is available */
+    int nCmds;			/* Number of commands using this struct */
     int *tkFlagPtr;		/* Tk presence flag */
     int run;			/* Controls thread loop */
     Tcl_Mutex mutex;		/* Lock for this struct */
@@ -401,11 +1014,20 @@ typedef struct {
 
     /* Thread input: zxingcpp settings */
     ZXing_ReaderOptions *opts;
+    int resultKeys;		/* Bit field of result dict keys */
+
+    /* Thread input: encode job */
+    EncodeJob *job;
 
     /* Thread output: ms, barcodes structure or error message */
     Tcl_WideInt ms;
     ZXing_Barcodes* barcodes;
     char* error;
+
+    /* Thread output of an encode job: images or error message */
+    int encoded;		/* Output is from an encode job */
+    ZXing_Image **images;
+    int nImages;
 } AsyncDecode;
 
 /*
@@ -424,7 +1046,7 @@ typedef struct {
  *
  * ZXingCppThread --
  *
- *	Decoder thread, waits per condition for a decode request.
+ *	Decoder thread, waits per condition for a decode or encode request.
  *	Reports the result back by an asynchronous event which
  *	triggers a do-when-idle handler in the requesting thread.
  *
@@ -435,7 +1057,9 @@ static Tcl_ThreadCreateType
 ZXingCppThread(ClientData clientData)
 {
     AsyncDecode *aPtr = (AsyncDecode *) clientData;
-    ZXing_Barcodes* barcodes;
+    ZXing_Barcodes* barcodes = NULL;
+    ZXing_Image **images = NULL;
+    int encoded, nImages = 0;
     char * error;
     Tcl_Time now;
     int isNew;
@@ -444,19 +1068,23 @@ ZXingCppThread(ClientData clientData)
 
     Tcl_MutexLock(&aPtr->mutex);
     for (;;) {
-	while (aPtr->run && (aPtr->iv == NULL)) {
+	while (aPtr->run && (aPtr->iv == NULL) && (aPtr->job == NULL)) {
 	    Tcl_ConditionWait(&aPtr->cond, &aPtr->mutex, NULL);
 	}
 	if (!aPtr->run) {
 	    break;
 	}
-	if (aPtr->iv == NULL) {
+	if ((aPtr->iv == NULL) && (aPtr->job == NULL)) {
 	    continue;
 	}
 	if (aPtr->barcodes != NULL) {
 	    ZXing_Barcodes_delete(aPtr->barcodes);
 	    aPtr->barcodes = NULL;
 	}
+	if (aPtr->images != NULL) {
+	    ImagesFree(aPtr->images, aPtr->nImages);
+	    aPtr->images = NULL;
+	}
 	if (aPtr->error != NULL) {
 	    ZXing_free(aPtr->error);
 	    aPtr->error = NULL;
@@ -465,15 +1093,22 @@ ZXingCppThread(ClientData clientData)
 	Tcl_GetTime(&now);
 	tw[0] = (Tcl_WideInt) now.sec * 1000 + now.usec / 1000;
 
+	error = NULL;
+	encoded = (aPtr->iv == NULL);
+	if (encoded) {
+#ifdef ZXING_EXPERIMENTAL_API
+	    nImages = aPtr->job->count;
+	    images = EncodeImages(aPtr->job, &error);
+#endif
+	} else {
 #ifdef ZXINGCPP_SIMULATE_DECODE_ERROR
-	barcodes = ZXing_ReadBarcodes(NULL, aPtr->opts);
+	    barcodes = ZXing_ReadBarcodes(NULL, aPtr->opts);
 #else
-	barcodes = ZXing_ReadBarcodes(aPtr->iv, aPtr->opts);
+	    barcodes = ZXing_ReadBarcodes(aPtr->iv, aPtr->opts);
 #endif
-	if (barcodes == NULL) {
-	    error = ZXing_LastErrorMsg();
-	} else {
-	    error = NULL;
+	    if (barcodes == NULL) {
+		error = ZXing_LastErrorMsg();
+	    }
 	}
 	
 	Tcl_GetTime(&now);
@@ -484,14 +1119,24 @@ ZXingCppThread(ClientData clientData)
 	}
 	Tcl_MutexLock(&aPtr->mutex);
 
-	ZXing_ImageView_delete(aPtr->iv);
-	aPtr->iv = NULL;
-	ZXing_ReaderOptions_delete(aPtr->opts);
-	aPtr->opts = NULL;
+	if (encoded) {
+#ifdef ZXING_EXPERIMENTAL_API
+	    EncodeJobFree(aPtr->job);
+#endif
+	    aPtr->job = NULL;
+	} else {
+	    ZXing_ImageView_delete(aPtr->iv);
+	    aPtr->iv = NULL;
+	    ZXing_ReaderOptions_delete(aPtr->opts);
+	    aPtr->opts = NULL;
+	}
 
 	if (aPtr->cmdObj != NULL) {
 	    aPtr->ms = ms;
 	    aPtr->barcodes = barcodes;
+	    aPtr->encoded = encoded;
+	    aPtr->images = images;
+	    aPtr->nImages = nImages;
 	    aPtr->error = error;
 	    event = (AsyncEvent *) ckalloc(sizeof(AsyncEvent));
 	    event->header.proc = ZXingCppDecodeHandleEvent;
@@ -512,10 +1157,15 @@ ZXingCppThread(ClientData clientData)
 	    if (barcodes != NULL) {
 		ZXing_Barcodes_delete(barcodes);
 	    }
+	    if (images != NULL) {
+		ImagesFree(images, nImages);
+	    }
 	    if (error != NULL) {
 		ZXing_free(error);
 	    }
 	}
+	barcodes = NULL;
+	images = NULL;
     }
     Tcl_MutexUnlock(&aPtr->mutex);
     Tcl_ExitThread(0);
@@ -527,7 +1177,7 @@ ZXingCppThread(ClientData clientData)
  *
  * ZXingCppDecodeHandleEvent --
  *
- *	Process decode completion event.
+ *	Process decode or encode completion event.
  *
  *-------------------------------------------------------------------------
  */
@@ -539,9 +1189,12 @@ ZXingCppDecodeHandleEvent(Tcl_Event *evPtr, int flags)
     AsyncDecode *aPtr = aevPtr->aPtr;
     int ret = TCL_OK;
     ZXing_Barcodes* barcodes;
+    ZXing_Image **images;
+    int encoded, nImages;
     char * error;
     Tcl_Obj *cmdObj;
     Tcl_WideInt ms;
+    int resultKeys;
 
     if ((aPtr == NULL) || (aPtr->interpTid == NULL)) {
 	return 1;
@@ -557,8 +1210,13 @@ ZXingCppDecodeHandleEvent(Tcl_Event *evPtr, int flags)
     ms = aPtr->ms;
     barcodes = aPtr->barcodes;
     aPtr->barcodes = NULL;
+    encoded = aPtr->encoded;
+    images = aPtr->images;
+    nImages = aPtr->nImages;
+    aPtr->images = NULL;
     error = aPtr->error;
     aPtr->error = NULL;
+    resultKeys = aPtr->resultKeys;
     
     /*
      * Delete if not used
@@ -568,6 +1226,9 @@ ZXingCppDecodeHandleEvent(Tcl_Event *evPtr, int flags)
 	if (barcodes != NULL) {
 	    ZXing_Barcodes_delete(barcodes);
 	}
+	if (images != NULL) {
+	    ImagesFree(images, nImages);
+	}
 	if (error != NULL) {
 	    ZXing_free(error);
 	}
@@ -602,15 +1263,34 @@ ZXingCppDecodeHandleEvent(Tcl_Event *evPtr, int flags)
 	     * Note that barcode or error may by != 0.
 	     */
 	
-	    ret = BarcodesToResultList(aPtr->interp, cmdObj, ms, barcodes);
+	    ret = BarcodesToResultList(aPtr->interp, cmdObj, ms, barcodes,
+		    resultKeys);
 	    ZXing_Barcodes_delete(barcodes);
 
+	} else if (images != NULL) {
+
+	    /*
+	     * Report the encoded images with a time, one image list
+	     * {width height 1 bytes} per payload
+	     */
+
+	    ret = Tcl_ListObjAppendElement(aPtr->interp, cmdObj,
+		    Tcl_NewWideIntObj(ms));
+#ifdef ZXING_EXPERIMENTAL_API
+	    for (int i = 0; ret == TCL_OK && i < nImages; i++) {
+		ret = Tcl_ListObjAppendElement(aPtr->interp, cmdObj,
+			ImageToObj(images[i]));
+	    }
+#endif
+	    ImagesFree(images, nImages);
+
 	} else {
 
 	    /*
-	     * Report a decoder error with a time and a dict with keys:
-	     * - errorType: DecoderFailure
-	     * - errorMsg: message from decoder
+	     * Report a decoder or encoder error with a time and a dict with
+	     * keys:
+	     * - errorType: DecoderFailure or EncoderFailure
+	     * - errorMsg: message from decoder or encoder
 	     */
 
 	    Tcl_Obj *timeObj;
@@ -625,8 +1305,9 @@ ZXingCppDecodeHandleEvent(Tcl_Event *evPtr, int flags)
 
 		/* Key errorType: */
 		Tcl_DictObjPut(aPtr->interp, resultDict,
-			Tcl_NewStringObj("errorType",-1),
-			Tcl_NewStringObj("DecoderFailure",-1));
+			ResultKeyObj(iKeyErrorType),
+			Tcl_NewStringObj(encoded ? "EncoderFailure"
+				: "DecoderFailure",-1));
     
 		/*
 		 * Key errorMsg:
@@ -641,7 +1322,7 @@ ZXingCppDecodeHandleEvent(Tcl_Event *evPtr, int flags)
 		    errorCur = "No error details reported by ZXing-Cpp";
 		}
 		Tcl_DictObjPut(aPtr->interp, resultDict,
-			Tcl_NewStringObj("errorMsg",-1),
+			ResultKeyObj(iKeyErrorMsg),
 			Tcl_NewStringObj(errorCur,-1));
 		
 		ret = Tcl_ListObjAppendElement(aPtr->interp, cmdObj,
@@ -720,6 +1401,17 @@ ZXingCppAsyncStop(Tcl_Interp *interp, AsyncDecode *aPtr)
 	ZXing_Barcodes_delete(aPtr->barcodes);
 	aPtr->barcodes = NULL;
     }
+    if (aPtr->images != NULL) {
+	ImagesFree(aPtr->images, aPtr->nImages);
+	aPtr->images = NULL;
+    }
+#ifdef ZXING_EXPERIMENTAL_API
+    /* An encode job not picked up by the thread any more */
+    if (aPtr->job != NULL) {
+	EncodeJobFree(aPtr->job);
+	aPtr->job = NULL;
+    }
+#endif
     if (aPtr->error != NULL) {
 	ZXing_free(aPtr->error);
 	aPtr->error = NULL;
@@ -747,7 +1439,7 @@ ZXingCppAsyncStatus(Tcl_Interp *interp, AsyncDecode *aPtr)
     Tcl_MutexLock(&aPtr->mutex);
     if (!aPtr->run) {
 	state = 0;
-    } else if ((aPtr->iv != NULL) ||
+    } else if ((aPtr->iv != NULL) || (aPtr->job != NULL) ||
 	       (aPtr->cmdObj != NULL)) {
 	state = 2;
     } else {
@@ -796,7 +1488,7 @@ ZXingCppAsyncStart(Tcl_Interp *interp, AsyncDecode *aPtr)
 	    aPtr->interpTid = Tcl_GetCurrentThread();
 	    aPtr->run = success = 1;
 	}
-    } else if ((aPtr->iv != NULL) ||
+    } else if ((aPtr->iv != NULL) || (aPtr->job != NULL) ||
 	       (aPtr->cmdObj != NULL)) {
 	success = -1;
     } else {
@@ -804,11 +1496,13 @@ ZXingCppAsyncStart(Tcl_Interp *interp, AsyncDecode *aPtr)
     }
     Tcl_MutexUnlock(&aPtr->mutex);
     if (success < 0) {
-	Tcl_SetResult(interp, "decode process still running", TCL_STATIC);
+	Tcl_SetResult(interp, "decode/encode process still running",
+		TCL_STATIC);
 	return TCL_ERROR;
     }
     if (success == 0) {
-	Tcl_SetResult(interp, "decode process not started", TCL_STATIC);
+	Tcl_SetResult(interp, "decode/encode process not started",
+		TCL_STATIC);
 	return TCL_ERROR;
     }
     return TCL_OK;
@@ -843,7 +1537,9 @@ ZXingCppAsyncFree(char *clientData)
  *
  * ZXingCppAsyncCmdDeleted --
  *
- *	Callback for deletion of zxingcpp::async_decode command.
+ *	Callback for deletion of zxingcpp::async_decode and
+ *	zxingcpp::async_encode commands. The thread structure is freed
+ *	with the last of them.
  *
  *-------------------------------------------------------------------------
  */
@@ -851,7 +1547,11 @@ ZXingCppAsyncFree(char *clientData)
 static void
 ZXingCppAsyncCmdDeleted(ClientData clientData)
 {
-    Tcl_EventuallyFree(clientData, ZXingCppAsyncFree);
+    AsyncDecode *aPtr = (AsyncDecode *) clientData;
+
+    if (--aPtr->nCmds <= 0) {
+	Tcl_EventuallyFree(clientData, ZXingCppAsyncFree);
+    }
 }
 
 /*
@@ -896,6 +1596,7 @@ ZXingCppAsyncDecodeObjCmd(ClientData clientData, Tcl_Interp *interp,
     int nCmdObjs;
     ZXing_ImageView* iv = NULL;
     ZXing_ReaderOptions* opts;
+    int resultKeys;
 
     if ((objc < 2)) {
 	Tcl_WrongNumArgs(interp, 1, objv,
@@ -953,7 +1654,8 @@ ZXingCppAsyncDecodeObjCmd(ClientData clientData, Tcl_Interp *interp,
      */
 
     opts = ZXing_ReaderOptions_new();
-    if (TCL_ERROR == ReaderOptionsGet(interp, objc-3,  &objv[3], opts) ) {
+    if (TCL_ERROR == ReaderOptionsGet(interp, objc-3,  &objv[3], opts,
+	    &resultKeys) ) {
 	ZXing_ReaderOptions_delete(opts);
 	ZXing_ImageView_delete(iv);
 	return TCL_ERROR;
@@ -965,6 +1667,7 @@ ZXingCppAsyncDecodeObjCmd(ClientData clientData, Tcl_Interp *interp,
     
     Tcl_MutexLock(&aPtr->mutex);
     aPtr->opts = opts;
+    aPtr->resultKeys = resultKeys;
     aPtr->iv = iv;
     aPtr->cmdObj = objv[2];
     Tcl_IncrRefCount(aPtr->cmdObj);
@@ -972,6 +1675,113 @@ ZXingCppAsyncDecodeObjCmd(ClientData clientData, Tcl_Interp *interp,
     Tcl_MutexUnlock(&aPtr->mutex);
     return TCL_OK;
 }
+
+#ifdef ZXING_EXPERIMENTAL_API
+
+/*
+ *-------------------------------------------------------------------------
+ *
+ * ZXingCppAsyncEncodeObjCmd --
+ *
+ *	zxingcpp::async_encode Tcl command, asynchronous encoding.
+ *	The thread of zxingcpp::async_decode is used, so only one
+ *	decode or encode job may run at any time.
+ *	Command formats/arguments are
+ *
+ *	Stop (finish) worker thread, releasing resources
+ *
+ *		zxingcpp::async_encode stop
+ *
+ *	Return status of asynchronous decoding/encoding process
+ *
+ *		zxingcpp::async_encode status
+ *
+ *	Start encoding a list of payloads
+ *
+ *		zxingcpp::async_encode format payloads callback ?opt1 val1? ...
+ *
+ *		format		symbology as returned by zxingcpp::formats
+ *		payloads	list of texts or byte arrays to encode
+ *		callback	procedure to invoke at end of
+ *				encoding process
+ *		?opt1 val1? ...	encoder options key-value pairs
+ *
+ *	Arguments appended to callback
+ *
+ *		time		encode/processing time in milliseconds
+ *		image1 ...	image lists {width height 1 bytes},
+ *				one per payload
+ *
+ *-------------------------------------------------------------------------
+ */
+
+static int
+ZXingCppAsyncEncodeObjCmd(ClientData clientData, Tcl_Interp *interp,
+		      int objc,  Tcl_Obj *const objv[])
+{
+    AsyncDecode *aPtr = (AsyncDecode *) clientData;
+    Tcl_Size nCmdObjs;
+    EncodeJob *jobPtr;
+
+    if (objc == 2) {
+	const char *cmd = Tcl_GetString(objv[1]);
+
+	if (strcmp(cmd, "status") == 0) {
+	    return ZXingCppAsyncStatus(interp, aPtr);
+	}
+	if (strcmp(cmd, "stop") == 0) {
+	    return ZXingCppAsyncStop(interp, aPtr);
+	}
+    }
+    if (objc < 4) {
+	Tcl_WrongNumArgs(interp, 1, objv,
+		"status|stop|format payloads callback ?opt1 val1? ...");
+	return TCL_ERROR;
+    }
+
+    /*
+     * Check command object to be a list and to contain more than 1 element
+     */
+
+    if (Tcl_ListObjLength(interp, objv[3], &nCmdObjs) != TCL_OK) {
+	return TCL_ERROR;
+    }
+    if (nCmdObjs <= 0) {
+	Tcl_SetResult(interp, "empty callback", TCL_STATIC);
+	return TCL_ERROR;
+    }
+
+    /*
+     * Get format, payloads and encoder options
+     */
+
+    if (TCL_OK != EncodeJobGet(interp, objv[1], objv[2], 1, objc-4,
+	    &objv[4], &jobPtr) ) {
+	return TCL_ERROR;
+    }
+
+    /*
+     * Start thread and check if eventual last decode/encode event was fired
+     */
+
+    if (ZXingCppAsyncStart(interp, aPtr) != TCL_OK) {
+	EncodeJobFree(jobPtr);
+	return TCL_ERROR;
+    }
+
+    /*
+     * Start encode in worker thread
+     */
+
+    Tcl_MutexLock(&aPtr->mutex);
+    aPtr->job = jobPtr;
+    aPtr->cmdObj = objv[3];
+    Tcl_IncrRefCount(aPtr->cmdObj);
+    Tcl_ConditionNotify(&aPtr->cond);
+    Tcl_MutexUnlock(&aPtr->mutex);
+    return TCL_OK;
+}
+#endif /* ZXING_EXPERIMENTAL_API */
 #endif /* TCL_THREADS */
 
 #ifndef ZXINGCPP_NO_TK
@@ -1227,6 +2037,104 @@ ArgumentToZXingCppVisual(int *tkFlagPtr, Tcl_Interp *interp,
     return TCL_OK;
 }
 
+/*
+ *-------------------------------------------------------------------------
+ *
+ * ResultKeysFinalize --
+ *
+ *	Thread exit handler to free the result key objects of the thread.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+static void
+ResultKeysFinalize(ClientData clientData)
+{
+    ThreadSpecificData *tsdPtr = (ThreadSpecificData *) clientData;
+
+    for (int key = 0; key < iKeyCount; key++) {
+	if (tsdPtr->keyObjs[key] != NULL) {
+	    Tcl_DecrRefCount(tsdPtr->keyObjs[key]);
+	    tsdPtr->keyObjs[key] = NULL;
+	}
+    }
+    tsdPtr->initialized = 0;
+}
+
+/*
+ *-------------------------------------------------------------------------
+ *
+ * ResultKeyObj --
+ *
+ *	Return the shared key object of a result dict key.
+ *	The objects are created on first use within the current thread.
+ *
+ *		key		index into resultKeyNames
+ *
+ *-------------------------------------------------------------------------
+ */
+
+static Tcl_Obj *
+ResultKeyObj(int key)
+{
+    ThreadSpecificData *tsdPtr = (ThreadSpecificData *)
+	    Tcl_GetThreadData(&dataKey, sizeof(ThreadSpecificData));
+
+    if (!tsdPtr->initialized) {
+	for (int i = 0; i < iKeyCount; i++) {
+	    tsdPtr->keyObjs[i] = Tcl_NewStringObj(resultKeyNames[i], -1);
+	    Tcl_IncrRefCount(tsdPtr->keyObjs[i]);
+	}
+	tsdPtr->initialized = 1;
+	Tcl_CreateThreadExitHandler(ResultKeysFinalize, (ClientData) tsdPtr);
+    }
+    return tsdPtr->keyObjs[key];
+}
+
+/*
+ *-------------------------------------------------------------------------
+ *
+ * Utf8ToObj --
+ *
+ *	Create a string object from a zero terminated utf-8 string returned
+ *	by zxingcpp.
+ *
+ *		interp		TCL interpreter
+ *		utf8String	utf-8 encoded string
+ *		encodingPtr	utf-8 encoding, got on first use, if NULL.
+ *				To be freed by the caller.
+ *
+ *	Pure ASCII strings are identical in the TCL internal representation
+ *	and are used directly. Otherwise, the string is converted, as
+ *	TCL 8.6 represents characters outside of the BMP differently.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+static Tcl_Obj *
+Utf8ToObj(Tcl_Interp *interp, const char *utf8String,
+	Tcl_Encoding *encodingPtr)
+{
+    const char *pos;
+    Tcl_DString recode;
+    Tcl_Obj *resultObj;
+
+    for (pos = utf8String; *pos != '\0' && (unsigned char) *pos < 0x80;
+	    pos++) {
+    }
+    if (*pos == '\0') {
+	return Tcl_NewStringObj(utf8String, pos - utf8String);
+    }
+    if (*encodingPtr == NULL) {
+	*encodingPtr = Tcl_GetEncoding(interp, "utf-8");
+    }
+    Tcl_ExternalToUtfDString(*encodingPtr, utf8String, -1, &recode);
+    resultObj = Tcl_NewStringObj(Tcl_DStringValue(&recode),
+	    Tcl_DStringLength(&recode));
+    Tcl_DStringFree(&recode);
+    return resultObj;
+}
+
 /*
  *-------------------------------------------------------------------------
  *
@@ -1238,6 +2146,7 @@ ArgumentToZXingCppVisual(int *tkFlagPtr, Tcl_Interp *interp,
  *		resultList	List object to append the data to
  *		td		Time argument
  *		barcodes	zxingcpp barcodes object
+ *		resultKeys	bit field of the keys to put into the dicts
  *
  *	Result is a standard TCL result.
  *	Errors may arise, if the passed object is not a list or shared.
@@ -1247,11 +2156,10 @@ ArgumentToZXingCppVisual(int *tkFlagPtr, Tcl_Interp *interp,
 
 static int
 BarcodesToResultList(Tcl_Interp *interp, Tcl_Obj *resultList, 
-	Tcl_WideInt td, ZXing_Barcodes* barcodes
+	Tcl_WideInt td, ZXing_Barcodes* barcodes, int resultKeys
 	)
 {
-    Tcl_Encoding utf8Encoding;
-    Tcl_DString recode;
+    Tcl_Encoding utf8Encoding = NULL;
     Tcl_Obj *timeObj;
 
     /*
@@ -1269,10 +2177,6 @@ BarcodesToResultList(Tcl_Interp *interp, Tcl_Obj *resultList,
      * Loop over read bar codes
      */
     
-    utf8Encoding = Tcl_GetEncoding(interp, "utf-8"); 
-    Tcl_DStringInit(&recode);
-
-    
     for (int i = 0, n = ZXing_Barcodes_size(barcodes); i < n; ++i) {
 
 	Tcl_Obj * resultDict = Tcl_NewDictObj();
@@ -1280,68 +2184,81 @@ BarcodesToResultList(Tcl_Interp *interp, Tcl_Obj *resultList,
 	uint8_t* bytePtr;
 	int len;
 	char *zxingcppString;
-	ZXing_Position zxing_position;
-	Tcl_Obj * positionArray[8];
 
 	/*
-	 * Build a dict with the result keys
+	 * Build a dict with the requested result keys
 	 */
 	
 	/* Key text: interpretation line, utf-8 encoded */
-	zxingcppString = ZXing_Barcode_text(barcode);
-	Tcl_DStringAppend(&recode, zxingcppString, -1);
-	ZXing_free(zxingcppString);
-	Tcl_ExternalToUtfDString(utf8Encoding, ZXing_Barcode_text(barcode), -1, &recode); 
-	Tcl_DictObjPut(interp, resultDict, Tcl_NewStringObj("text",-1),
-		Tcl_NewStringObj(Tcl_DStringValue (&recode),
-		    Tcl_DStringLength (&recode)));
-	Tcl_DStringFree(&recode);
+	if (resultKeys & RESULT_KEY(iKeyText)) {
+	    zxingcppString = ZXing_Barcode_text(barcode);
+	    Tcl_DictObjPut(interp, resultDict, ResultKeyObj(iKeyText),
+		    Utf8ToObj(interp, zxingcppString, &utf8Encoding));
+	    ZXing_free(zxingcppString);
+	}
 
 	/* Key format: symbology, ASCII encoded and zero terminated */
-	zxingcppString = ZXing_BarcodeFormatToString(
-		ZXing_Barcode_format( barcode) );
-	Tcl_DictObjPut(interp, resultDict, Tcl_NewStringObj("format", -1),
-		Tcl_NewStringObj( zxingcppString, -1) );
-	ZXing_free(zxingcppString);
+	if (resultKeys & RESULT_KEY(iKeyFormat)) {
+	    zxingcppString = ZXing_BarcodeFormatToString(
+		    ZXing_Barcode_format( barcode) );
+	    Tcl_DictObjPut(interp, resultDict, ResultKeyObj(iKeyFormat),
+		    Tcl_NewStringObj( zxingcppString, -1) );
+	    ZXing_free(zxingcppString);
+	}
 
 	/* Key bytes: */
-	bytePtr=ZXing_Barcode_bytes(barcode, &len);
-	Tcl_DictObjPut(interp, resultDict, Tcl_NewStringObj("bytes",-1),
-		Tcl_NewByteArrayObj(bytePtr,len));
+	if (resultKeys & RESULT_KEY(iKeyBytes)) {
+	    bytePtr=ZXing_Barcode_bytes(barcode, &len);
+	    Tcl_DictObjPut(interp, resultDict, ResultKeyObj(iKeyBytes),
+		    Tcl_NewByteArrayObj(bytePtr,len));
+	    ZXing_free(bytePtr);
+	}
 
 	/* Key bytesECI: */
-	bytePtr=ZXing_Barcode_bytesECI(barcode, &len);
-	Tcl_DictObjPut(interp, resultDict, Tcl_NewStringObj("bytesECI",-1),
-		Tcl_NewByteArrayObj(bytePtr,len));
+	if (resultKeys & RESULT_KEY(iKeyBytesECI)) {
+	    bytePtr=ZXing_Barcode_bytesECI(barcode, &len);
+	    Tcl_DictObjPut(interp, resultDict, ResultKeyObj(iKeyBytesECI),
+		    Tcl_NewByteArrayObj(bytePtr,len));
+	    ZXing_free(bytePtr);
+	}
 
 	/*
 	 * Key content: one of: Text, Binary, Mixed, GS1, ISO15434, UnknownECI
 	 */
-	zxingcppString = ZXing_ContentTypeToString(
-		ZXing_Barcode_contentType(barcode));
-	Tcl_DictObjPut(interp, resultDict, Tcl_NewStringObj("content",-1),
-		Tcl_NewStringObj(zxingcppString ,-1));
-	ZXing_free(zxingcppString);
+	if (resultKeys & RESULT_KEY(iKeyContent)) {
+	    zxingcppString = ZXing_ContentTypeToString(
+		    ZXing_Barcode_contentType(barcode));
+	    Tcl_DictObjPut(interp, resultDict, ResultKeyObj(iKeyContent),
+		    Tcl_NewStringObj(zxingcppString ,-1));
+	    ZXing_free(zxingcppString);
+	}
 
 	/* Key symbologyIdentifier: Example: ]C0 for Code128 */
-	Tcl_DictObjPut(interp, resultDict,
-		Tcl_NewStringObj("symbologyIdentifier", -1),
-		Tcl_NewStringObj( ZXing_Barcode_symbologyIdentifier(barcode),
-		    -1));
+	if (resultKeys & RESULT_KEY(iKeySymbologyIdentifier)) {
+	    zxingcppString = ZXing_Barcode_symbologyIdentifier(barcode);
+	    Tcl_DictObjPut(interp, resultDict,
+		    ResultKeyObj(iKeySymbologyIdentifier),
+		    Tcl_NewStringObj(zxingcppString, -1));
+	    ZXing_free(zxingcppString);
+	}
 
 	/* Key hasECI: true if ECI present */
-	Tcl_DictObjPut(interp, resultDict,
-		Tcl_NewStringObj("hasECI", -1),
-		Tcl_NewBooleanObj( ZXing_Barcode_hasECI(barcode) ) );
+	if (resultKeys & RESULT_KEY(iKeyHasECI)) {
+	    Tcl_DictObjPut(interp, resultDict, ResultKeyObj(iKeyHasECI),
+		    Tcl_NewBooleanObj( ZXing_Barcode_hasECI(barcode) ) );
+	}
 
 	/*
 	 * Key ecLevel: string representing the EC level. Empty string if not
 	 * used by the symbology.
 	 */
 
-	Tcl_DictObjPut(interp, resultDict,
-		Tcl_NewStringObj("ecLevel", -1),
-		Tcl_NewStringObj( ZXing_Barcode_ecLevel(barcode), -1));
+	if (resultKeys & RESULT_KEY(iKeyEcLevel)) {
+	    zxingcppString = ZXing_Barcode_ecLevel(barcode);
+	    Tcl_DictObjPut(interp, resultDict, ResultKeyObj(iKeyEcLevel),
+		    Tcl_NewStringObj(zxingcppString, -1));
+	    ZXing_free(zxingcppString);
+	}
 
 	/*
 	 * Key position: list of numbers: topLeft.x, topLeft.y, topRight.x,
@@ -1349,34 +2266,67 @@ BarcodesToResultList(Tcl_Interp *interp, Tcl_Obj *resultList,
 	 * bottomLeft.y.
 	 */
 	
-	zxing_position = ZXing_Barcode_position(barcode);
-	positionArray[0] = Tcl_NewIntObj( zxing_position.topLeft.x );
-	positionArray[1] = Tcl_NewIntObj( zxing_position.topLeft.y );
-	positionArray[2] = Tcl_NewIntObj( zxing_position.topRight.x );
-	positionArray[3] = Tcl_NewIntObj( zxing_position.topRight.y );
-	positionArray[4] = Tcl_NewIntObj( zxing_position.bottomRight.x );
-	positionArray[5] = Tcl_NewIntObj( zxing_position.bottomRight.y );
-	positionArray[6] = Tcl_NewIntObj( zxing_position.bottomLeft.x );
-	positionArray[7] = Tcl_NewIntObj( zxing_position.bottomLeft.y );
-
-	Tcl_DictObjPut(interp, resultDict,
-		Tcl_NewStringObj("position", -1),
-		Tcl_NewListObj(8, positionArray) );
+	if (resultKeys & RESULT_KEY(iKeyPosition)) {
+	    ZXing_Position zxing_position;
+	    Tcl_Obj * positionArray[8];
+
+	    zxing_position = ZXing_Barcode_position(barcode);
+	    positionArray[0] = Tcl_NewIntObj( zxing_position.topLeft.x );
+	    positionArray[1] = Tcl_NewIntObj( zxing_position.topLeft.y );
+	    positionArray[2] = Tcl_NewIntObj( zxing_position.topRight.x );
+	    positionArray[3] = Tcl_NewIntObj( zxing_position.topRight.y );
+	    positionArray[4] = Tcl_NewIntObj( zxing_position.bottomRight.x );
+	    positionArray[5] = Tcl_NewIntObj( zxing_position.bottomRight.y );
+	    positionArray[6] = Tcl_NewIntObj( zxing_position.bottomLeft.x );
+	    positionArray[7] = Tcl_NewIntObj( zxing_position.bottomLeft.y );
+
+	    Tcl_DictObjPut(interp, resultDict, ResultKeyObj(iKeyPosition),
+		    Tcl_NewListObj(8, positionArray) );
+	}
 
 	/* Key orientation: symbol orientation in degrees, clockwise */
-	Tcl_DictObjPut(interp, resultDict,
-		Tcl_NewStringObj("orientation", -1),
-		Tcl_NewIntObj( ZXing_Barcode_orientation(barcode) ) );
+	if (resultKeys & RESULT_KEY(iKeyOrientation)) {
+	    Tcl_DictObjPut(interp, resultDict, ResultKeyObj(iKeyOrientation),
+		    Tcl_NewIntObj( ZXing_Barcode_orientation(barcode) ) );
+	}
 
 	/* Key isMirrored: 1 if code was up-side down */
-	Tcl_DictObjPut(interp, resultDict,
-		Tcl_NewStringObj("isMirrored", -1),
-		Tcl_NewBooleanObj( ZXing_Barcode_isMirrored(barcode) ) );
+	if (resultKeys & RESULT_KEY(iKeyIsMirrored)) {
+	    Tcl_DictObjPut(interp, resultDict, ResultKeyObj(iKeyIsMirrored),
+		    Tcl_NewBooleanObj( ZXing_Barcode_isMirrored(barcode) ) );
+	}
 
 	/* Key isInverted: 1 if code was inverted */
-	Tcl_DictObjPut(interp, resultDict,
-		Tcl_NewStringObj("isInverted", -1),
-		Tcl_NewBooleanObj( ZXing_Barcode_isInverted(barcode) ) );
+	if (resultKeys & RESULT_KEY(iKeyIsInverted)) {
+	    Tcl_DictObjPut(interp, resultDict, ResultKeyObj(iKeyIsInverted),
+		    Tcl_NewBooleanObj( ZXing_Barcode_isInverted(barcode) ) );
+	}
+
+	/*
+	 * Key gs1: list of alternating application identifiers and values,
+	 * empty list if the content is not a valid GS1 element string.
+	 */
+	if (resultKeys & RESULT_KEY(iKeyGS1)) {
+	    Tcl_Obj *gs1List = Tcl_NewListObj(0, NULL);
+	    if (ZXing_Barcode_contentType(barcode) == ZXing_ContentType_GS1) {
+		ZXing_GS1Element elements[GS1_ELEMENTS_MAX];
+		int count;
+		bytePtr = ZXing_Barcode_bytes(barcode, &len);
+		count = ZXing_ParseGS1((const char *) bytePtr, len, elements,
+			GS1_ELEMENTS_MAX);
+		for (int j = 0; j < count && j < GS1_ELEMENTS_MAX; j++) {
+		    /* AIs and values are restricted to ASCII by GS1 */
+		    Tcl_ListObjAppendElement(interp, gs1List, Tcl_NewStringObj(
+			    (const char *) bytePtr + elements[j].aiPos,
+			    elements[j].aiLen));
+		    Tcl_ListObjAppendElement(interp, gs1List, Tcl_NewStringObj(
+			    (const char *) bytePtr + elements[j].valuePos,
+			    elements[j].valueLen));
+		}
+		ZXing_free(bytePtr);
+	    }
+	    Tcl_DictObjPut(interp, resultDict, ResultKeyObj(iKeyGS1), gs1List);
+	}
 
 	if (!ZXing_Barcode_isValid(barcode)) {
 	    char * typeText;
@@ -1396,12 +2346,18 @@ BarcodesToResultList(Tcl_Interp *interp, Tcl_Obj *resultList,
 		typeText = "Unsupported";
 		break;
 	    }
-	    Tcl_DictObjPut(interp, resultDict, Tcl_NewStringObj("errorType",-1),
-		    Tcl_NewStringObj(typeText,-1));
+	    if (resultKeys & RESULT_KEY(iKeyErrorType)) {
+		Tcl_DictObjPut(interp, resultDict, ResultKeyObj(iKeyErrorType),
+			Tcl_NewStringObj(typeText,-1));
+	    }
 
 	    /* Key errorMsg: */
-	    Tcl_DictObjPut(interp, resultDict, Tcl_NewStringObj("errorMsg",-1),
-		    Tcl_NewStringObj(ZXing_Barcode_errorMsg(barcode),-1));
+	    if (resultKeys & RESULT_KEY(iKeyErrorMsg)) {
+		zxingcppString = ZXing_Barcode_errorMsg(barcode);
+		Tcl_DictObjPut(interp, resultDict, ResultKeyObj(iKeyErrorMsg),
+			Tcl_NewStringObj(zxingcppString,-1));
+		ZXing_free(zxingcppString);
+	    }
 	}
 	
 	/*
@@ -1411,12 +2367,13 @@ BarcodesToResultList(Tcl_Interp *interp, Tcl_Obj *resultList,
 	Tcl_ListObjAppendElement(interp, resultList, resultDict);
     }
 
-    Tcl_FreeEncoding(utf8Encoding);
-    Tcl_DStringFree(&recode);
+    if (utf8Encoding != NULL) {
+	Tcl_FreeEncoding(utf8Encoding);
+    }
    
     return TCL_OK;
 }
-
+
 /*
  *-------------------------------------------------------------------------
  *
@@ -1450,6 +2407,7 @@ ZxingcppDecodeObjCmd(ClientData tkFlagPtr, Tcl_Interp *interp,
     Tcl_Time now;
     Tcl_WideInt tw[2], td;
     Tcl_Obj *resultList;
+    int resultKeys;
 
     if ( objc < 2 ) {
 	Tcl_WrongNumArgs(interp, 1, objv, "photoEtc ?opt1 val1? ...");
@@ -1472,7 +2430,8 @@ ZxingcppDecodeObjCmd(ClientData tkFlagPtr, Tcl_Interp *interp,
      */
 
     opts = ZXing_ReaderOptions_new();
-    if (TCL_ERROR == ReaderOptionsGet(interp, objc-2,  &objv[2], opts) ) {
+    if (TCL_ERROR == ReaderOptionsGet(interp, objc-2,  &objv[2], opts,
+	    &resultKeys) ) {
 	ZXing_ReaderOptions_delete(opts);
 	ZXing_ImageView_delete(iv);
 	return TCL_ERROR;
@@ -1513,7 +2472,8 @@ ZxingcppDecodeObjCmd(ClientData tkFlagPtr, Tcl_Interp *interp,
     }
 
     resultList = Tcl_NewListObj(0,NULL);
-    if (TCL_OK != BarcodesToResultList(interp, resultList, td, barcodes)) {
+    if (TCL_OK != BarcodesToResultList(interp, resultList, td, barcodes,
+	    resultKeys)) {
 
 	/*
 	 * This may currently not fail, as the provided object is always a list
@@ -1533,6 +2493,145 @@ ZxingcppDecodeObjCmd(ClientData tkFlagPtr, Tcl_Interp *interp,
     Tcl_SetObjResult(interp, resultList);
     return TCL_OK;
 }
+
+#ifdef ZXING_EXPERIMENTAL_API
+
+/*
+ *-------------------------------------------------------------------------
+ *
+ * EncodeError --
+ *
+ *	Set the interpreter result to an error message of EncodeImages.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+static int
+EncodeError(Tcl_Interp *interp, char *error)
+{
+    if (error != NULL) {
+	Tcl_SetObjResult( interp, Tcl_NewStringObj(error,-1) );
+	ZXing_free(error);
+    } else {
+	Tcl_SetResult(interp, "No error details reported by ZXing-Cpp",
+		TCL_STATIC);
+    }
+    return TCL_ERROR;
+}
+
+/*
+ *-------------------------------------------------------------------------
+ *
+ * ZxingcppEncodeObjCmd --
+ *
+ *	zxingcpp::encode Tcl command, create a barcode image.
+ *	Command format
+ *
+ *		zxingcpp::encode format payload ?opt1 val1? ...
+ *
+ *		format		symbology as returned by zxingcpp::formats
+ *		payload		text or byte array (option Binary) to encode
+ *		options		option /value pairs to the encoder
+ *
+ *	Result is a greyscale image list {width height 1 bytes} or an
+ *	empty string, if the image was written to a photo (option Photo).
+ *
+ *-------------------------------------------------------------------------
+ */
+
+static int
+ZxingcppEncodeObjCmd(ClientData tkFlagPtr, Tcl_Interp *interp,
+	int objc,  Tcl_Obj *const objv[])
+{
+    EncodeJob *jobPtr;
+    ZXing_Image **images;
+    char *error = NULL;
+    int ret = TCL_OK;
+
+    if ( objc < 3 ) {
+	Tcl_WrongNumArgs(interp, 1, objv, "format payload ?opt1 val1? ...");
+	return TCL_ERROR;
+    }
+    if (TCL_OK != EncodeJobGet(interp, objv[1], objv[2], 0, objc-3,
+	    &objv[3], &jobPtr) ) {
+	return TCL_ERROR;
+    }
+
+    images = EncodeImages(jobPtr, &error);
+    if (images == NULL) {
+	EncodeJobFree(jobPtr);
+	return EncodeError(interp, error);
+    }
+
+    if (jobPtr->photoObj != NULL) {
+	ret = ImageToPhoto((int *)tkFlagPtr, interp, jobPtr->photoObj,
+		images[0]);
+    } else {
+	Tcl_SetObjResult(interp, ImageToObj(images[0]));
+    }
+
+    ImagesFree(images, jobPtr->count);
+    EncodeJobFree(jobPtr);
+    return ret;
+}
+
+/*
+ *-------------------------------------------------------------------------
+ *
+ * ZxingcppEncodeBatchObjCmd --
+ *
+ *	zxingcpp::encode_batch Tcl command, create barcode images for a
+ *	list of payloads with the same options. The barcodes are created
+ *	in parallel (option Threads).
+ *	Command format
+ *
+ *		zxingcpp::encode_batch format payloads ?opt1 val1? ...
+ *
+ *		format		symbology as returned by zxingcpp::formats
+ *		payloads	list of texts or byte arrays to encode
+ *		options		option /value pairs to the encoder
+ *
+ *	Result is a list of greyscale image lists {width height 1 bytes},
+ *	one per payload.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+static int
+ZxingcppEncodeBatchObjCmd(ClientData unused, Tcl_Interp *interp,
+	int objc,  Tcl_Obj *const objv[])
+{
+    EncodeJob *jobPtr;
+    ZXing_Image **images;
+    char *error = NULL;
+    Tcl_Obj *resultList;
+
+    if ( objc < 3 ) {
+	Tcl_WrongNumArgs(interp, 1, objv, "format payloads ?opt1 val1? ...");
+	return TCL_ERROR;
+    }
+    if (TCL_OK != EncodeJobGet(interp, objv[1], objv[2], 1, objc-3,
+	    &objv[3], &jobPtr) ) {
+	return TCL_ERROR;
+    }
+
+    images = EncodeImages(jobPtr, &error);
+    if (images == NULL) {
+	EncodeJobFree(jobPtr);
+	return EncodeError(interp, error);
+    }
+
+    resultList = Tcl_NewListObj(0,NULL);
+    for (int i = 0; i < jobPtr->count; i++) {
+	Tcl_ListObjAppendElement(NULL, resultList, ImageToObj(images[i]));
+    }
+
+    ImagesFree(images, jobPtr->count);
+    EncodeJobFree(jobPtr);
+    Tcl_SetObjResult(interp, resultList);
+    return TCL_OK;
+}
+#endif /* ZXING_EXPERIMENTAL_API */
 
 #ifndef TCL_THREADS
 /*
@@ -1667,9 +2766,16 @@ Zxingcpp_Init(Tcl_Interp *interp)
     memset(aPtr, 0, sizeof(AsyncDecode));
     aPtr->tkFlagPtr = tkFlagPtr;
     Tcl_InitHashTable(&aPtr->evts, TCL_ONE_WORD_KEYS);
+    aPtr->nCmds = 1;
     Tcl_CreateObjCommand(interp, "zxingcpp::async_decode",
 			 ZXingCppAsyncDecodeObjCmd, (ClientData) aPtr,
 			 ZXingCppAsyncCmdDeleted);
+#ifdef ZXING_EXPERIMENTAL_API
+    aPtr->nCmds++;
+    Tcl_CreateObjCommand(interp, "zxingcpp::async_encode",
+			 ZXingCppAsyncEncodeObjCmd, (ClientData) aPtr,
+			 ZXingCppAsyncCmdDeleted);
+#endif
     Tcl_GetVersion(&major, &minor, NULL, NULL);
     if ((major > 8) || ((major == 8) && (minor > 6))) {
 	aPtr->tip609 = 1;
@@ -1682,9 +2788,20 @@ Zxingcpp_Init(Tcl_Interp *interp)
 #else
     Tcl_CreateObjCommand(interp, "zxingcpp::async_decode",
 			 ZXingCppAsyncDecodeObjCmd_NoThreads, NULL, NULL);
+#ifdef ZXING_EXPERIMENTAL_API
+    Tcl_CreateObjCommand(interp, "zxingcpp::async_encode",
+			 ZXingCppAsyncDecodeObjCmd_NoThreads, NULL, NULL);
+#endif
 #endif
     Tcl_CreateObjCommand(interp, "::zxingcpp::decode", ZxingcppDecodeObjCmd,
 			 (ClientData) tkFlagPtr, (Tcl_CmdDeleteProc *) NULL);
+#ifdef ZXING_EXPERIMENTAL_API
+    Tcl_CreateObjCommand(interp, "::zxingcpp::encode", ZxingcppEncodeObjCmd,
+			 (ClientData) tkFlagPtr, (Tcl_CmdDeleteProc *) NULL);
+    Tcl_CreateObjCommand(interp, "::zxingcpp::encode_batch",
+			 ZxingcppEncodeBatchObjCmd, (ClientData) NULL,
+			 (Tcl_CmdDeleteProc *) NULL);
+#endif
     Tcl_CreateObjCommand(interp, "zxingcpp::formats", ZxingcppFormatsObjCmd,
 			 (ClientData) NULL, (Tcl_CmdDeleteProc *) NULL);
     Tcl_PkgProvide(interp, PACKAGE_NAME, PACKAGE_VERSION);
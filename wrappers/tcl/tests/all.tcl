@@ -0,0 +1,16 @@
+# all.tcl --
+#
+# This file contains a top-level script to run all of the tests of the
+# zxingcpp extension. Execute it by invoking "make test" in the build
+# directory.
+#
+# Copyright 2026 ZXing authors
+# SPDX-License-Identifier: Apache-2.0
+
+package prefer latest
+package require Tcl 8.6-
+package require tcltest 2.2
+namespace import tcltest::*
+configure {*}$argv -testdir [file dirname [file normalize [info script]]]
+runAllTests
+return